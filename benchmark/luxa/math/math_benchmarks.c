@@ -0,0 +1,135 @@
+#include <benchmark/luxa/math/math_benchmarks.h>
+#include <benchmark/luxa/math/math_scalar_benchmarks.h>
+#include <luxa/benchmark.h>
+#include <luxa/memory/allocator.h>
+#include <luxa/math/math.h>
+
+// Small enough for the inputs and outputs to stay in cache, so the kernels are measured rather than memory
+#define MATH_BENCHMARK_COUNT (4 * 1024)
+#define MATH_BENCHMARK_RUNS 200
+
+typedef struct math_benchmark {
+	lx_mat4_t parent;
+	lx_mat4_t *matrices;
+	lx_mat4_t *results;
+	lx_vec3_t *points;
+	lx_vec3_t *transformed_points;
+	lx_vec4_t *vectors;
+	lx_vec4_t *transformed_vectors;
+} math_benchmark_t;
+
+static float random_float(uint32_t *seed)
+{
+	*seed = *seed * 1664525u + 1013904223u;
+	return (float)(*seed >> 8) / 16777216.0f;
+}
+
+static void mat4_mul_scalar(math_benchmark_t *benchmark)
+{
+	math_scalar_mat4_mul(benchmark->matrices, MATH_BENCHMARK_COUNT, &benchmark->parent, benchmark->results);
+}
+
+static void mat4_mul_simd(math_benchmark_t *benchmark)
+{
+	lx_mat4_mul_batch(benchmark->matrices, MATH_BENCHMARK_COUNT, &benchmark->parent, benchmark->results);
+}
+
+static void mat4_transpose_scalar(math_benchmark_t *benchmark)
+{
+	math_scalar_mat4_transpose(benchmark->matrices, MATH_BENCHMARK_COUNT, benchmark->results);
+}
+
+static void mat4_transpose_simd(math_benchmark_t *benchmark)
+{
+	for (size_t i = 0; i < MATH_BENCHMARK_COUNT; ++i)
+		lx_mat4_transpose(&benchmark->matrices[i], &benchmark->results[i]);
+}
+
+static void mat4_inv_scalar(math_benchmark_t *benchmark)
+{
+	math_scalar_mat4_inv(benchmark->matrices, MATH_BENCHMARK_COUNT, benchmark->results);
+}
+
+static void mat4_inv_simd(math_benchmark_t *benchmark)
+{
+	for (size_t i = 0; i < MATH_BENCHMARK_COUNT; ++i)
+		lx_mat4_inv(&benchmark->matrices[i], &benchmark->results[i]);
+}
+
+static void vec3_transform_scalar(math_benchmark_t *benchmark)
+{
+	math_scalar_vec3_transform(benchmark->points, MATH_BENCHMARK_COUNT, &benchmark->parent, benchmark->transformed_points);
+}
+
+static void vec3_transform_simd(math_benchmark_t *benchmark)
+{
+	lx_vec3_transform_4x4_batch(benchmark->points, MATH_BENCHMARK_COUNT, &benchmark->parent, benchmark->transformed_points);
+}
+
+static void vec4_transform_scalar(math_benchmark_t *benchmark)
+{
+	math_scalar_vec4_transform(benchmark->vectors, MATH_BENCHMARK_COUNT, &benchmark->parent, benchmark->transformed_vectors);
+}
+
+static void vec4_transform_simd(math_benchmark_t *benchmark)
+{
+	lx_vec4_transform_batch(benchmark->vectors, MATH_BENCHMARK_COUNT, &benchmark->parent, benchmark->transformed_vectors);
+}
+
+static void run_kernel(const char *name, lx_benchmark_function_t scalar, lx_benchmark_function_t simd, math_benchmark_t *benchmark)
+{
+	char label[64];
+	snprintf(label, sizeof(label), "%s_scalar", name);
+	const double scalar_time = lx_benchmark_run(label, MATH_BENCHMARK_RUNS, scalar, benchmark);
+	snprintf(label, sizeof(label), "%s_simd", name);
+	const double simd_time = lx_benchmark_run(label, MATH_BENCHMARK_RUNS, simd, benchmark);
+
+	printf("%-48s %10.2f ns %10.2f ns %10.2fx\n", "per item, scalar, simd, speedup",
+		scalar_time * 1000000.0 / MATH_BENCHMARK_COUNT, simd_time * 1000000.0 / MATH_BENCHMARK_COUNT, scalar_time / simd_time);
+}
+
+void run_math_benchmarks()
+{
+	lx_allocator_t *allocator = lx_allocator_default();
+	math_benchmark_t benchmark = { 0 };
+
+	lx_mat4_t rotation, translation;
+	lx_mat4_set_rotation_z(0.5f, &rotation);
+	lx_mat4_translation(1.0f, 2.0f, 3.0f, &translation);
+	lx_mat4_mul(&rotation, &translation, &benchmark.parent);
+
+	benchmark.matrices = lx_alloc(allocator, sizeof(lx_mat4_t) * MATH_BENCHMARK_COUNT);
+	benchmark.results = lx_alloc(allocator, sizeof(lx_mat4_t) * MATH_BENCHMARK_COUNT);
+	benchmark.points = lx_alloc(allocator, sizeof(lx_vec3_t) * MATH_BENCHMARK_COUNT);
+	benchmark.transformed_points = lx_alloc(allocator, sizeof(lx_vec3_t) * MATH_BENCHMARK_COUNT);
+	benchmark.vectors = lx_alloc(allocator, sizeof(lx_vec4_t) * MATH_BENCHMARK_COUNT);
+	benchmark.transformed_vectors = lx_alloc(allocator, sizeof(lx_vec4_t) * MATH_BENCHMARK_COUNT);
+
+	// Random matrices with a heavy diagonal so they are invertible
+	uint32_t seed = 1;
+	for (size_t i = 0; i < MATH_BENCHMARK_COUNT; ++i) {
+		for (size_t j = 0; j < 16; ++j)
+			benchmark.matrices[i].m[j] = random_float(&seed) * 2.0f - 1.0f + (j % 5 == 0 ? 4.0f : 0.0f);
+
+		benchmark.points[i] = (lx_vec3_t) { random_float(&seed), random_float(&seed), random_float(&seed) };
+		benchmark.vectors[i] = (lx_vec4_t) { random_float(&seed), random_float(&seed), random_float(&seed), 1.0f };
+	}
+
+	LX_BENCHMARK_FIXTURE_BEGIN("Math");
+
+	printf("%u items per run\n", (unsigned)MATH_BENCHMARK_COUNT);
+	run_kernel("mat4_mul", mat4_mul_scalar, mat4_mul_simd, &benchmark);
+	run_kernel("mat4_transpose", mat4_transpose_scalar, mat4_transpose_simd, &benchmark);
+	run_kernel("mat4_inv", mat4_inv_scalar, mat4_inv_simd, &benchmark);
+	run_kernel("vec3_transform_4x4", vec3_transform_scalar, vec3_transform_simd, &benchmark);
+	run_kernel("vec4_transform", vec4_transform_scalar, vec4_transform_simd, &benchmark);
+
+	LX_BENCHMARK_FIXTURE_END();
+
+	lx_free(allocator, benchmark.transformed_vectors);
+	lx_free(allocator, benchmark.vectors);
+	lx_free(allocator, benchmark.transformed_points);
+	lx_free(allocator, benchmark.points);
+	lx_free(allocator, benchmark.results);
+	lx_free(allocator, benchmark.matrices);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void run_math_benchmarks();
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,29 @@
+#define LX_MATH_SCALAR
+#include <benchmark/luxa/math/math_scalar_benchmarks.h>
+
+void math_scalar_mat4_mul(const lx_mat4_t *a, size_t count, const lx_mat4_t *b, lx_mat4_t *out)
+{
+	lx_mat4_mul_batch(a, count, b, out);
+}
+
+void math_scalar_mat4_transpose(const lx_mat4_t *m, size_t count, lx_mat4_t *out)
+{
+	for (size_t i = 0; i < count; ++i)
+		lx_mat4_transpose(&m[i], &out[i]);
+}
+
+void math_scalar_mat4_inv(const lx_mat4_t *m, size_t count, lx_mat4_t *out)
+{
+	for (size_t i = 0; i < count; ++i)
+		lx_mat4_inv(&m[i], &out[i]);
+}
+
+void math_scalar_vec3_transform(const lx_vec3_t *v, size_t count, const lx_mat4_t *m, lx_vec3_t *out)
+{
+	lx_vec3_transform_4x4_batch(v, count, m, out);
+}
+
+void math_scalar_vec4_transform(const lx_vec4_t *v, size_t count, const lx_mat4_t *m, lx_vec4_t *out)
+{
+	lx_vec4_transform_batch(v, count, m, out);
+}
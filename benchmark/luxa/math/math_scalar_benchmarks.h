@@ -0,0 +1,24 @@
+#pragma once
+
+#include <luxa/math/math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The math kernels compiled with LX_MATH_SCALAR, the baseline the SIMD kernels are measured against.
+ */
+void math_scalar_mat4_mul(const lx_mat4_t *a, size_t count, const lx_mat4_t *b, lx_mat4_t *out);
+
+void math_scalar_mat4_transpose(const lx_mat4_t *m, size_t count, lx_mat4_t *out);
+
+void math_scalar_mat4_inv(const lx_mat4_t *m, size_t count, lx_mat4_t *out);
+
+void math_scalar_vec3_transform(const lx_vec3_t *v, size_t count, const lx_mat4_t *m, lx_vec3_t *out);
+
+void math_scalar_vec4_transform(const lx_vec4_t *v, size_t count, const lx_mat4_t *m, lx_vec4_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+#include <benchmark/luxa/renderer/culling_benchmarks.h>
+#include <luxa/benchmark.h>
+#include <luxa/memory/allocator.h>
+#include <luxa/renderer/culling.h>
+
+#define CULLING_BENCHMARK_NUM_BOXES (1024 * 1024)
+#define CULLING_BENCHMARK_RUNS 20
+
+typedef struct culling_benchmark {
+	lx_frustum_t frustum;
+	lx_aabb_t *boxes;
+	lx_cull_bounds_t bounds;
+	uint32_t *visible;
+	size_t num_visible;
+} culling_benchmark_t;
+
+static float random_float(uint32_t *seed)
+{
+	*seed = *seed * 1664525u + 1013904223u;
+	return (float)(*seed >> 8) / 16777216.0f;
+}
+
+static void cull_per_box(culling_benchmark_t *benchmark)
+{
+	size_t num_visible = 0;
+	for (size_t i = 0; i < CULLING_BENCHMARK_NUM_BOXES; ++i) {
+		if (lx_frustum_intersects_aabb(&benchmark->frustum, &benchmark->boxes[i]))
+			benchmark->visible[num_visible++] = (uint32_t)i;
+	}
+
+	benchmark->num_visible = num_visible;
+}
+
+static void cull_batched(culling_benchmark_t *benchmark)
+{
+	benchmark->num_visible = lx_frustum_cull(&benchmark->frustum, &benchmark->bounds, 0, CULLING_BENCHMARK_NUM_BOXES, benchmark->visible);
+}
+
+void run_culling_benchmarks()
+{
+	lx_allocator_t *allocator = lx_allocator_default();
+	culling_benchmark_t benchmark = { 0 };
+
+	// Camera at the origin looking down +z, boxes all around it so most are off-screen
+	lx_mat4_t view, projection, view_projection;
+	lx_vec3_t direction = { 0.0f, 0.0f, 1.0f }, position = { 0.0f, 0.0f, 0.0f }, up = { 0.0f, 1.0f, 0.0f };
+	lx_mat4_look_to(&direction, &position, &up, &view);
+	lx_mat4_perspective_fov(0.1f, 500.0f, lx_radians(60.0f), 16.0f / 9.0f, &projection);
+	lx_mat4_mul(&view, &projection, &view_projection);
+	lx_frustum_from_view_projection(&view_projection, &benchmark.frustum);
+
+	benchmark.boxes = lx_alloc(allocator, sizeof(lx_aabb_t) * CULLING_BENCHMARK_NUM_BOXES);
+	benchmark.visible = lx_alloc(allocator, sizeof(uint32_t) * CULLING_BENCHMARK_NUM_BOXES);
+	float *columns = lx_alloc(allocator, sizeof(float) * CULLING_BENCHMARK_NUM_BOXES * 6);
+
+	uint32_t seed = 1;
+	for (size_t i = 0; i < CULLING_BENCHMARK_NUM_BOXES; ++i) {
+		lx_vec3_t center = { random_float(&seed) * 1000.0f - 500.0f, random_float(&seed) * 1000.0f - 500.0f, random_float(&seed) * 1000.0f - 500.0f };
+		benchmark.boxes[i].min = (lx_vec3_t) { center.x - 1.0f, center.y - 1.0f, center.z - 1.0f };
+		benchmark.boxes[i].max = (lx_vec3_t) { center.x + 1.0f, center.y + 1.0f, center.z + 1.0f };
+
+		lx_vec3_t extent;
+		lx_aabb_center_extent(&benchmark.boxes[i], &center, &extent);
+		for (size_t axis = 0; axis < 3; ++axis) {
+			columns[CULLING_BENCHMARK_NUM_BOXES * axis + i] = (&center.x)[axis];
+			columns[CULLING_BENCHMARK_NUM_BOXES * (axis + 3) + i] = (&extent.x)[axis];
+		}
+	}
+
+	benchmark.bounds = (lx_cull_bounds_t) {
+		.center_x = columns,
+		.center_y = columns + CULLING_BENCHMARK_NUM_BOXES,
+		.center_z = columns + CULLING_BENCHMARK_NUM_BOXES * 2,
+		.extent_x = columns + CULLING_BENCHMARK_NUM_BOXES * 3,
+		.extent_y = columns + CULLING_BENCHMARK_NUM_BOXES * 4,
+		.extent_z = columns + CULLING_BENCHMARK_NUM_BOXES * 5,
+		.count = CULLING_BENCHMARK_NUM_BOXES
+	};
+
+	LX_BENCHMARK_FIXTURE_BEGIN("Culling");
+
+	const double per_box = lx_benchmark_run("cull_per_box", CULLING_BENCHMARK_RUNS, cull_per_box, &benchmark);
+	const size_t num_visible = benchmark.num_visible;
+	const double batched = lx_benchmark_run("cull_batched", CULLING_BENCHMARK_RUNS, cull_batched, &benchmark);
+
+	printf("%u boxes, %zu visible (%zu batched)\n", (unsigned)CULLING_BENCHMARK_NUM_BOXES, num_visible, benchmark.num_visible);
+	printf("%-48s %10.2f ns\n", "per box, cull_per_box", per_box * 1000000.0 / CULLING_BENCHMARK_NUM_BOXES);
+	printf("%-48s %10.2f ns\n", "per box, cull_batched", batched * 1000000.0 / CULLING_BENCHMARK_NUM_BOXES);
+	printf("%-48s %10.2fx\n", "speedup", per_box / batched);
+
+	LX_BENCHMARK_FIXTURE_END();
+
+	lx_free(allocator, columns);
+	lx_free(allocator, benchmark.visible);
+	lx_free(allocator, benchmark.boxes);
+}
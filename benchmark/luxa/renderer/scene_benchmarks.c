@@ -0,0 +1,83 @@
+#include <benchmark/luxa/renderer/scene_benchmarks.h>
+#include <luxa/benchmark.h>
+#include <luxa/renderer/scene.h>
+#include <luxa/threading/cpu_topology.h>
+#include <luxa/threading/task/task.h>
+
+#define SCENE_BENCHMARK_BRANCHING 8
+#define SCENE_BENCHMARK_DEPTH 6
+#define SCENE_BENCHMARK_RUNS 20
+
+typedef struct transform_benchmark {
+	lx_scene_t *scene;
+	lx_task_factory_t *task_factory;
+} transform_benchmark_t;
+
+// Every node gets the same number of children, 8^6 leaves and close to 300k nodes in total
+static void create_tree(lx_scene_t *scene, lx_scene_node_t parent, size_t depth, const lx_mat4_t *transform)
+{
+	if (depth == SCENE_BENCHMARK_DEPTH)
+		return;
+
+	for (size_t i = 0; i < SCENE_BENCHMARK_BRANCHING; ++i) {
+		lx_scene_node_t node = lx_scene_create_node(scene, parent);
+		lx_scene_set_local_transform(scene, node, transform);
+		create_tree(scene, node, depth + 1, transform);
+	}
+}
+
+// Moving the root dirties every world transform in the scene
+static void update_all_transforms(transform_benchmark_t *benchmark)
+{
+	lx_mat4_t root_transform = *lx_scene_local_transform(benchmark->scene, lx_scene_root_node());
+	lx_scene_set_local_transform(benchmark->scene, lx_scene_root_node(), &root_transform);
+	lx_scene_update_transforms(benchmark->scene, benchmark->task_factory);
+}
+
+static void update_moved_leaf(transform_benchmark_t *benchmark)
+{
+	lx_scene_node_t leaf = lx_scene_size(benchmark->scene) - 1;
+	lx_mat4_t leaf_transform = *lx_scene_local_transform(benchmark->scene, leaf);
+	lx_scene_set_local_transform(benchmark->scene, leaf, &leaf_transform);
+	lx_scene_update_transforms(benchmark->scene, benchmark->task_factory);
+}
+
+void run_scene_benchmarks()
+{
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_scene_t *scene = lx_scene_create(allocator);
+
+	lx_mat4_t transform;
+	lx_mat4_set_rotation_y(0.1f, &transform);
+	transform.m41 = 1.0f;
+	create_tree(scene, lx_scene_root_node(), 0, &transform);
+
+	lx_cpu_topology_t *topology = lx_cpu_topology_create(allocator);
+	const size_t num_processors = topology->num_processors;
+	lx_cpu_topology_destroy(topology);
+
+	LX_BENCHMARK_FIXTURE_BEGIN("Scene");
+
+	printf("%zu nodes, %zu logical processors\n", lx_scene_size(scene), num_processors);
+
+	transform_benchmark_t benchmark = { .scene = scene, .task_factory = NULL };
+	const double serial = lx_benchmark_run("update_all_transforms serial", SCENE_BENCHMARK_RUNS, update_all_transforms, &benchmark);
+	lx_benchmark_run("update_moved_leaf serial", SCENE_BENCHMARK_RUNS, update_moved_leaf, &benchmark);
+
+	// The calling thread is a worker too, num_threads extra threads give num_threads + 1 workers
+	for (size_t num_threads = 0; num_threads < num_processors; ++num_threads) {
+		lx_task_factory_options_t options = { .num_threads = num_threads };
+		benchmark.task_factory = lx_task_factory_create(allocator, &options);
+
+		char name[64];
+		sprintf_s(name, sizeof(name), "update_all_transforms %zu workers", num_threads + 1);
+		const double parallel = lx_benchmark_run(name, SCENE_BENCHMARK_RUNS, update_all_transforms, &benchmark);
+		printf("%-48s %10.2fx\n", "speedup", serial / parallel);
+
+		lx_task_factory_destroy(benchmark.task_factory);
+	}
+
+	LX_BENCHMARK_FIXTURE_END();
+
+	lx_scene_destroy(scene);
+}
@@ -0,0 +1,13 @@
+#include <stdio.h>
+#include <luxa/benchmark.h>
+#include <benchmark/luxa/renderer/scene_benchmarks.h>
+#include <benchmark/luxa/renderer/culling_benchmarks.h>
+#include <benchmark/luxa/math/math_benchmarks.h>
+
+int main(int argc, char **argv)
+{
+	run_scene_benchmarks();
+	run_culling_benchmarks();
+	run_math_benchmarks();
+	return 0;
+}
@@ -79,3 +79,25 @@ project "unit-tests"
         defines { "NDEBUG" }
         optimize "On"
         symbols "On"
+
+project "benchmarks"
+    kind "ConsoleApp"
+    language "C"
+    targetdir "build/bin/%{cfg.buildcfg}"
+
+    includedirs { "src", "." }
+
+    files { "benchmark/**.h", "benchmark/**.c" }
+
+    links { "luxa" }
+
+    characterset "MBCS"
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "NDEBUG" }
+        optimize "On"
+        symbols "On"
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <time.h>
 #include <luxa/memory/allocator.h>
+#include <luxa/memory/tracking_allocator.h>
 #include <luxa/collections/array.h>
 #include <luxa/collections/string.h>
 #include <luxa/renderer/renderer.h>
@@ -51,8 +52,8 @@ LRESULT CALLBACK handle_window_message(HWND hWnd, UINT message, WPARAM wParam, L
 
 int WinMain(HINSTANCE instance_handle, HINSTANCE prev_instance_handle, LPSTR cmd_line, int cmd_show)
 {
-	lx_allocator_t *allocator = lx_allocator_default();
-	lx_initialize_log(allocator, LX_LOG_LEVEL_TRACE);
+	lx_allocator_t *allocator = lx_tracking_allocator_create(lx_allocator_default(), 64);
+	lx_initialize_log(lx_allocator_default(), LX_LOG_LEVEL_TRACE);
 	lx_register_log_target(LX_LOG_LEVEL_TRACE, debug_log, NULL);
 
 	const char *window_class_name = "LuxaApp";
@@ -103,9 +104,11 @@ int WinMain(HINSTANCE instance_handle, HINSTANCE prev_instance_handle, LPSTR cmd
 	lx_fs_read_file(shader_buffer, "C:\\git\\luxa_cc\\build\\bin\\Debug\\frag.spv");
 	lx_renderer_create_shader(renderer, shader_buffer, 2, LX_SHADER_STAGE_FRAGMENT);
 
+	lx_buffer_destroy(shader_buffer);
+
 	lx_renderer_create_render_pipeline(renderer, 1, 2);
 
-    lx_mesh_t *mesh = lx_mesh_create(allocator);
+    lx_mesh_t *mesh = lx_mesh_create(lx_tracking_allocator_tag(allocator, "Mesh"));
     
     const float size = 1.0f;
 
@@ -178,10 +181,11 @@ int WinMain(HINSTANCE instance_handle, HINSTANCE prev_instance_handle, LPSTR cmd
     lx_mesh_set_vertices(mesh, vertices, sizeof(vertices)/ sizeof(vertices[0]));
     lx_mesh_set_indices(mesh, indices, sizeof(indices) / sizeof(indices[0]));
 
-    lx_scene_t *scene = lx_scene_create(allocator);
+    lx_scene_t *scene = lx_scene_create(lx_tracking_allocator_tag(allocator, "Scene"));
     lx_scene_node_t node = lx_scene_create_node(scene, lx_scene_root_node());
     lx_renderable_t renderable = lx_scene_create_renderable(scene, LX_RENDERABLE_TYPE_MESH, mesh);
     lx_scene_attach_renderable(scene, node, renderable);
+    lx_scene_set_local_bounds(scene, node, lx_mesh_bounds(mesh));
 
     lx_renderer_initialize_scene(renderer, scene);
 
@@ -206,6 +210,7 @@ int WinMain(HINSTANCE instance_handle, HINSTANCE prev_instance_handle, LPSTR cmd
 
         lx_input_frame_begin(input, &msg);
 
+		lx_scene_update_transforms(scene, NULL);
 		lx_renderer_render_frame(renderer, scene, camera);
 		lx_renderer_device_wait_idle(renderer);
 
@@ -224,9 +229,17 @@ int WinMain(HINSTANCE instance_handle, HINSTANCE prev_instance_handle, LPSTR cmd
 
 	LX_LOG_INFO(NULL, "Shutting down...");
 		
+	lx_renderer_device_wait_idle(renderer);
+	lx_renderer_release_scene(renderer, scene);
+	lx_scene_destroy(scene);
+	lx_mesh_destroy(mesh);
+	lx_camera_destroy(camera);
+
 	lx_renderer_destroy(allocator, renderer);
     lx_input_destroy(input);
+	lx_tracking_allocator_report_leaks(allocator);
 	lx_shutdown_log();
+	lx_tracking_allocator_destroy(allocator);
 	
 	return (int)msg.wParam;
 }
@@ -0,0 +1,50 @@
+#ifndef LX_BENCHMARK_H
+#define LX_BENCHMARK_H
+
+#include <stdio.h>
+#include <luxa/chrono.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*lx_benchmark_function_t)(lx_any_t argument);
+
+#define LX_BENCHMARK_FIXTURE_BEGIN(name)\
+printf(name);\
+printf("\n--------------------------------------------------------------------------------\n");
+
+#define LX_BENCHMARK_FIXTURE_END()\
+printf("--------------------------------------------------------------------------------\n\n");
+
+/*
+ * Call f num_runs times after a warm up call and print the fastest and the average time. Returns
+ * the fastest time in milliseconds.
+ */
+static double lx_benchmark_run(const char *name, size_t num_runs, lx_benchmark_function_t f, lx_any_t argument)
+{
+	lx_highres_clock_t clock;
+	lx_highres_clock_create(&clock);
+
+	f(argument);
+
+	double fastest = 0.0;
+	double total = 0.0;
+	for (size_t i = 0; i < num_runs; ++i) {
+		const int64_t begin = lx_highres_clock_now();
+		f(argument);
+		const double milliseconds = lx_highres_clock_milliseconds(&clock, lx_highres_clock_now() - begin);
+
+		fastest = i == 0 ? milliseconds : lx_min(fastest, milliseconds);
+		total += milliseconds;
+	}
+
+	printf("%-48s %10.3f ms %10.3f ms (fastest, average of %u)\n", name, fastest, total / (double)num_runs, (unsigned)num_runs);
+	return fastest;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //LX_BENCHMARK_H
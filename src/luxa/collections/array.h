@@ -203,6 +203,23 @@ static LX_INLINE bool lx_array_remove_if(lx_array_t *array, lx_binary_predicate_
     return false;
 }
 
+static LX_INLINE void lx_array_resize(lx_array_t *array, size_t size)
+{
+    LX_ASSERT(array, "Invalid array");
+
+    lx_array_reserve(array, size);
+    if (size > array->size)
+        memset(array->buffer + (array->size * array->element_size), 0, (size - array->size) * array->element_size);
+
+    array->size = size;
+}
+
+static LX_INLINE void lx_array_clear(lx_array_t *array)
+{
+    LX_ASSERT(array, "Invalid array");
+    array->size = 0;
+}
+
 static LX_INLINE void lx_array_copy(lx_array_t *array, lx_any_t data, size_t size)
 {
     LX_ASSERT(array, "Invalid array");
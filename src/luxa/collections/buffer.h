@@ -34,6 +34,17 @@ static inline lx_buffer_t *lx_buffer_create_empty(lx_allocator_t *allocator)
 	return lx_buffer_create(allocator, 0);
 }
 
+static inline void lx_buffer_destroy(lx_buffer_t *buffer)
+{
+	LX_ASSERT(buffer, "Invalid buffer");
+
+	if (buffer->data) {
+		lx_free(buffer->allocator, buffer->data);
+	}
+
+	lx_free(buffer->allocator, buffer);
+}
+
 static inline char *lx_buffer_data(lx_buffer_t *buffer)
 {
 	LX_ASSERT(buffer, "Invalid buffer");
@@ -82,7 +93,11 @@ static inline void lx_buffer_reserve(lx_buffer_t *buffer, size_t capacity)
 	lx_buffer_t old = *buffer;
 	buffer->data = lx_alloc(buffer->allocator, capacity);
 	buffer->capacity = capacity;
-	memcpy(buffer->data, old.data, old.size);
+
+	if (old.data) {
+		memcpy(buffer->data, old.data, old.size);
+		lx_free(buffer->allocator, old.data);
+	}
 }
 
 static inline void lx_buffer_resize(lx_buffer_t *buffer, size_t size)
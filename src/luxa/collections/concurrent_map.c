@@ -0,0 +1,146 @@
+#include <luxa/collections/concurrent_map.h>
+#include <luxa/collections/map.h>
+#include <luxa/threading/threading.h>
+
+#define CONCURRENT_MAP_DEFAULT_NUM_SHARDS 64
+
+// Keep every shard on its own cache line so threads using different shards don't contend
+typedef union map_shard {
+	struct {
+		lx_rw_lock_t lock;
+		lx_map_t *map;
+	};
+	char padding[LX_CACHE_LINE_SIZE];
+} map_shard_t;
+
+struct lx_concurrent_map
+{
+	lx_allocator_t *allocator;
+	size_t element_size;
+	size_t num_shards;
+	map_shard_t *shards;
+};
+
+// Ids are hashes already, the map spreads their bits over groups and tags
+static size_t id_hash(const lx_any_t key)
+{
+	return (size_t)*(const lx_id64_t *)key;
+}
+
+static map_shard_t *find_shard(lx_concurrent_map_t *map, lx_id64_t key)
+{
+	// Shards use a different mix than the maps so keys of a shard don't share their tags
+	const uint64_t hash = (key ^ (key >> 32)) * 0xC2B2AE3D27D4EB4Full;
+	return &map->shards[(hash >> 32) & (map->num_shards - 1)];
+}
+
+lx_concurrent_map_t *lx_concurrent_map_create(lx_allocator_t *allocator, size_t element_size, size_t num_shards)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+	LX_ASSERT(element_size, "Invalid map element size");
+
+	size_t shard_count = 1;
+	while (shard_count < (num_shards ? num_shards : CONCURRENT_MAP_DEFAULT_NUM_SHARDS)) {
+		shard_count *= 2;
+	}
+
+	lx_concurrent_map_t *map = lx_alloc(allocator, sizeof(lx_concurrent_map_t));
+	*map = (lx_concurrent_map_t)
+	{
+		.allocator = allocator,
+		.element_size = element_size,
+		.num_shards = shard_count,
+		.shards = lx_alloc_aligned(allocator, sizeof(map_shard_t) * shard_count, LX_CACHE_LINE_SIZE)
+	};
+
+	const lx_map_options_t options = { .key_size = sizeof(lx_id64_t), .hash = id_hash };
+	for (size_t i = 0; i < shard_count; ++i) {
+		lx_rw_lock_create(&map->shards[i].lock);
+		map->shards[i].map = lx_map_create(allocator, element_size, &options);
+	}
+
+	return map;
+}
+
+void lx_concurrent_map_destroy(lx_concurrent_map_t *map)
+{
+	LX_ASSERT(map, "Invalid map");
+
+	for (size_t i = 0; i < map->num_shards; ++i) {
+		lx_map_destroy(map->shards[i].map);
+		lx_rw_lock_destroy(&map->shards[i].lock);
+	}
+
+	lx_allocator_t *allocator = map->allocator;
+	lx_free(allocator, map->shards);
+	lx_free(allocator, map);
+}
+
+void lx_concurrent_map_insert(lx_concurrent_map_t *map, lx_id64_t key, const lx_any_t item)
+{
+	LX_ASSERT(map, "Invalid map");
+
+	map_shard_t *shard = find_shard(map, key);
+	lx_rw_lock_lock_exclusive(&shard->lock);
+	lx_map_insert(shard->map, &key, item);
+	lx_rw_lock_unlock_exclusive(&shard->lock);
+}
+
+bool lx_concurrent_map_try_insert(lx_concurrent_map_t *map, lx_id64_t key, const lx_any_t item)
+{
+	LX_ASSERT(map, "Invalid map");
+
+	map_shard_t *shard = find_shard(map, key);
+	lx_rw_lock_lock_exclusive(&shard->lock);
+
+	const bool inserted = lx_map_at(shard->map, &key, NULL) == NULL;
+	if (inserted) {
+		lx_map_insert(shard->map, &key, item);
+	}
+
+	lx_rw_lock_unlock_exclusive(&shard->lock);
+	return inserted;
+}
+
+bool lx_concurrent_map_remove(lx_concurrent_map_t *map, lx_id64_t key)
+{
+	LX_ASSERT(map, "Invalid map");
+
+	map_shard_t *shard = find_shard(map, key);
+	lx_rw_lock_lock_exclusive(&shard->lock);
+	const bool removed = lx_map_remove(shard->map, &key);
+	lx_rw_lock_unlock_exclusive(&shard->lock);
+
+	return removed;
+}
+
+bool lx_concurrent_map_try_get_value(lx_concurrent_map_t *map, lx_id64_t key, lx_any_t item)
+{
+	LX_ASSERT(map, "Invalid map");
+	LX_ASSERT(item, "Invalid item");
+
+	map_shard_t *shard = find_shard(map, key);
+	lx_rw_lock_lock_shared(&shard->lock);
+
+	const lx_any_t value = lx_map_at(shard->map, &key, NULL);
+	if (value) {
+		memcpy(item, value, map->element_size);
+	}
+
+	lx_rw_lock_unlock_shared(&shard->lock);
+	return value != NULL;
+}
+
+size_t lx_concurrent_map_size(lx_concurrent_map_t *map)
+{
+	LX_ASSERT(map, "Invalid map");
+
+	size_t size = 0;
+	for (size_t i = 0; i < map->num_shards; ++i) {
+		lx_rw_lock_lock_shared(&map->shards[i].lock);
+		size += lx_map_size(map->shards[i].map);
+		lx_rw_lock_unlock_shared(&map->shards[i].lock);
+	}
+
+	return size;
+}
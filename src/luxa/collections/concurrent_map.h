@@ -0,0 +1,51 @@
+#pragma once
+
+#include <luxa/memory/allocator.h>
+#include <luxa/id.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lx_concurrent_map lx_concurrent_map_t;
+
+/*
+ * Hash map keyed by id that can be used from any number of threads. Keys are spread over shards,
+ * each a map guarded by its own reader writer lock, so lookups run in parallel and writers only
+ * block threads using the same shard. The number of shards is rounded up to a power of two, 0 uses
+ * the default.
+ */
+lx_concurrent_map_t *lx_concurrent_map_create(lx_allocator_t *allocator, size_t element_size, size_t num_shards);
+
+/*
+ * No other thread can access the map while it is destroyed.
+ */
+void lx_concurrent_map_destroy(lx_concurrent_map_t *map);
+
+/*
+ * Insert the item, replacing the item of an equal key.
+ */
+void lx_concurrent_map_insert(lx_concurrent_map_t *map, lx_id64_t key, const lx_any_t item);
+
+/*
+ * Insert the item only if the key isn't in the map, returns false if it was. Lets threads racing to
+ * register the same key agree on a single winner.
+ */
+bool lx_concurrent_map_try_insert(lx_concurrent_map_t *map, lx_id64_t key, const lx_any_t item);
+
+bool lx_concurrent_map_remove(lx_concurrent_map_t *map, lx_id64_t key);
+
+/*
+ * Copy the item of the key to item, items are never handed out by pointer since other threads can
+ * move them at any time. Returns false if the key isn't in the map.
+ */
+bool lx_concurrent_map_try_get_value(lx_concurrent_map_t *map, lx_id64_t key, lx_any_t item);
+
+/*
+ * Number of items, only an estimate while other threads modify the map.
+ */
+size_t lx_concurrent_map_size(lx_concurrent_map_t *map);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,137 +1,271 @@
 #include <luxa/collections/map.h>
+#include <luxa/hash.h>
 #include <string.h>
+#include <intrin.h>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define MAP_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define MAP_GROUP_SIZE 16
 #define MAP_DEFAULT_CAPACITY 16
-#define MAP_LOAD_FACTOR 0.5
-#define MAP_PROBE_COUNT 8
+#define MAP_DEFAULT_LOAD_FACTOR 0.875
+
+// Full slots hold the 7 bit tag of the hash, free slots have the sign bit set
+#define MAP_CONTROL_EMPTY ((int8_t)-128)
+#define MAP_CONTROL_DELETED ((int8_t)-2)
+
+typedef uint32_t group_mask_t;
 
 struct lx_map
 {
 	lx_allocator_t *allocator;
 	size_t element_size;
+	size_t key_size;
+	size_t slot_key_size;
 	lx_hash_func_t hash;
-	
+	lx_binary_predicate_t equals;
+	double max_load_factor;
+
 	void *buffer;
 	size_t size;
 	size_t capacity;
-	
-	size_t *keys;
-	uint8_t *entry_states;
-	lx_any_t *items;
-};
+	size_t growth_left;
 
-static void rehash(lx_map_t *map);
+	int8_t *control;
+	char *keys;
+	char *items;
+};
 
-static bool find_empty_bucket(const lx_map_t *map, size_t hash, size_t *index)
+static group_mask_t match_group(const int8_t *group, int8_t value)
 {
-	size_t bucket = hash % map->capacity;
-	if (!map->entry_states[bucket]) {
-		*index = bucket;
-		return true;
+#ifdef MAP_USE_SSE2
+	const __m128i control = _mm_loadu_si128((const __m128i *)group);
+	return (group_mask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), control));
+#else
+	group_mask_t mask = 0;
+	for (uint32_t i = 0; i < MAP_GROUP_SIZE; ++i) {
+		if (group[i] == value)
+			mask |= 1u << i;
 	}
 
-	for (size_t j = 1; j < MAP_PROBE_COUNT; ++j) {
-		bucket = (bucket + j) % map->capacity;
-		if (!map->entry_states[bucket]) {
-			*index = bucket;
-			return true;
-		}
+	return mask;
+#endif
+}
+
+static group_mask_t match_free(const int8_t *group)
+{
+#ifdef MAP_USE_SSE2
+	return (group_mask_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+	group_mask_t mask = 0;
+	for (uint32_t i = 0; i < MAP_GROUP_SIZE; ++i) {
+		if (group[i] < 0)
+			mask |= 1u << i;
 	}
 
-	return false;
+	return mask;
+#endif
 }
 
-static bool find_bucket(const lx_map_t *map, size_t hash, size_t *index)
+static LX_INLINE uint32_t next_match(group_mask_t *mask)
 {
-	size_t bucket = hash % map->capacity;
-	if (map->keys[bucket] == hash) {
-		*index = bucket;
-		return true;
-	}
+	unsigned long index = 0;
+	_BitScanForward(&index, *mask);
+	*mask &= *mask - 1;
+	return (uint32_t)index;
+}
+
+// Spread the bits of weak hashes, like identity hashes of ids, over both the group and the tag
+static LX_INLINE uint64_t mix_hash(uint64_t hash)
+{
+	return hash * 0x9E3779B97F4A7C15ull;
+}
 
-	for (size_t i = 1; i < MAP_PROBE_COUNT; ++i) {
-		bucket = (bucket + i) % map->capacity;
-		if (map->keys[bucket] == hash) {
-			*index = bucket;
-			return true;
+static LX_INLINE size_t hash_group(uint64_t hash)
+{
+	return (size_t)(hash >> 7);
+}
+
+static LX_INLINE int8_t hash_tag(uint64_t hash)
+{
+	return (int8_t)(hash >> 57);
+}
+
+static size_t max_growth(const lx_map_t *map, size_t capacity)
+{
+	const size_t growth = (size_t)(map->max_load_factor * (double)capacity);
+	return lx_max(lx_min(growth, capacity - 1), 1);
+}
+
+static uint64_t hash_key(const lx_map_t *map, const lx_any_t key)
+{
+	if (map->hash)
+		return mix_hash(map->hash(key));
+
+	if (map->key_size)
+		return mix_hash(lx_murmur_hash_64(key, map->key_size, 0));
+
+	return mix_hash(lx_murmur_hash_64(key, strlen((const char *)key), 0));
+}
+
+static LX_INLINE lx_any_t slot_key(const lx_map_t *map, size_t index)
+{
+	char *key = map->keys + map->slot_key_size * index;
+	return map->key_size ? (lx_any_t)key : *(lx_any_t *)key;
+}
+
+static LX_INLINE lx_any_t slot_item(const lx_map_t *map, size_t index)
+{
+	return map->items + map->element_size * index;
+}
+
+static bool keys_equal(const lx_map_t *map, const lx_any_t a, const lx_any_t b)
+{
+	if (map->equals)
+		return map->equals(a, b);
+
+	if (map->key_size)
+		return memcmp(a, b, map->key_size) == 0;
+
+	return strcmp((const char *)a, (const char *)b) == 0;
+}
+
+static bool find_slot(const lx_map_t *map, const lx_any_t key, uint64_t hash, size_t *index)
+{
+	const size_t num_groups = map->capacity / MAP_GROUP_SIZE;
+	const int8_t tag = hash_tag(hash);
+	size_t group = hash_group(hash) & (num_groups - 1);
+
+	// Triangular probing over a power of two number of groups visits every group once
+	for (size_t probe = 1; probe <= num_groups; ++probe) {
+		const int8_t *control = map->control + group * MAP_GROUP_SIZE;
+		for (group_mask_t matches = match_group(control, tag); matches;) {
+			const size_t slot = group * MAP_GROUP_SIZE + next_match(&matches);
+			if (keys_equal(map, slot_key(map, slot), key)) {
+				*index = slot;
+				return true;
+			}
 		}
+
+		if (match_group(control, MAP_CONTROL_EMPTY))
+			return false;
+
+		group = (group + probe) & (num_groups - 1);
 	}
 
 	return false;
 }
 
-static void insert(lx_map_t *map, size_t hash, lx_any_t item)
+static size_t find_free_slot(const lx_map_t *map, uint64_t hash)
 {
-	size_t index = 0;
-	bool found = find_empty_bucket(map, hash, &index);
-	while (!found) {
-		rehash(map);
-		found = find_empty_bucket(map, hash, &index);
-	}
-	
-	map->keys[index] = hash;
-	memcpy(((char *)map->items) + map->element_size * index, item, map->element_size);
-	
-	if (!map->entry_states[index]) {
-		map->size++;
-		map->entry_states[index] = 1;
+	const size_t num_groups = map->capacity / MAP_GROUP_SIZE;
+	size_t group = hash_group(hash) & (num_groups - 1);
+
+	for (size_t probe = 1; probe <= num_groups; ++probe) {
+		group_mask_t free_slots = match_free(map->control + group * MAP_GROUP_SIZE);
+		if (free_slots)
+			return group * MAP_GROUP_SIZE + next_match(&free_slots);
+
+		group = (group + probe) & (num_groups - 1);
 	}
+
+	LX_ASSERT(false, "Map is full");
+	return 0;
 }
 
-static void rehash(lx_map_t *map)
+static void allocate_slots(lx_map_t *map, size_t capacity)
 {
-	const size_t bytes = sizeof(size_t) + sizeof(uint8_t) + map->element_size;
-	
-	lx_map_t old_map = *map;
+	const size_t items_offset = (capacity + map->slot_key_size * capacity + 15) & ~(size_t)15;
 
-	const size_t new_capacity = map->capacity * 2;
-	
-	map->buffer = lx_alloc(map->allocator, bytes * new_capacity);
-	map->capacity = new_capacity;
-	map->size = 0;
+	map->buffer = lx_alloc(map->allocator, items_offset + map->element_size * capacity);
+	map->capacity = capacity;
+	map->growth_left = max_growth(map, capacity) - map->size;
+	map->control = (int8_t *)map->buffer;
+	map->keys = (char *)map->buffer + capacity;
+	map->items = (char *)map->buffer + items_offset;
+
+	memset(map->control, (uint8_t)MAP_CONTROL_EMPTY, capacity);
+}
 
-	memset(map->buffer, 0, bytes * new_capacity);
-	
-	map->keys = (size_t *)map->buffer;
-	map->entry_states = (uint8_t *)(map->keys + map->capacity);
-	map->items = (lx_any_t *)(map->entry_states + map->capacity);
+/*
+ * Move all items to a new set of slots, which also drops every removed slot. Stored keys are moved
+ * as is, strings keep their copy.
+ */
+static void rehash(lx_map_t *map, size_t capacity)
+{
+	lx_map_t old_map = *map;
+	allocate_slots(map, capacity);
 
 	for (size_t i = 0; i < old_map.capacity; ++i) {
-		if (!old_map.entry_states[i])
+		if (old_map.control[i] < 0)
 			continue;
-		
-		size_t hash = old_map.keys[i];
-		lx_any_t item = ((char *)old_map.items) + old_map.element_size * i;
-		insert(map, hash, item);
+
+		const size_t index = find_free_slot(map, hash_key(map, slot_key(&old_map, i)));
+		map->control[index] = old_map.control[i];
+		memcpy(map->keys + map->slot_key_size * index, old_map.keys + old_map.slot_key_size * i, map->slot_key_size);
+		memcpy(slot_item(map, index), slot_item(&old_map, i), map->element_size);
 	}
 
 	lx_free(map->allocator, old_map.buffer);
 }
 
-lx_map_t *lx_map_create(lx_allocator_t *allocator, size_t element_size, lx_hash_func_t hash)
+static void make_room(lx_map_t *map)
+{
+	// Reclaim removed slots while at most half of the usable slots hold items, otherwise grow
+	size_t capacity = map->capacity;
+	if (map->size * 2 > max_growth(map, capacity)) {
+		do {
+			capacity *= 2;
+		} while (max_growth(map, capacity) <= map->size);
+	}
+
+	rehash(map, capacity);
+}
+
+static void store_key(lx_map_t *map, size_t index, const lx_any_t key)
+{
+	char *slot = map->keys + map->slot_key_size * index;
+	if (map->key_size) {
+		memcpy(slot, key, map->key_size);
+		return;
+	}
+
+	const size_t length = strlen((const char *)key) + 1;
+	char *copy = lx_alloc(map->allocator, length);
+	memcpy(copy, key, length);
+	memcpy(slot, &copy, sizeof(char *));
+}
+
+static void free_key(lx_map_t *map, size_t index)
+{
+	if (!map->key_size)
+		lx_free(map->allocator, slot_key(map, index));
+}
+
+lx_map_t *lx_map_create(lx_allocator_t *allocator, size_t element_size, const lx_map_options_t *options)
 {
 	LX_ASSERT(allocator, "Invalid allocator");
 	LX_ASSERT(element_size, "Invalid map element size");
-
-	const size_t bytes = sizeof(size_t) + sizeof(uint8_t) + element_size;
+	LX_ASSERT(options, "Invalid map options");
+	LX_ASSERT(options->max_load_factor >= 0.0 && options->max_load_factor < 1.0, "Invalid map load factor");
 
 	lx_map_t *map = lx_alloc(allocator, sizeof(struct lx_map));
-	
+
 	*map = (lx_map_t)
-	{ 
+	{
 		.allocator = allocator,
 		.element_size = element_size,
-		.hash = hash,
-		.buffer = lx_alloc(allocator, bytes * MAP_DEFAULT_CAPACITY),
-		.capacity = MAP_DEFAULT_CAPACITY,
+		.key_size = options->key_size,
+		.slot_key_size = options->key_size ? options->key_size : sizeof(char *),
+		.hash = options->hash,
+		.equals = options->equals,
+		.max_load_factor = options->max_load_factor > 0.0 ? options->max_load_factor : MAP_DEFAULT_LOAD_FACTOR,
 		.size = 0
 	};
 
-	memset(map->buffer, 0, bytes * MAP_DEFAULT_CAPACITY);
-
-	map->keys = (size_t *)map->buffer;
-	map->entry_states = (uint8_t *)(map->keys + map->capacity);
-	map->items = (lx_any_t *)(map->entry_states + map->capacity);
+	allocate_slots(map, MAP_DEFAULT_CAPACITY);
 
 	return map;
 }
@@ -139,58 +273,159 @@ lx_map_t *lx_map_create(lx_allocator_t *allocator, size_t element_size, lx_hash_
 void lx_map_destroy(lx_map_t *map)
 {
 	LX_ASSERT(map, "Invalid map");
-	
-	lx_free(map->allocator, map->buffer);
-	*map = (lx_map_t) { 0 };
+
+	for (size_t i = 0; i < map->capacity; ++i) {
+		if (map->control[i] >= 0)
+			free_key(map, i);
+	}
+
+	lx_allocator_t *allocator = map->allocator;
+	lx_free(allocator, map->buffer);
+	lx_free(allocator, map);
 }
 
 void lx_map_insert(lx_map_t *map, lx_any_t key, lx_any_t item)
 {
 	LX_ASSERT(map, "Invalid map");
 
-	double load_factor = ((double)map->size) / ((double)map->capacity);
-	if (load_factor >= MAP_LOAD_FACTOR) {
-		rehash(map);
-	}	
-	
-	insert(map, map->hash(key), item);
+	const uint64_t hash = hash_key(map, key);
+	size_t index = 0;
+
+	if (find_slot(map, key, hash, &index)) {
+		memcpy(slot_item(map, index), item, map->element_size);
+		return;
+	}
+
+	index = find_free_slot(map, hash);
+	if (map->growth_left == 0 && map->control[index] == MAP_CONTROL_EMPTY) {
+		make_room(map);
+		index = find_free_slot(map, hash);
+	}
+
+	// Reusing a removed slot doesn't take up more of the table
+	if (map->control[index] == MAP_CONTROL_EMPTY)
+		map->growth_left--;
+
+	map->control[index] = hash_tag(hash);
+	map->size++;
+	store_key(map, index, key);
+	memcpy(slot_item(map, index), item, map->element_size);
 }
 
 bool lx_map_remove(lx_map_t *map, lx_any_t key)
 {
-	size_t hash = map->hash(key);
-	size_t index = 0;
+	LX_ASSERT(map, "Invalid map");
 
-	if (!find_bucket(map, hash, &index))
+	size_t index = 0;
+	if (!find_slot(map, key, hash_key(map, key), &index))
 		return false;
-	
-	map->entry_states[index] = 0;
+
+	free_key(map, index);
 	map->size--;
 
+	// A probe only moves past a group without empty slots, if the group still has one no probe
+	// depends on the removed slot and it can be emptied instead of marked as removed
+	if (match_group(map->control + index / MAP_GROUP_SIZE * MAP_GROUP_SIZE, MAP_CONTROL_EMPTY)) {
+		map->control[index] = MAP_CONTROL_EMPTY;
+		map->growth_left++;
+	} else {
+		map->control[index] = MAP_CONTROL_DELETED;
+	}
+
 	return true;
 }
 
 lx_any_t lx_map_at(const lx_map_t *map, lx_any_t key, lx_any_t default_value)
 {
 	LX_ASSERT(map, "Invalid map");
-	
-	size_t hash = map->hash(key);
+
 	size_t index = 0;
-	
-	if (find_bucket(map, hash, &index)) {
-		return ((char *)map->items) + map->element_size * index;
+	if (find_slot(map, key, hash_key(map, key), &index)) {
+		return slot_item(map, index);
 	}
-	
+
 	return default_value;
 }
 
 bool lx_map_try_get_value(const lx_map_t *map, lx_any_t key, lx_any_t *item)
 {
-	size_t hash = map->hash(key);
+	LX_ASSERT(map, "Invalid map");
+
 	size_t index = 0;
+	if (find_slot(map, key, hash_key(map, key), &index)) {
+		*item = slot_item(map, index);
+		return true;
+	}
+
+	return false;
+}
+
+size_t lx_map_size(const lx_map_t *map)
+{
+	LX_ASSERT(map, "Invalid map");
+	return map->size;
+}
+
+size_t lx_map_capacity(const lx_map_t *map)
+{
+	LX_ASSERT(map, "Invalid map");
+	return map->capacity;
+}
+
+void lx_map_reserve(lx_map_t *map, size_t count)
+{
+	LX_ASSERT(map, "Invalid map");
+
+	if (count <= map->size || count - map->size <= map->growth_left)
+		return;
+
+	size_t capacity = map->capacity;
+	while (max_growth(map, capacity) < count) {
+		capacity *= 2;
+	}
+
+	rehash(map, capacity);
+}
+
+void lx_map_insert_many(lx_map_t *map, const lx_any_t *keys, const lx_any_t items, size_t count)
+{
+	LX_ASSERT(map, "Invalid map");
+	LX_ASSERT(keys || !count, "Invalid keys");
+
+	lx_map_reserve(map, map->size + count);
+
+	for (size_t i = 0; i < count; ++i) {
+		lx_map_insert(map, keys[i], (char *)items + map->element_size * i);
+	}
+}
+
+lx_map_iterator_t lx_map_iterator(const lx_map_t *map)
+{
+	LX_ASSERT(map, "Invalid map");
+	return (lx_map_iterator_t) { .map = map };
+}
+
+bool lx_map_next(lx_map_iterator_t *iterator)
+{
+	LX_ASSERT(iterator, "Invalid iterator");
+
+	const lx_map_t *map = iterator->map;
+
+	// Scan a group of control bytes at a time, skipping the slots already visited in the group
+	while (iterator->index < map->capacity) {
+		const size_t group = iterator->index / MAP_GROUP_SIZE;
+		group_mask_t full_slots = ~match_free(map->control + group * MAP_GROUP_SIZE) & 0xffff;
+		full_slots &= 0xffffu << (iterator->index % MAP_GROUP_SIZE);
+
+		if (!full_slots) {
+			iterator->index = (group + 1) * MAP_GROUP_SIZE;
+			continue;
+		}
 
-	if (find_bucket(map, hash, &index)) {
-		*item = ((char *)map->items) + map->element_size * index;
+		const size_t index = group * MAP_GROUP_SIZE + next_match(&full_slots);
+		iterator->index = index + 1;
+		iterator->key = slot_key(map, index);
+		iterator->item = slot_item(map, index);
 		return true;
 	}
 
@@ -10,10 +10,31 @@ typedef struct lx_map lx_map_t;
 
 typedef size_t (*lx_hash_func_t)(const lx_any_t key);
 
-lx_map_t *lx_map_create(lx_allocator_t *allocator, size_t element_size, lx_hash_func_t);
+/*
+ * Keys are copied into the map. A key size of 0 means keys are NUL-terminated strings, otherwise a
+ * key points to key_size bytes. Equal keys must have equal hashes, without an equality function
+ * keys are compared with strcmp or memcmp. The load factor is the fraction of slots, including
+ * removed slots, that can be used before the map grows, zero options use the defaults.
+ */
+typedef struct lx_map_options {
+	size_t key_size;
+	lx_hash_func_t hash;
+	lx_binary_predicate_t equals;
+	double max_load_factor;
+} lx_map_options_t;
+
+/*
+ * Open addressing hash map in the style of a Swiss table. Slots are split into groups of 16 with a
+ * control byte per slot holding 7 bits of the hash, a whole group is matched with a few SIMD
+ * instructions before any key is compared. Pointers to items are invalidated by inserts.
+ */
+lx_map_t *lx_map_create(lx_allocator_t *allocator, size_t element_size, const lx_map_options_t *options);
 
 void lx_map_destroy(lx_map_t *map);
 
+/*
+ * Insert the item, replacing the item of an equal key.
+ */
 void lx_map_insert(lx_map_t *map, lx_any_t key, lx_any_t item);
 
 bool lx_map_remove(lx_map_t *map, lx_any_t key);
@@ -22,6 +43,45 @@ lx_any_t lx_map_at(const lx_map_t *map, lx_any_t key, lx_any_t default_value);
 
 bool lx_map_try_get_value(const lx_map_t *map, lx_any_t key, lx_any_t *item);
 
+size_t lx_map_size(const lx_map_t *map);
+
+/*
+ * Number of slots, the map grows before more than max_load_factor of them are used.
+ */
+size_t lx_map_capacity(const lx_map_t *map);
+
+/*
+ * Make room for count items in total, inserting up to that many items won't grow or rehash the map.
+ */
+void lx_map_reserve(lx_map_t *map, size_t count);
+
+/*
+ * Insert count items, the map grows at most once. Keys are passed the same way as to
+ * lx_map_insert, one per item, items are stored contiguously.
+ */
+void lx_map_insert_many(lx_map_t *map, const lx_any_t *keys, const lx_any_t items, size_t count);
+
+/*
+ * Visits the items in slot order, the map must not be modified while iterating. Key points to the
+ * stored key, the same way keys are passed to lx_map_insert.
+ */
+typedef struct lx_map_iterator {
+	const lx_map_t *map;
+	size_t index;
+	lx_any_t key;
+	lx_any_t item;
+} lx_map_iterator_t;
+
+lx_map_iterator_t lx_map_iterator(const lx_map_t *map);
+
+/*
+ * Move to the next item, returns false when all items have been visited.
+ */
+bool lx_map_next(lx_map_iterator_t *iterator);
+
+#define lx_map_for(it, map)\
+	for (lx_map_iterator_t it = lx_map_iterator(map); lx_map_next(&it);)
+
 #ifdef __cplusplus
 }
 #endif
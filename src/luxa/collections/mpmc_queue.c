@@ -0,0 +1,136 @@
+#include <luxa/collections/mpmc_queue.h>
+#include <luxa/threading/threading.h>
+
+/*
+ * A slot is free for the push at position p when its sequence is p and holds the item for the pop
+ * at position p when its sequence is p + 1. Popping sets the sequence to the position of the push
+ * one lap later.
+ */
+typedef struct queue_slot {
+	volatile int64_t sequence;
+} queue_slot_t;
+
+/*
+ * Producers and consumers claim positions with a CAS on their own cache line.
+ */
+struct lx_mpmc_queue {
+	volatile int64_t push_position;
+	char push_padding[LX_CACHE_LINE_SIZE - sizeof(int64_t)];
+	volatile int64_t pop_position;
+	char pop_padding[LX_CACHE_LINE_SIZE - sizeof(int64_t)];
+	int64_t capacity;
+	size_t element_size;
+	size_t slot_size;
+	char *slots;
+	lx_allocator_t *allocator;
+};
+
+static inline queue_slot_t *slot_at(lx_mpmc_queue_t *queue, int64_t position)
+{
+	return (queue_slot_t *)(queue->slots + queue->slot_size * (size_t)(position & (queue->capacity - 1)));
+}
+
+lx_mpmc_queue_t *lx_mpmc_queue_create(lx_allocator_t *allocator, size_t element_size, size_t capacity)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+	LX_ASSERT(element_size, "Invalid element size");
+	LX_ASSERT(lx_is_power_of_two(capacity), "Capacity must be a power of two");
+
+	// Items follow the sequence of their slot, slots stay 8 byte aligned
+	const size_t slot_size = (sizeof(queue_slot_t) + element_size + 7) & ~(size_t)7;
+
+	lx_mpmc_queue_t *queue = lx_alloc_aligned(allocator, sizeof(lx_mpmc_queue_t), LX_CACHE_LINE_SIZE);
+	*queue = (lx_mpmc_queue_t) {
+		.push_position = 0,
+		.pop_position = 0,
+		.capacity = (int64_t)capacity,
+		.element_size = element_size,
+		.slot_size = slot_size,
+		.slots = lx_alloc_aligned(allocator, slot_size * capacity, LX_CACHE_LINE_SIZE),
+		.allocator = allocator
+	};
+
+	for (int64_t i = 0; i < queue->capacity; ++i) {
+		slot_at(queue, i)->sequence = i;
+	}
+
+	return queue;
+}
+
+void lx_mpmc_queue_destroy(lx_mpmc_queue_t *queue)
+{
+	LX_ASSERT(queue, "Invalid queue");
+
+	lx_allocator_t *allocator = queue->allocator;
+	lx_free(allocator, queue->slots);
+	lx_free(allocator, queue);
+}
+
+bool lx_mpmc_queue_push(lx_mpmc_queue_t *queue, const lx_any_t item)
+{
+	LX_ASSERT(queue, "Invalid queue");
+
+	int64_t position = lx_atomic_load_64(&queue->push_position);
+	queue_slot_t *slot = NULL;
+
+	for (;;) {
+		slot = slot_at(queue, position);
+		const int64_t difference = lx_atomic_load_64(&slot->sequence) - position;
+
+		if (difference == 0) {
+			const int64_t current = lx_atomic_exchange_64(&queue->push_position, position + 1, position);
+			if (current == position)
+				break;
+
+			position = current;
+		} else if (difference < 0) {
+			// The slot still holds the item of the previous lap
+			return false;
+		} else {
+			position = lx_atomic_load_64(&queue->push_position);
+		}
+	}
+
+	memcpy(slot + 1, item, queue->element_size);
+	lx_atomic_store_64(&slot->sequence, position + 1);
+	return true;
+}
+
+bool lx_mpmc_queue_pop(lx_mpmc_queue_t *queue, lx_any_t item)
+{
+	LX_ASSERT(queue, "Invalid queue");
+
+	int64_t position = lx_atomic_load_64(&queue->pop_position);
+	queue_slot_t *slot = NULL;
+
+	for (;;) {
+		slot = slot_at(queue, position);
+		const int64_t difference = lx_atomic_load_64(&slot->sequence) - (position + 1);
+
+		if (difference == 0) {
+			const int64_t current = lx_atomic_exchange_64(&queue->pop_position, position + 1, position);
+			if (current == position)
+				break;
+
+			position = current;
+		} else if (difference < 0) {
+			// The push of this position hasn't finished
+			return false;
+		} else {
+			position = lx_atomic_load_64(&queue->pop_position);
+		}
+	}
+
+	memcpy(item, slot + 1, queue->element_size);
+	lx_atomic_store_64(&slot->sequence, position + queue->capacity);
+	return true;
+}
+
+size_t lx_mpmc_queue_size(lx_mpmc_queue_t *queue)
+{
+	LX_ASSERT(queue, "Invalid queue");
+
+	const int64_t pop_position = lx_atomic_load_64(&queue->pop_position);
+	const int64_t push_position = lx_atomic_load_64(&queue->push_position);
+	return push_position > pop_position ? (size_t)(push_position - pop_position) : 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lx_mpmc_queue lx_mpmc_queue_t;
+
+/*
+ * Creates a bounded lock-free queue any number of threads can push to and pop from, after Dmitry
+ * Vyukov's bounded MPMC queue. Every slot carries a sequence number that tells producers and
+ * consumers whether it is theirs to use, so a push or pop costs a single CAS. Items are copied in
+ * and out, capacity must be a power of two.
+ */
+lx_mpmc_queue_t *lx_mpmc_queue_create(lx_allocator_t *allocator, size_t element_size, size_t capacity);
+
+/*
+ * Destroy queue. No other thread can access the queue while it is destroyed.
+ */
+void lx_mpmc_queue_destroy(lx_mpmc_queue_t *queue);
+
+/*
+ * Copy the item to the back of the queue, can be called from any thread. Returns false if the
+ * queue is full.
+ */
+bool lx_mpmc_queue_push(lx_mpmc_queue_t *queue, const lx_any_t item);
+
+/*
+ * Copy the front item to item and remove it, can be called from any thread. Returns false if the
+ * queue is empty.
+ */
+bool lx_mpmc_queue_pop(lx_mpmc_queue_t *queue, lx_any_t item);
+
+/*
+ * Number of items in the queue. Only an estimate while other threads access the queue.
+ */
+size_t lx_mpmc_queue_size(lx_mpmc_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
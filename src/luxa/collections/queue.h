@@ -53,8 +53,20 @@ static LX_INLINE void lx_queue_reserve(lx_queue_t *queue, size_t size)
     if (size < queue->capacity)
         return;
 
-    queue->capacity = lx_max(queue->capacity * 2, size);
-    lx_realloc(queue->allocator, queue->data, queue->element_size * queue->capacity);
+    const size_t capacity = lx_max(queue->capacity * 2, size);
+    int8_t *data = (int8_t *)lx_alloc(queue->allocator, queue->element_size * capacity);
+
+    // Unwrap the elements to the front of the new buffer
+    for (size_t i = 0; i < queue->size; ++i) {
+        const size_t index = (queue->head + i) % queue->capacity;
+        memcpy(data + (i * queue->element_size), queue->data + (index * queue->element_size), queue->element_size);
+    }
+
+    lx_free(queue->allocator, queue->data);
+    queue->data = data;
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->tail = queue->size ? queue->size - 1 : capacity - 1;
 }
 
 static LX_INLINE void lx_queue_enqueue(lx_queue_t *queue, lx_any_t element)
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+#include <luxa/collections/array.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Handle to an item of a slot map, the low 32 bits are the slot and the high 32 bits the generation
+ * of the slot when the item was inserted. A removed item bumps the generation of its slot so stale
+ * handles are detected even when the slot is reused. Handles are never 0.
+ */
+typedef uint64_t lx_handle_t;
+
+#define LX_SLOT_MAP_NO_SLOT UINT32_MAX
+
+typedef struct lx_slot_map_slot {
+	uint32_t index; // Dense index of the item, or the next free slot
+	uint32_t generation;
+} lx_slot_map_slot_t;
+
+/*
+ * Items are kept packed in insertion order until removed, removing an item moves the last item into
+ * its place. Pointers to items are invalidated by inserts and removes, handles are not.
+ */
+typedef struct lx_slot_map {
+	lx_array_t *items;
+	lx_array_t *handles; // lx_handle_t of every item
+	lx_array_t *slots; // lx_slot_map_slot_t
+	uint32_t free_slot;
+} lx_slot_map_t;
+
+static LX_INLINE lx_handle_t lx_nil_handle()
+{
+	return 0;
+}
+
+static LX_INLINE uint32_t lx_handle_slot(lx_handle_t handle)
+{
+	return (uint32_t)handle;
+}
+
+static LX_INLINE uint32_t lx_handle_generation(lx_handle_t handle)
+{
+	return (uint32_t)(handle >> 32);
+}
+
+static LX_INLINE lx_slot_map_t *lx_slot_map_create(lx_allocator_t *allocator, size_t element_size)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+
+	lx_slot_map_t *map = lx_alloc(allocator, sizeof(lx_slot_map_t));
+	*map = (lx_slot_map_t) {
+		.items = lx_array_create(allocator, element_size),
+		.handles = lx_array_create(allocator, sizeof(lx_handle_t)),
+		.slots = lx_array_create(allocator, sizeof(lx_slot_map_slot_t)),
+		.free_slot = LX_SLOT_MAP_NO_SLOT
+	};
+
+	return map;
+}
+
+static LX_INLINE void lx_slot_map_destroy(lx_slot_map_t *map)
+{
+	LX_ASSERT(map, "Invalid slot map");
+
+	lx_allocator_t *allocator = map->items->allocator;
+	lx_array_destroy(map->items);
+	lx_array_destroy(map->handles);
+	lx_array_destroy(map->slots);
+	lx_free(allocator, map);
+}
+
+static LX_INLINE size_t lx_slot_map_size(lx_slot_map_t *map)
+{
+	LX_ASSERT(map, "Invalid slot map");
+	return lx_array_size(map->items);
+}
+
+/*
+ * Slot of the item, NULL if the handle is stale.
+ */
+static LX_INLINE lx_slot_map_slot_t *lx_slot_map_find_slot(const lx_slot_map_t *map, lx_handle_t handle)
+{
+	const uint32_t slot_index = lx_handle_slot(handle);
+	if (slot_index >= map->slots->size)
+		return NULL;
+
+	lx_slot_map_slot_t *slot = lx_array_at(map->slots, slot_index);
+	return slot->generation == lx_handle_generation(handle) ? slot : NULL;
+}
+
+/*
+ * Copy the item into the map and return its handle.
+ */
+static LX_INLINE lx_handle_t lx_slot_map_insert(lx_slot_map_t *map, lx_any_t item)
+{
+	LX_ASSERT(map, "Invalid slot map");
+	LX_ASSERT(item, "Invalid item");
+
+	uint32_t slot_index = map->free_slot;
+	if (slot_index != LX_SLOT_MAP_NO_SLOT) {
+		map->free_slot = ((lx_slot_map_slot_t *)lx_array_at(map->slots, slot_index))->index;
+	} else {
+		LX_ASSERT(lx_array_size(map->slots) < LX_SLOT_MAP_NO_SLOT, "Slot map is full");
+		slot_index = (uint32_t)lx_array_size(map->slots);
+		lx_slot_map_slot_t new_slot = { .index = 0, .generation = 1 };
+		lx_array_push_back(map->slots, &new_slot);
+	}
+
+	lx_slot_map_slot_t *slot = lx_array_at(map->slots, slot_index);
+	slot->index = (uint32_t)lx_array_size(map->items);
+
+	const lx_handle_t handle = ((uint64_t)slot->generation << 32) | slot_index;
+	lx_array_push_back(map->items, item);
+	lx_array_push_back(map->handles, (lx_any_t)&handle);
+
+	return handle;
+}
+
+/*
+ * Returns NULL if the handle is stale.
+ */
+static LX_INLINE lx_any_t lx_slot_map_at(const lx_slot_map_t *map, lx_handle_t handle)
+{
+	LX_ASSERT(map, "Invalid slot map");
+
+	const lx_slot_map_slot_t *slot = lx_slot_map_find_slot(map, handle);
+	return slot ? lx_array_at(map->items, slot->index) : NULL;
+}
+
+static LX_INLINE bool lx_slot_map_contains(const lx_slot_map_t *map, lx_handle_t handle)
+{
+	LX_ASSERT(map, "Invalid slot map");
+	return lx_slot_map_find_slot(map, handle) != NULL;
+}
+
+/*
+ * Remove the item, returns false if the handle is stale.
+ */
+static LX_INLINE bool lx_slot_map_remove(lx_slot_map_t *map, lx_handle_t handle)
+{
+	LX_ASSERT(map, "Invalid slot map");
+
+	lx_slot_map_slot_t *slot = lx_slot_map_find_slot(map, handle);
+	if (!slot)
+		return false;
+
+	// Fill the hole with the last item to keep the items packed
+	const size_t last = lx_array_size(map->items) - 1;
+	if (slot->index != last) {
+		const lx_handle_t last_handle = *(lx_handle_t *)lx_array_at(map->handles, last);
+		memcpy(lx_array_at(map->items, slot->index), lx_array_at(map->items, last), map->items->element_size);
+		*(lx_handle_t *)lx_array_at(map->handles, slot->index) = last_handle;
+		((lx_slot_map_slot_t *)lx_array_at(map->slots, lx_handle_slot(last_handle)))->index = slot->index;
+	}
+
+	lx_array_pop_back(map->items);
+	lx_array_pop_back(map->handles);
+
+	// Generation 0 is skipped on wrap around so no handle is ever 0
+	slot->generation = slot->generation == UINT32_MAX ? 1 : slot->generation + 1;
+	slot->index = map->free_slot;
+	map->free_slot = lx_handle_slot(handle);
+
+	return true;
+}
+
+/*
+ * The packed items, lx_slot_map_size of them.
+ */
+static LX_INLINE lx_any_t lx_slot_map_begin(lx_slot_map_t *map)
+{
+	LX_ASSERT(map, "Invalid slot map");
+	return lx_array_begin(map->items);
+}
+
+static LX_INLINE lx_any_t lx_slot_map_end(lx_slot_map_t *map)
+{
+	LX_ASSERT(map, "Invalid slot map");
+	return lx_array_end(map->items);
+}
+
+/*
+ * Handle of the packed item at index.
+ */
+static LX_INLINE lx_handle_t lx_slot_map_handle_at(lx_slot_map_t *map, size_t index)
+{
+	LX_ASSERT(map, "Invalid slot map");
+	return *(lx_handle_t *)lx_array_at(map->handles, index);
+}
+
+#define lx_slot_map_for(type, ptr, map)\
+    for (type *ptr = lx_slot_map_begin(map); ptr != lx_slot_map_end(map); ++ptr)
+
+#ifdef __cplusplus
+}
+#endif
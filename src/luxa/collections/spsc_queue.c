@@ -0,0 +1,98 @@
+#include <luxa/collections/spsc_queue.h>
+#include <luxa/threading/threading.h>
+
+/*
+ * Head is written by the consumer and tail by the producer, keep them on separate cache lines. Each
+ * side caches the last index it read from the other side and only reads it again when the queue
+ * looks full or empty.
+ */
+struct lx_spsc_queue {
+	volatile int64_t head;
+	int64_t cached_tail;
+	char consumer_padding[LX_CACHE_LINE_SIZE - 2 * sizeof(int64_t)];
+	volatile int64_t tail;
+	int64_t cached_head;
+	char producer_padding[LX_CACHE_LINE_SIZE - 2 * sizeof(int64_t)];
+	int64_t capacity;
+	size_t element_size;
+	char *items;
+	lx_allocator_t *allocator;
+};
+
+static inline lx_any_t item_at(lx_spsc_queue_t *queue, int64_t index)
+{
+	return queue->items + queue->element_size * (size_t)(index & (queue->capacity - 1));
+}
+
+lx_spsc_queue_t *lx_spsc_queue_create(lx_allocator_t *allocator, size_t element_size, size_t capacity)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+	LX_ASSERT(element_size, "Invalid element size");
+	LX_ASSERT(lx_is_power_of_two(capacity), "Capacity must be a power of two");
+
+	lx_spsc_queue_t *queue = lx_alloc_aligned(allocator, sizeof(lx_spsc_queue_t), LX_CACHE_LINE_SIZE);
+	*queue = (lx_spsc_queue_t) {
+		.head = 0,
+		.tail = 0,
+		.capacity = (int64_t)capacity,
+		.element_size = element_size,
+		.items = lx_alloc(allocator, element_size * capacity),
+		.allocator = allocator
+	};
+
+	return queue;
+}
+
+void lx_spsc_queue_destroy(lx_spsc_queue_t *queue)
+{
+	LX_ASSERT(queue, "Invalid queue");
+
+	lx_allocator_t *allocator = queue->allocator;
+	lx_free(allocator, queue->items);
+	lx_free(allocator, queue);
+}
+
+bool lx_spsc_queue_push(lx_spsc_queue_t *queue, const lx_any_t item)
+{
+	LX_ASSERT(queue, "Invalid queue");
+
+	const int64_t tail = queue->tail;
+	if (tail - queue->cached_head >= queue->capacity) {
+		queue->cached_head = lx_atomic_load_64(&queue->head);
+		if (tail - queue->cached_head >= queue->capacity)
+			return false;
+	}
+
+	memcpy(item_at(queue, tail), item, queue->element_size);
+
+	// Publish the item before the new tail
+	lx_atomic_store_64(&queue->tail, tail + 1);
+	return true;
+}
+
+bool lx_spsc_queue_pop(lx_spsc_queue_t *queue, lx_any_t item)
+{
+	LX_ASSERT(queue, "Invalid queue");
+
+	const int64_t head = queue->head;
+	if (head == queue->cached_tail) {
+		queue->cached_tail = lx_atomic_load_64(&queue->tail);
+		if (head == queue->cached_tail)
+			return false;
+	}
+
+	memcpy(item, item_at(queue, head), queue->element_size);
+
+	// The item must be read before the producer can reuse its slot
+	lx_atomic_store_64(&queue->head, head + 1);
+	return true;
+}
+
+size_t lx_spsc_queue_size(lx_spsc_queue_t *queue)
+{
+	LX_ASSERT(queue, "Invalid queue");
+
+	const int64_t head = lx_atomic_load_64(&queue->head);
+	const int64_t tail = lx_atomic_load_64(&queue->tail);
+	return tail > head ? (size_t)(tail - head) : 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lx_spsc_queue lx_spsc_queue_t;
+
+/*
+ * Creates a bounded lock-free queue for a single producer thread and a single consumer thread.
+ * Items are copied in and out, capacity must be a power of two.
+ */
+lx_spsc_queue_t *lx_spsc_queue_create(lx_allocator_t *allocator, size_t element_size, size_t capacity);
+
+/*
+ * Destroy queue. No other thread can access the queue while it is destroyed.
+ */
+void lx_spsc_queue_destroy(lx_spsc_queue_t *queue);
+
+/*
+ * Copy the item to the back of the queue, must only be called by the producer. Returns false if
+ * the queue is full.
+ */
+bool lx_spsc_queue_push(lx_spsc_queue_t *queue, const lx_any_t item);
+
+/*
+ * Copy the front item to item and remove it, must only be called by the consumer. Returns false if
+ * the queue is empty.
+ */
+bool lx_spsc_queue_pop(lx_spsc_queue_t *queue, lx_any_t item);
+
+/*
+ * Number of items in the queue. Only an estimate while other threads access the queue.
+ */
+size_t lx_spsc_queue_size(lx_spsc_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
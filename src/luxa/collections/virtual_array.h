@@ -0,0 +1,193 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+#include <luxa/memory/virtual_memory.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Growable array backed by a range of reserved address space. Pages are committed as the array
+ * grows so elements are never moved and pointers to them stay valid until the array is destroyed.
+ * The array can not grow beyond the maximum size given at creation.
+ */
+typedef struct lx_virtual_array
+{
+	lx_allocator_t *allocator;
+	char *buffer;
+	size_t element_size;
+	size_t size;
+	size_t committed_bytes;
+	size_t reserved_bytes;
+} lx_virtual_array_t;
+
+static LX_INLINE lx_virtual_array_t *lx_virtual_array_create(lx_allocator_t *allocator, size_t element_size, size_t max_size)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+	LX_ASSERT(element_size > 0, "Element size must be greater than zero");
+	LX_ASSERT(max_size > 0, "Max size must be greater than zero");
+
+	const size_t reserved_bytes = lx_align_up(element_size * max_size, lx_virtual_memory_page_size());
+
+	lx_virtual_array_t *a = (lx_virtual_array_t *)lx_alloc(allocator, sizeof(lx_virtual_array_t));
+	*a = (lx_virtual_array_t) {
+		.allocator = allocator,
+		.buffer = (char *)lx_virtual_memory_reserve(reserved_bytes),
+		.element_size = element_size,
+		.size = 0,
+		.committed_bytes = 0,
+		.reserved_bytes = reserved_bytes
+	};
+
+	LX_ASSERT(a->buffer, "Failed to reserve address space");
+	return a;
+}
+
+static LX_INLINE void lx_virtual_array_destroy(lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+
+	lx_virtual_memory_release(array->buffer, array->reserved_bytes);
+	lx_free(array->allocator, array);
+}
+
+static LX_INLINE size_t lx_virtual_array_capacity(const lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+	return array->committed_bytes / array->element_size;
+}
+
+static LX_INLINE size_t lx_virtual_array_max_size(const lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+	return array->reserved_bytes / array->element_size;
+}
+
+/*
+ * Commit room for size elements. Fails without changing the array when size is beyond the maximum
+ * size or the pages can't be committed.
+ */
+static LX_INLINE lx_result_t lx_virtual_array_reserve(lx_virtual_array_t *array, size_t size)
+{
+	LX_ASSERT(array, "Invalid array");
+
+	if (size > lx_virtual_array_max_size(array))
+		return LX_ERROR;
+
+	const size_t bytes = size * array->element_size;
+	if (bytes <= array->committed_bytes)
+		return LX_SUCCESS;
+
+	// Commit at least twice what is already committed to keep the number of system calls down
+	size_t committed_bytes = lx_max(bytes, array->committed_bytes * 2);
+	committed_bytes = lx_min(lx_align_up(committed_bytes, lx_virtual_memory_page_size()), array->reserved_bytes);
+
+	lx_result_t result = lx_virtual_memory_commit(array->buffer + array->committed_bytes, committed_bytes - array->committed_bytes);
+	if (result != LX_SUCCESS)
+		return result;
+
+	array->committed_bytes = committed_bytes;
+	return LX_SUCCESS;
+}
+
+/*
+ * Decommit pages that are not used by any element.
+ */
+static LX_INLINE void lx_virtual_array_shrink_to_fit(lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+
+	const size_t committed_bytes = lx_align_up(array->size * array->element_size, lx_virtual_memory_page_size());
+	if (committed_bytes >= array->committed_bytes)
+		return;
+
+	lx_virtual_memory_decommit(array->buffer + committed_bytes, array->committed_bytes - committed_bytes);
+	array->committed_bytes = committed_bytes;
+}
+
+/*
+ * New elements are zero initialized. Fails without changing the array when it can't hold size
+ * elements.
+ */
+static LX_INLINE lx_result_t lx_virtual_array_resize(lx_virtual_array_t *array, size_t size)
+{
+	LX_ASSERT(array, "Invalid array");
+
+	lx_result_t result = lx_virtual_array_reserve(array, size);
+	if (result != LX_SUCCESS)
+		return result;
+
+	if (size > array->size)
+		memset(array->buffer + (array->size * array->element_size), 0, (size - array->size) * array->element_size);
+
+	array->size = size;
+	return LX_SUCCESS;
+}
+
+/*
+ * Returns the added element, or NULL when the array is full.
+ */
+static LX_INLINE lx_any_t lx_virtual_array_push_back(lx_virtual_array_t *array, lx_any_t element)
+{
+	LX_ASSERT(array, "Invalid array");
+
+	if (lx_virtual_array_reserve(array, array->size + 1) != LX_SUCCESS)
+		return NULL;
+
+	char *dst = array->buffer + (array->size * array->element_size);
+	memcpy(dst, element, array->element_size);
+	array->size++;
+	return dst;
+}
+
+static LX_INLINE lx_any_t lx_virtual_array_pop_back(lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+	LX_ASSERT(array->size, "Array is empty");
+
+	array->size--;
+	return array->buffer + (array->size * array->element_size);
+}
+
+static LX_INLINE lx_any_t lx_virtual_array_at(const lx_virtual_array_t *array, size_t index)
+{
+	LX_ASSERT(array, "Invalid array");
+	LX_ASSERT(index < array->size, "Index out of bounds");
+	return (lx_any_t)(array->buffer + (array->element_size * index));
+}
+
+static LX_INLINE lx_any_t lx_virtual_array_begin(lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+	return (lx_any_t)array->buffer;
+}
+
+static LX_INLINE lx_any_t lx_virtual_array_end(lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+	return (lx_any_t)(array->buffer + (array->size * array->element_size));
+}
+
+static LX_INLINE size_t lx_virtual_array_size(const lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+	return array->size;
+}
+
+static LX_INLINE bool lx_virtual_array_is_empty(const lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+	return array->size == 0;
+}
+
+static LX_INLINE void lx_virtual_array_clear(lx_virtual_array_t *array)
+{
+	LX_ASSERT(array, "Invalid array");
+	array->size = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <luxa/platform.h>
+#include <luxa/math/simd.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,6 +64,31 @@ typedef struct lx_extent2 {
 	uint32_t height;
 } lx_extent2_t;
 
+/*
+ * Axis aligned box, a box with min above max on any axis is empty and contains nothing.
+ */
+typedef struct lx_aabb {
+	lx_vec3_t min;
+	lx_vec3_t max;
+} lx_aabb_t;
+
+typedef struct lx_sphere {
+	lx_vec3_t center;
+	float radius;
+} lx_sphere_t;
+
+typedef struct lx_ray {
+	lx_vec3_t origin;
+	lx_vec3_t direction;
+} lx_ray_t;
+
+/*
+ * Planes facing into the frustum, a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+ */
+typedef struct lx_frustum {
+	lx_vec4_t planes[6];
+} lx_frustum_t;
+
 #define lx_sqrtf sqrtf
 
 #define lx_radians(degrees) (degrees * LX_PI_OVER_180)
@@ -289,9 +315,15 @@ static LX_INLINE void lx_vec3_transform_3x3(const lx_vec3_t *v, const lx_mat4_t
 
 static LX_INLINE void lx_vec3_transform_4x4(const lx_vec3_t *v, const lx_mat4_t *m, lx_vec3_t *out)
 {
-	out->x = v->x * m->m11 + v->y * m->m21 + v->z * m->m31 + m->m41;
-	out->y = v->x * m->m12 + v->y * m->m22 + v->z * m->m32 + m->m42;
-	out->z = v->x * m->m13 + v->y * m->m23 + v->z * m->m33 + m->m43;
+    lx_simd4_t r = lx_simd4_madd(lx_simd4_splat(v->x), lx_simd4_load(&m->m11), lx_simd4_load(&m->m41));
+    r = lx_simd4_madd(lx_simd4_splat(v->y), lx_simd4_load(&m->m21), r);
+    r = lx_simd4_madd(lx_simd4_splat(v->z), lx_simd4_load(&m->m31), r);
+
+    float result[4];
+    lx_simd4_store(result, r);
+    out->x = result[0];
+    out->y = result[1];
+    out->z = result[2];
 }
 
 /*
@@ -309,47 +341,32 @@ static LX_INLINE float lx_vec4_at(const lx_vec4_t *v, size_t i)
 
 static LX_INLINE void lx_vec4_add(const lx_vec4_t *a, const lx_vec4_t *b, lx_vec4_t *out)
 {
-    out->x = a->x + b->x;
-    out->y = a->y + b->y;
-    out->z = a->z + b->z;
-    out->w = a->w + b->w;
+    lx_simd4_store(&out->x, lx_simd4_add(lx_simd4_load(&a->x), lx_simd4_load(&b->x)));
 }
 
 static LX_INLINE void lx_vec4_sub(const lx_vec4_t *a, const lx_vec4_t *b, lx_vec4_t *out)
 {
-    out->x = a->x - b->x;
-    out->y = a->y - b->y;
-    out->z = a->z - b->z;
-    out->w = a->w - b->w;
+    lx_simd4_store(&out->x, lx_simd4_sub(lx_simd4_load(&a->x), lx_simd4_load(&b->x)));
 }
 
 static LX_INLINE void lx_vec4_mul(const lx_vec4_t *a, const lx_vec4_t *b, lx_vec4_t *out)
 {
-    out->x = a->x * b->x;
-    out->y = a->y * b->y;
-    out->z = a->z * b->z;
-    out->w = a->w * b->w;
+    lx_simd4_store(&out->x, lx_simd4_mul(lx_simd4_load(&a->x), lx_simd4_load(&b->x)));
 }
 
 static LX_INLINE void lx_vec4_div(const lx_vec4_t *a, const lx_vec4_t *b, lx_vec4_t *out)
 {
-    out->x = a->x / b->x;
-    out->y = a->y / b->y;
-    out->z = a->z / b->z;
-    out->w = a->w / b->w;
+    lx_simd4_store(&out->x, lx_simd4_div(lx_simd4_load(&a->x), lx_simd4_load(&b->x)));
 }
 
 static LX_INLINE void lx_vec4_scale(const lx_vec4_t *a, float s, lx_vec4_t *out)
 {
-    out->x = a->x * s;
-    out->y = a->y * s;
-    out->z = a->z * s;
-    out->w = a->w * s;
+    lx_simd4_store(&out->x, lx_simd4_mul(lx_simd4_load(&a->x), lx_simd4_splat(s)));
 }
 
 static LX_INLINE float lx_vec4_dot(const lx_vec4_t *a, const lx_vec4_t *b)
 {
-    return a->x * b->x + a->y * b->y + a->z * b->z + a->w * b->w;
+    return lx_simd4_sum(lx_simd4_mul(lx_simd4_load(&a->x), lx_simd4_load(&b->x)));
 }
 
 static LX_INLINE void lx_vec4_cross(const lx_vec4_t *a, const lx_vec4_t *b, lx_vec4_t *out)
@@ -374,14 +391,23 @@ static LX_INLINE void lx_vec4_normalize(const lx_vec4_t *v, lx_vec4_t *out)
 {
     float length = lx_vec4_squared_length(v);
     if (length > 0.0f) {
-        float s = 1.0f / lx_sqrtf(length);
-        out->x = v->x * s;
-        out->y = v->y * s;
-        out->z = v->z * s;
-        out->w = v->w * s;
+        lx_vec4_scale(v, 1.0f / lx_sqrtf(length), out);
     }
 }
 
+/*
+ * Row vector times matrix, like lx_vec3_transform_4x4 with w taken from the vector.
+ */
+static LX_INLINE void lx_vec4_transform(const lx_vec4_t *v, const lx_mat4_t *m, lx_vec4_t *out)
+{
+    const lx_simd4_t row = lx_simd4_load(&v->x);
+    lx_simd4_t r = lx_simd4_mul(lx_simd4_splat_x(row), lx_simd4_load(&m->m11));
+    r = lx_simd4_madd(lx_simd4_splat_y(row), lx_simd4_load(&m->m21), r);
+    r = lx_simd4_madd(lx_simd4_splat_z(row), lx_simd4_load(&m->m31), r);
+    r = lx_simd4_madd(lx_simd4_splat_w(row), lx_simd4_load(&m->m41), r);
+    lx_simd4_store(&out->x, r);
+}
+
 /*
  * 4-D Matrix
  */
@@ -399,55 +425,71 @@ static LX_INLINE void lx_mat4_identity(lx_mat4_t *m)
 
 static LX_INLINE void lx_mat4_add(const lx_mat4_t *a, const lx_mat4_t *b, lx_mat4_t *out)
 {
-    out->m11 = a->m11 + b->m11; out->m12 = a->m12 + b->m13; out->m13 = a->m13 + b->m13; out->m14 = a->m14 + b->m14;
-    out->m21 = a->m21 + b->m21; out->m22 = a->m22 + b->m23; out->m23 = a->m23 + b->m23; out->m24 = a->m24 + b->m24;
-    out->m31 = a->m31 + b->m31; out->m32 = a->m32 + b->m33; out->m33 = a->m33 + b->m33; out->m34 = a->m34 + b->m34;
-    out->m41 = a->m41 + b->m41; out->m42 = a->m42 + b->m43; out->m43 = a->m43 + b->m43; out->m44 = a->m44 + b->m44;
+    for (size_t i = 0; i < 16; i += 4)
+        lx_simd4_store(&out->m[i], lx_simd4_add(lx_simd4_load(&a->m[i]), lx_simd4_load(&b->m[i])));
 }
 
 static LX_INLINE void lx_mat4_sub(const lx_mat4_t *a, const lx_mat4_t *b, lx_mat4_t *out)
 {
-    out->m11 = a->m11 - b->m11; out->m12 = a->m12 - b->m13; out->m13 = a->m13 - b->m13; out->m14 = a->m14 - b->m14;
-    out->m21 = a->m21 - b->m21; out->m22 = a->m22 - b->m23; out->m23 = a->m23 - b->m23; out->m24 = a->m24 - b->m24;
-    out->m31 = a->m31 - b->m31; out->m32 = a->m32 - b->m33; out->m33 = a->m33 - b->m33; out->m34 = a->m34 - b->m34;
-    out->m41 = a->m41 - b->m41; out->m42 = a->m42 - b->m43; out->m43 = a->m43 - b->m43; out->m44 = a->m44 - b->m44;
+    for (size_t i = 0; i < 16; i += 4)
+        lx_simd4_store(&out->m[i], lx_simd4_sub(lx_simd4_load(&a->m[i]), lx_simd4_load(&b->m[i])));
 }
 
+/*
+ * Every row of the result is the row of a times b, the rows of b weighted by the elements of the row
+ * of a. With AVX two rows are computed at once. Out may be a or b.
+ */
 static LX_INLINE void lx_mat4_mul(const lx_mat4_t *a, const lx_mat4_t *b, lx_mat4_t *out)
 {
-    out->m11 = a->m11 * b->m11 + a->m12 * b->m21 + a->m13 * b->m31 + a->m14 * b->m41;
-    out->m12 = a->m11 * b->m12 + a->m12 * b->m22 + a->m13 * b->m32 + a->m14 * b->m42;
-    out->m13 = a->m11 * b->m13 + a->m12 * b->m23 + a->m13 * b->m33 + a->m14 * b->m43;
-    out->m14 = a->m11 * b->m14 + a->m12 * b->m24 + a->m13 * b->m34 + a->m14 * b->m44;
-
-    out->m21 = a->m21 * b->m11 + a->m22 * b->m21 + a->m23 * b->m31 + a->m24 * b->m41;
-    out->m22 = a->m21 * b->m12 + a->m22 * b->m22 + a->m23 * b->m32 + a->m24 * b->m42;
-    out->m23 = a->m21 * b->m13 + a->m22 * b->m23 + a->m23 * b->m33 + a->m24 * b->m43;
-    out->m24 = a->m21 * b->m14 + a->m22 * b->m24 + a->m23 * b->m34 + a->m24 * b->m44;
-
-    out->m31 = a->m31 * b->m11 + a->m32 * b->m21 + a->m33 * b->m31 + a->m34 * b->m41;
-    out->m32 = a->m31 * b->m12 + a->m32 * b->m22 + a->m33 * b->m32 + a->m34 * b->m42;
-    out->m33 = a->m31 * b->m13 + a->m32 * b->m23 + a->m33 * b->m33 + a->m34 * b->m43;
-    out->m34 = a->m31 * b->m14 + a->m32 * b->m24 + a->m33 * b->m34 + a->m34 * b->m44;
-
-    out->m41 = a->m41 * b->m11 + a->m42 * b->m21 + a->m43 * b->m31 + a->m44 * b->m41;
-    out->m42 = a->m41 * b->m12 + a->m42 * b->m22 + a->m43 * b->m32 + a->m44 * b->m42;
-    out->m43 = a->m41 * b->m13 + a->m42 * b->m23 + a->m43 * b->m33 + a->m44 * b->m43;
-    out->m44 = a->m41 * b->m14 + a->m42 * b->m24 + a->m43 * b->m34 + a->m44 * b->m44;
+#if defined(LX_MATH_SIMD_AVX)
+    const __m256 b0 = _mm256_broadcast_ps((const __m128 *)&b->m11);
+    const __m256 b1 = _mm256_broadcast_ps((const __m128 *)&b->m21);
+    const __m256 b2 = _mm256_broadcast_ps((const __m128 *)&b->m31);
+    const __m256 b3 = _mm256_broadcast_ps((const __m128 *)&b->m41);
+
+    for (size_t i = 0; i < 16; i += 8) {
+        const __m256 rows = _mm256_loadu_ps(&a->m[i]);
+        __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+        _mm256_storeu_ps(&out->m[i], r);
+    }
+#else
+    const lx_simd4_t b0 = lx_simd4_load(&b->m11);
+    const lx_simd4_t b1 = lx_simd4_load(&b->m21);
+    const lx_simd4_t b2 = lx_simd4_load(&b->m31);
+    const lx_simd4_t b3 = lx_simd4_load(&b->m41);
+
+    for (size_t i = 0; i < 16; i += 4) {
+        const lx_simd4_t row = lx_simd4_load(&a->m[i]);
+        lx_simd4_t r = lx_simd4_mul(lx_simd4_splat_x(row), b0);
+        r = lx_simd4_madd(lx_simd4_splat_y(row), b1, r);
+        r = lx_simd4_madd(lx_simd4_splat_z(row), b2, r);
+        r = lx_simd4_madd(lx_simd4_splat_w(row), b3, r);
+        lx_simd4_store(&out->m[i], r);
+    }
+#endif
 }
 
 static LX_INLINE void lx_mat4_scale(const lx_mat4_t *m, float s, lx_mat4_t *out)
 {
-    for (size_t i = 0; i < 16; ++i)
-        out->m[i] = m->m[i] * s;
+    const lx_simd4_t scale = lx_simd4_splat(s);
+    for (size_t i = 0; i < 16; i += 4)
+        lx_simd4_store(&out->m[i], lx_simd4_mul(lx_simd4_load(&m->m[i]), scale));
 }
 
 static LX_INLINE void lx_mat4_transpose(const lx_mat4_t *m, lx_mat4_t *out)
 {
-    out->m11 = m->m11; out->m12 = m->m21; out->m13 = m->m31; out->m14 = m->m41;
-    out->m21 = m->m12; out->m22 = m->m22; out->m23 = m->m32; out->m24 = m->m42;
-    out->m31 = m->m13; out->m32 = m->m23; out->m33 = m->m33; out->m34 = m->m43;
-    out->m41 = m->m14; out->m42 = m->m24; out->m43 = m->m34; out->m44 = m->m44;
+    lx_simd4_t r0 = lx_simd4_load(&m->m11);
+    lx_simd4_t r1 = lx_simd4_load(&m->m21);
+    lx_simd4_t r2 = lx_simd4_load(&m->m31);
+    lx_simd4_t r3 = lx_simd4_load(&m->m41);
+    lx_simd4_transpose(&r0, &r1, &r2, &r3);
+    lx_simd4_store(&out->m11, r0);
+    lx_simd4_store(&out->m21, r1);
+    lx_simd4_store(&out->m31, r2);
+    lx_simd4_store(&out->m41, r3);
 }
 
 static LX_INLINE float lx_mat4_det(const lx_mat4_t *m)
@@ -509,6 +551,130 @@ static LX_INLINE bool lx_mat4_inv3(const lx_mat4_t *m, lx_mat4_t *out)
     return true;
 }
 
+/*
+ * Inverse by Cramer's rule, the cofactors are computed four at a time from products of pairs of
+ * rows of the transpose. Returns false and leaves out untouched if the matrix is singular.
+ */
+static LX_INLINE bool lx_mat4_inv(const lx_mat4_t *m, lx_mat4_t *out)
+{
+    lx_simd4_t row0 = lx_simd4_load(&m->m11);
+    lx_simd4_t row1 = lx_simd4_load(&m->m21);
+    lx_simd4_t row2 = lx_simd4_load(&m->m31);
+    lx_simd4_t row3 = lx_simd4_load(&m->m41);
+    lx_simd4_transpose(&row0, &row1, &row2, &row3);
+    row1 = lx_simd4_swap_halves(row1);
+    row3 = lx_simd4_swap_halves(row3);
+
+    lx_simd4_t minor0, minor1, minor2, minor3, t;
+
+    t = lx_simd4_swap_pairs(lx_simd4_mul(row2, row3));
+    minor0 = lx_simd4_mul(row1, t);
+    minor1 = lx_simd4_mul(row0, t);
+    t = lx_simd4_swap_halves(t);
+    minor0 = lx_simd4_sub(lx_simd4_mul(row1, t), minor0);
+    minor1 = lx_simd4_swap_halves(lx_simd4_sub(lx_simd4_mul(row0, t), minor1));
+
+    t = lx_simd4_swap_pairs(lx_simd4_mul(row1, row2));
+    minor0 = lx_simd4_madd(row3, t, minor0);
+    minor3 = lx_simd4_mul(row0, t);
+    t = lx_simd4_swap_halves(t);
+    minor0 = lx_simd4_sub(minor0, lx_simd4_mul(row3, t));
+    minor3 = lx_simd4_swap_halves(lx_simd4_sub(lx_simd4_mul(row0, t), minor3));
+
+    t = lx_simd4_swap_pairs(lx_simd4_mul(lx_simd4_swap_halves(row1), row3));
+    row2 = lx_simd4_swap_halves(row2);
+    minor0 = lx_simd4_madd(row2, t, minor0);
+    minor2 = lx_simd4_mul(row0, t);
+    t = lx_simd4_swap_halves(t);
+    minor0 = lx_simd4_sub(minor0, lx_simd4_mul(row2, t));
+    minor2 = lx_simd4_swap_halves(lx_simd4_sub(lx_simd4_mul(row0, t), minor2));
+
+    t = lx_simd4_swap_pairs(lx_simd4_mul(row0, row1));
+    minor2 = lx_simd4_madd(row3, t, minor2);
+    minor3 = lx_simd4_sub(lx_simd4_mul(row2, t), minor3);
+    t = lx_simd4_swap_halves(t);
+    minor2 = lx_simd4_sub(lx_simd4_mul(row3, t), minor2);
+    minor3 = lx_simd4_sub(minor3, lx_simd4_mul(row2, t));
+
+    t = lx_simd4_swap_pairs(lx_simd4_mul(row0, row3));
+    minor1 = lx_simd4_sub(minor1, lx_simd4_mul(row2, t));
+    minor2 = lx_simd4_madd(row1, t, minor2);
+    t = lx_simd4_swap_halves(t);
+    minor1 = lx_simd4_madd(row2, t, minor1);
+    minor2 = lx_simd4_sub(minor2, lx_simd4_mul(row1, t));
+
+    t = lx_simd4_swap_pairs(lx_simd4_mul(row0, row2));
+    minor1 = lx_simd4_madd(row3, t, minor1);
+    minor3 = lx_simd4_sub(minor3, lx_simd4_mul(row1, t));
+    t = lx_simd4_swap_halves(t);
+    minor1 = lx_simd4_sub(minor1, lx_simd4_mul(row3, t));
+    minor3 = lx_simd4_madd(row1, t, minor3);
+
+    const float det = lx_simd4_sum(lx_simd4_mul(row0, minor0));
+    if (fabsf(det) < LX_MAT_INVERSE_EPSILON) {
+        return false;
+    }
+
+    const lx_simd4_t one_over_det = lx_simd4_splat(1.0f / det);
+    lx_simd4_store(&out->m11, lx_simd4_mul(minor0, one_over_det));
+    lx_simd4_store(&out->m21, lx_simd4_mul(minor1, one_over_det));
+    lx_simd4_store(&out->m31, lx_simd4_mul(minor2, one_over_det));
+    lx_simd4_store(&out->m41, lx_simd4_mul(minor3, one_over_det));
+
+    return true;
+}
+
+/*
+ * Transform count points, out may be the same array as v.
+ */
+static LX_INLINE void lx_vec3_transform_4x4_batch(const lx_vec3_t *v, size_t count, const lx_mat4_t *m, lx_vec3_t *out)
+{
+    const lx_simd4_t m1 = lx_simd4_load(&m->m11);
+    const lx_simd4_t m2 = lx_simd4_load(&m->m21);
+    const lx_simd4_t m3 = lx_simd4_load(&m->m31);
+    const lx_simd4_t m4 = lx_simd4_load(&m->m41);
+
+    for (size_t i = 0; i < count; ++i) {
+        lx_simd4_t r = lx_simd4_madd(lx_simd4_splat(v[i].x), m1, m4);
+        r = lx_simd4_madd(lx_simd4_splat(v[i].y), m2, r);
+        r = lx_simd4_madd(lx_simd4_splat(v[i].z), m3, r);
+
+        float result[4];
+        lx_simd4_store(result, r);
+        out[i] = (lx_vec3_t) { result[0], result[1], result[2] };
+    }
+}
+
+/*
+ * Transform count vectors, out may be the same array as v.
+ */
+static LX_INLINE void lx_vec4_transform_batch(const lx_vec4_t *v, size_t count, const lx_mat4_t *m, lx_vec4_t *out)
+{
+    const lx_simd4_t m1 = lx_simd4_load(&m->m11);
+    const lx_simd4_t m2 = lx_simd4_load(&m->m21);
+    const lx_simd4_t m3 = lx_simd4_load(&m->m31);
+    const lx_simd4_t m4 = lx_simd4_load(&m->m41);
+
+    for (size_t i = 0; i < count; ++i) {
+        const lx_simd4_t row = lx_simd4_load(&v[i].x);
+        lx_simd4_t r = lx_simd4_mul(lx_simd4_splat_x(row), m1);
+        r = lx_simd4_madd(lx_simd4_splat_y(row), m2, r);
+        r = lx_simd4_madd(lx_simd4_splat_z(row), m3, r);
+        r = lx_simd4_madd(lx_simd4_splat_w(row), m4, r);
+        lx_simd4_store(&out[i].x, r);
+    }
+}
+
+/*
+ * Multiply every matrix of a by b, like composing a set of local transforms with their parent's
+ * world transform. Out may be the same array as a.
+ */
+static LX_INLINE void lx_mat4_mul_batch(const lx_mat4_t *a, size_t count, const lx_mat4_t *b, lx_mat4_t *out)
+{
+    for (size_t i = 0; i < count; ++i)
+        lx_mat4_mul(&a[i], b, &out[i]);
+}
+
 static LX_INLINE float lx_mat4_trace(const lx_mat4_t *m)
 {
     return m->m11 + m->m22 + m->m33 + m->m44;
@@ -677,6 +843,207 @@ static LX_INLINE lx_mat4_t *lx_mat4_look_at(const lx_vec3_t* target, const lx_ve
     return lx_mat4_look_to(lx_vec3_sub(target, position, &dir), position, up, out);
 }
 
+/*
+ * Bounds.
+ */
+static LX_INLINE void lx_aabb_empty(lx_aabb_t *out)
+{
+	out->min = (lx_vec3_t) { FLT_MAX, FLT_MAX, FLT_MAX };
+	out->max = (lx_vec3_t) { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+}
+
+static LX_INLINE bool lx_aabb_is_empty(const lx_aabb_t *a)
+{
+	return a->min.x > a->max.x || a->min.y > a->max.y || a->min.z > a->max.z;
+}
+
+static LX_INLINE void lx_aabb_add_point(const lx_aabb_t *a, const lx_vec3_t *p, lx_aabb_t *out)
+{
+	out->min.x = fminf(a->min.x, p->x);
+	out->min.y = fminf(a->min.y, p->y);
+	out->min.z = fminf(a->min.z, p->z);
+	out->max.x = fmaxf(a->max.x, p->x);
+	out->max.y = fmaxf(a->max.y, p->y);
+	out->max.z = fmaxf(a->max.z, p->z);
+}
+
+static LX_INLINE void lx_aabb_merge(const lx_aabb_t *a, const lx_aabb_t *b, lx_aabb_t *out)
+{
+	out->min.x = fminf(a->min.x, b->min.x);
+	out->min.y = fminf(a->min.y, b->min.y);
+	out->min.z = fminf(a->min.z, b->min.z);
+	out->max.x = fmaxf(a->max.x, b->max.x);
+	out->max.y = fmaxf(a->max.y, b->max.y);
+	out->max.z = fmaxf(a->max.z, b->max.z);
+}
+
+static LX_INLINE void lx_aabb_center(const lx_aabb_t *a, lx_vec3_t *out)
+{
+	out->x = (a->min.x + a->max.x) * 0.5f;
+	out->y = (a->min.y + a->max.y) * 0.5f;
+	out->z = (a->min.z + a->max.z) * 0.5f;
+}
+
+/*
+ * Center and half size of the box. Empty boxes get a zero center and extents of -FLT_MAX, which puts
+ * them behind every plane.
+ */
+static LX_INLINE void lx_aabb_center_extent(const lx_aabb_t *a, lx_vec3_t *center, lx_vec3_t *extent)
+{
+	if (lx_aabb_is_empty(a)) {
+		*center = (lx_vec3_t) { 0.0f, 0.0f, 0.0f };
+		*extent = (lx_vec3_t) { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		return;
+	}
+
+	lx_aabb_center(a, center);
+	extent->x = (a->max.x - a->min.x) * 0.5f;
+	extent->y = (a->max.y - a->min.y) * 0.5f;
+	extent->z = (a->max.z - a->min.z) * 0.5f;
+}
+
+/*
+ * Surface area, 0 for empty boxes.
+ */
+static LX_INLINE float lx_aabb_area(const lx_aabb_t *a)
+{
+	if (lx_aabb_is_empty(a))
+		return 0.0f;
+
+	const float dx = a->max.x - a->min.x;
+	const float dy = a->max.y - a->min.y;
+	const float dz = a->max.z - a->min.z;
+	return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+static LX_INLINE bool lx_aabb_intersects(const lx_aabb_t *a, const lx_aabb_t *b)
+{
+	return a->min.x <= b->max.x && a->max.x >= b->min.x &&
+		a->min.y <= b->max.y && a->max.y >= b->min.y &&
+		a->min.z <= b->max.z && a->max.z >= b->min.z;
+}
+
+static LX_INLINE bool lx_aabb_contains_point(const lx_aabb_t *a, const lx_vec3_t *p)
+{
+	return p->x >= a->min.x && p->x <= a->max.x &&
+		p->y >= a->min.y && p->y <= a->max.y &&
+		p->z >= a->min.z && p->z <= a->max.z;
+}
+
+/*
+ * Box around the transformed box. Each axis of the matrix moves the box along that axis by the
+ * smallest and largest of its scaled extents, which avoids transforming all eight corners.
+ */
+static LX_INLINE void lx_aabb_transform(const lx_aabb_t *a, const lx_mat4_t *m, lx_aabb_t *out)
+{
+	if (lx_aabb_is_empty(a)) {
+		lx_aabb_empty(out);
+		return;
+	}
+
+	const float *min = &a->min.x;
+	const float *max = &a->max.x;
+	float result_min[3] = { m->m41, m->m42, m->m43 };
+	float result_max[3] = { m->m41, m->m42, m->m43 };
+
+	for (size_t row = 0; row < 3; ++row) {
+		for (size_t column = 0; column < 3; ++column) {
+			const float e = m->m[row * 4 + column] * min[row];
+			const float f = m->m[row * 4 + column] * max[row];
+			result_min[column] += fminf(e, f);
+			result_max[column] += fmaxf(e, f);
+		}
+	}
+
+	out->min = (lx_vec3_t) { result_min[0], result_min[1], result_min[2] };
+	out->max = (lx_vec3_t) { result_max[0], result_max[1], result_max[2] };
+}
+
+/*
+ * Distance along the ray to where it enters the box, 0 if the origin is inside the box. Returns
+ * false if the ray misses the box or only hits it further away than max_distance.
+ */
+static LX_INLINE bool lx_aabb_intersect_ray(const lx_aabb_t *a, const lx_ray_t *ray, const lx_vec3_t *inv_direction, float max_distance, float *distance)
+{
+	const float tx1 = (a->min.x - ray->origin.x) * inv_direction->x;
+	const float tx2 = (a->max.x - ray->origin.x) * inv_direction->x;
+	const float ty1 = (a->min.y - ray->origin.y) * inv_direction->y;
+	const float ty2 = (a->max.y - ray->origin.y) * inv_direction->y;
+	const float tz1 = (a->min.z - ray->origin.z) * inv_direction->z;
+	const float tz2 = (a->max.z - ray->origin.z) * inv_direction->z;
+
+	const float t_enter = fmaxf(fmaxf(fminf(tx1, tx2), fminf(ty1, ty2)), fmaxf(fminf(tz1, tz2), 0.0f));
+	const float t_exit = fminf(fminf(fmaxf(tx1, tx2), fmaxf(ty1, ty2)), fminf(fmaxf(tz1, tz2), max_distance));
+	if (t_enter > t_exit)
+		return false;
+
+	*distance = t_enter;
+	return true;
+}
+
+/*
+ * Sphere around the box, not the tightest sphere around the points it was built from.
+ */
+static LX_INLINE void lx_sphere_from_aabb(const lx_aabb_t *a, lx_sphere_t *out)
+{
+	if (lx_aabb_is_empty(a)) {
+		*out = (lx_sphere_t) { 0 };
+		return;
+	}
+
+	lx_aabb_center(a, &out->center);
+	out->radius = lx_vec3_distance(&out->center, &a->max);
+}
+
+/*
+ * Frustum of a view projection matrix with row vectors and depth from 0 to 1, as made by
+ * lx_mat4_perspective_fov. The planes are normalized and ordered left, right, bottom, top, near, far.
+ */
+static LX_INLINE void lx_frustum_from_view_projection(const lx_mat4_t *m, lx_frustum_t *out)
+{
+	const lx_vec4_t x = { m->m11, m->m21, m->m31, m->m41 };
+	const lx_vec4_t y = { m->m12, m->m22, m->m32, m->m42 };
+	const lx_vec4_t z = { m->m13, m->m23, m->m33, m->m43 };
+	const lx_vec4_t w = { m->m14, m->m24, m->m34, m->m44 };
+
+	lx_vec4_add(&w, &x, &out->planes[0]);
+	lx_vec4_sub(&w, &x, &out->planes[1]);
+	lx_vec4_add(&w, &y, &out->planes[2]);
+	lx_vec4_sub(&w, &y, &out->planes[3]);
+	out->planes[4] = z;
+	lx_vec4_sub(&w, &z, &out->planes[5]);
+
+	for (size_t i = 0; i < 6; ++i) {
+		lx_vec4_t *plane = &out->planes[i];
+		const float length = lx_sqrtf(plane->x * plane->x + plane->y * plane->y + plane->z * plane->z);
+		if (length > 0.0f)
+			lx_vec4_scale(plane, 1.0f / length, plane);
+	}
+}
+
+/*
+ * False when the box is entirely behind one of the planes. Boxes that straddle two planes outside
+ * a corner of the frustum are kept, the test errs on the side of drawing. Empty boxes are culled.
+ */
+static LX_INLINE bool lx_frustum_intersects_aabb(const lx_frustum_t *frustum, const lx_aabb_t *a)
+{
+	if (lx_aabb_is_empty(a))
+		return false;
+
+	for (size_t i = 0; i < 6; ++i) {
+		const lx_vec4_t *plane = &frustum->planes[i];
+
+		// Corner of the box furthest along the plane normal
+		const float x = plane->x >= 0.0f ? a->max.x : a->min.x;
+		const float y = plane->y >= 0.0f ? a->max.y : a->min.y;
+		const float z = plane->z >= 0.0f ? a->max.z : a->min.z;
+		if (plane->x * x + plane->y * y + plane->z * z + plane->w < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
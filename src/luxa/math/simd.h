@@ -0,0 +1,186 @@
+#pragma once
+
+#include <luxa/platform.h>
+
+/*
+ * Four float lanes on SSE or NEON, or a plain struct of four floats when neither is available or
+ * LX_MATH_SCALAR is defined before including. The math kernels are written once against these
+ * functions. Loads and stores don't require 16 byte alignment.
+ */
+#if defined(LX_MATH_SCALAR)
+#define LX_MATH_SIMD_SCALAR 1
+#elif defined(LX_SIMD_SSE)
+#define LX_MATH_SIMD_SSE 1
+#include <xmmintrin.h>
+#if defined(LX_SIMD_AVX)
+#define LX_MATH_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+#elif defined(LX_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define LX_MATH_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define LX_MATH_SIMD_SCALAR 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(LX_MATH_SIMD_SSE)
+
+typedef __m128 lx_simd4_t;
+
+static LX_INLINE lx_simd4_t lx_simd4_load(const float *p) { return _mm_loadu_ps(p); }
+
+static LX_INLINE void lx_simd4_store(float *p, lx_simd4_t v) { _mm_storeu_ps(p, v); }
+
+static LX_INLINE lx_simd4_t lx_simd4_set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat(float s) { return _mm_set1_ps(s); }
+
+static LX_INLINE lx_simd4_t lx_simd4_add(lx_simd4_t a, lx_simd4_t b) { return _mm_add_ps(a, b); }
+
+static LX_INLINE lx_simd4_t lx_simd4_sub(lx_simd4_t a, lx_simd4_t b) { return _mm_sub_ps(a, b); }
+
+static LX_INLINE lx_simd4_t lx_simd4_mul(lx_simd4_t a, lx_simd4_t b) { return _mm_mul_ps(a, b); }
+
+static LX_INLINE lx_simd4_t lx_simd4_div(lx_simd4_t a, lx_simd4_t b) { return _mm_div_ps(a, b); }
+
+// a * b + c
+static LX_INLINE lx_simd4_t lx_simd4_madd(lx_simd4_t a, lx_simd4_t b, lx_simd4_t c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_x(lx_simd4_t v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_y(lx_simd4_t v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_z(lx_simd4_t v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_w(lx_simd4_t v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+
+// (y, x, w, z)
+static LX_INLINE lx_simd4_t lx_simd4_swap_pairs(lx_simd4_t v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+
+// (z, w, x, y)
+static LX_INLINE lx_simd4_t lx_simd4_swap_halves(lx_simd4_t v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
+
+static LX_INLINE float lx_simd4_sum(lx_simd4_t v)
+{
+	v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(v);
+}
+
+static LX_INLINE void lx_simd4_transpose(lx_simd4_t *r0, lx_simd4_t *r1, lx_simd4_t *r2, lx_simd4_t *r3)
+{
+	_MM_TRANSPOSE4_PS(*r0, *r1, *r2, *r3);
+}
+
+#elif defined(LX_MATH_SIMD_NEON)
+
+typedef float32x4_t lx_simd4_t;
+
+static LX_INLINE lx_simd4_t lx_simd4_load(const float *p) { return vld1q_f32(p); }
+
+static LX_INLINE void lx_simd4_store(float *p, lx_simd4_t v) { vst1q_f32(p, v); }
+
+static LX_INLINE lx_simd4_t lx_simd4_set(float x, float y, float z, float w)
+{
+	const float v[4] = { x, y, z, w };
+	return vld1q_f32(v);
+}
+
+static LX_INLINE lx_simd4_t lx_simd4_splat(float s) { return vdupq_n_f32(s); }
+
+static LX_INLINE lx_simd4_t lx_simd4_add(lx_simd4_t a, lx_simd4_t b) { return vaddq_f32(a, b); }
+
+static LX_INLINE lx_simd4_t lx_simd4_sub(lx_simd4_t a, lx_simd4_t b) { return vsubq_f32(a, b); }
+
+static LX_INLINE lx_simd4_t lx_simd4_mul(lx_simd4_t a, lx_simd4_t b) { return vmulq_f32(a, b); }
+
+static LX_INLINE lx_simd4_t lx_simd4_div(lx_simd4_t a, lx_simd4_t b) { return vdivq_f32(a, b); }
+
+// a * b + c
+static LX_INLINE lx_simd4_t lx_simd4_madd(lx_simd4_t a, lx_simd4_t b, lx_simd4_t c) { return vfmaq_f32(c, a, b); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_x(lx_simd4_t v) { return vdupq_laneq_f32(v, 0); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_y(lx_simd4_t v) { return vdupq_laneq_f32(v, 1); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_z(lx_simd4_t v) { return vdupq_laneq_f32(v, 2); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_w(lx_simd4_t v) { return vdupq_laneq_f32(v, 3); }
+
+// (y, x, w, z)
+static LX_INLINE lx_simd4_t lx_simd4_swap_pairs(lx_simd4_t v) { return vrev64q_f32(v); }
+
+// (z, w, x, y)
+static LX_INLINE lx_simd4_t lx_simd4_swap_halves(lx_simd4_t v) { return vextq_f32(v, v, 2); }
+
+static LX_INLINE float lx_simd4_sum(lx_simd4_t v) { return vaddvq_f32(v); }
+
+static LX_INLINE void lx_simd4_transpose(lx_simd4_t *r0, lx_simd4_t *r1, lx_simd4_t *r2, lx_simd4_t *r3)
+{
+	const float32x4x2_t t01 = vtrnq_f32(*r0, *r1);
+	const float32x4x2_t t23 = vtrnq_f32(*r2, *r3);
+	*r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+	*r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+	*r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+	*r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+#else
+
+typedef struct lx_simd4 {
+	float v[4];
+} lx_simd4_t;
+
+static LX_INLINE lx_simd4_t lx_simd4_load(const float *p) { return (lx_simd4_t) { { p[0], p[1], p[2], p[3] } }; }
+
+static LX_INLINE void lx_simd4_store(float *p, lx_simd4_t v) { p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2]; p[3] = v.v[3]; }
+
+static LX_INLINE lx_simd4_t lx_simd4_set(float x, float y, float z, float w) { return (lx_simd4_t) { { x, y, z, w } }; }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat(float s) { return (lx_simd4_t) { { s, s, s, s } }; }
+
+static LX_INLINE lx_simd4_t lx_simd4_add(lx_simd4_t a, lx_simd4_t b) { return (lx_simd4_t) { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+
+static LX_INLINE lx_simd4_t lx_simd4_sub(lx_simd4_t a, lx_simd4_t b) { return (lx_simd4_t) { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+
+static LX_INLINE lx_simd4_t lx_simd4_mul(lx_simd4_t a, lx_simd4_t b) { return (lx_simd4_t) { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+
+static LX_INLINE lx_simd4_t lx_simd4_div(lx_simd4_t a, lx_simd4_t b) { return (lx_simd4_t) { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+
+// a * b + c
+static LX_INLINE lx_simd4_t lx_simd4_madd(lx_simd4_t a, lx_simd4_t b, lx_simd4_t c) { return lx_simd4_add(lx_simd4_mul(a, b), c); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_x(lx_simd4_t v) { return lx_simd4_splat(v.v[0]); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_y(lx_simd4_t v) { return lx_simd4_splat(v.v[1]); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_z(lx_simd4_t v) { return lx_simd4_splat(v.v[2]); }
+
+static LX_INLINE lx_simd4_t lx_simd4_splat_w(lx_simd4_t v) { return lx_simd4_splat(v.v[3]); }
+
+// (y, x, w, z)
+static LX_INLINE lx_simd4_t lx_simd4_swap_pairs(lx_simd4_t v) { return (lx_simd4_t) { { v.v[1], v.v[0], v.v[3], v.v[2] } }; }
+
+// (z, w, x, y)
+static LX_INLINE lx_simd4_t lx_simd4_swap_halves(lx_simd4_t v) { return (lx_simd4_t) { { v.v[2], v.v[3], v.v[0], v.v[1] } }; }
+
+static LX_INLINE float lx_simd4_sum(lx_simd4_t v) { return (v.v[0] + v.v[1]) + (v.v[2] + v.v[3]); }
+
+static LX_INLINE void lx_simd4_transpose(lx_simd4_t *r0, lx_simd4_t *r1, lx_simd4_t *r2, lx_simd4_t *r3)
+{
+	const lx_simd4_t a = *r0, b = *r1, c = *r2, d = *r3;
+	*r0 = (lx_simd4_t) { { a.v[0], b.v[0], c.v[0], d.v[0] } };
+	*r1 = (lx_simd4_t) { { a.v[1], b.v[1], c.v[1], d.v[1] } };
+	*r2 = (lx_simd4_t) { { a.v[2], b.v[2], c.v[2], d.v[2] } };
+	*r3 = (lx_simd4_t) { { a.v[3], b.v[3], c.v[3], d.v[3] } };
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,9 +1,14 @@
 #include <luxa/memory/allocator.h>
-#include <stdlib.h>
+#include <malloc.h>
 
-static void *default_realloc(lx_allocator_state_t *state, void *ptr, size_t size)
+static void *default_realloc(lx_allocator_state_t *state, void *ptr, size_t size, size_t alignment)
 {
-	return realloc(ptr, size);
+	if (!size) {
+		_aligned_free(ptr);
+		return NULL;
+	}
+
+	return _aligned_realloc(ptr, size, alignment);
 }
 
 lx_allocator_t* lx_allocator_default()
@@ -9,27 +9,47 @@ extern "C" {
 // Allocator state
 typedef struct lx_allocator_state lx_allocator_state_t;
 
-// Allocator interface
+/*
+ * Alignment of memory returned by lx_alloc and lx_realloc.
+ */
+#define LX_DEFAULT_ALIGNMENT 16
+
+/*
+ * Allocator interface. Realloc allocates when ptr is NULL and frees when size is zero. Alignment
+ * is a power of two and memory must be reallocated with the same alignment it was allocated with.
+ */
 typedef struct lx_allocator {
 	lx_allocator_state_t *state;
-	void *(*realloc)(lx_allocator_state_t *state, void *ptr, size_t size);
+	void *(*realloc)(lx_allocator_state_t *state, void *ptr, size_t size, size_t alignment);
 } lx_allocator_t;
 
 lx_allocator_t* lx_allocator_default();
 
 static inline void *lx_alloc(lx_allocator_t *allocator, size_t size)
 {
-	return allocator->realloc(allocator->state, NULL, size);
+	return allocator->realloc(allocator->state, NULL, size, LX_DEFAULT_ALIGNMENT);
+}
+
+static inline void *lx_alloc_aligned(lx_allocator_t *allocator, size_t size, size_t alignment)
+{
+	LX_ASSERT(lx_is_power_of_two(alignment), "Alignment must be a power of two");
+	return allocator->realloc(allocator->state, NULL, size, lx_max(alignment, LX_DEFAULT_ALIGNMENT));
 }
 
 static inline void *lx_realloc(lx_allocator_t *allocator, void *ptr, size_t size)
 {
-	return allocator->realloc(allocator->state, ptr, size);
+	return allocator->realloc(allocator->state, ptr, size, LX_DEFAULT_ALIGNMENT);
+}
+
+static inline void *lx_realloc_aligned(lx_allocator_t *allocator, void *ptr, size_t size, size_t alignment)
+{
+	LX_ASSERT(lx_is_power_of_two(alignment), "Alignment must be a power of two");
+	return allocator->realloc(allocator->state, ptr, size, lx_max(alignment, LX_DEFAULT_ALIGNMENT));
 }
 
 static inline void lx_free(lx_allocator_t *allocator, void *ptr)
 {
-	allocator->realloc(allocator->state, ptr, 0);
+	allocator->realloc(allocator->state, ptr, 0, 0);
 }
 
 #ifdef __cplusplus
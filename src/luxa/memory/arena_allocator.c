@@ -0,0 +1,190 @@
+#include <luxa/memory/arena_allocator.h>
+
+#define ARENA_ALIGNMENT 16
+
+typedef struct arena_block {
+	struct arena_block *next_block;
+	size_t capacity;
+} arena_block_t;
+
+typedef struct arena_header {
+	size_t size;
+	size_t offset; // Block offset before the allocation, including alignment padding
+} arena_header_t;
+
+typedef struct arena_allocator_state {
+	lx_allocator_t *allocator;
+	size_t block_size;
+	arena_block_t *blocks;
+	arena_block_t *current_block;
+	size_t offset;
+	void *last_allocation;
+} arena_allocator_state_t;
+
+static const size_t ARENA_BLOCK_HEADER_SIZE = lx_align_up(sizeof(arena_block_t), ARENA_ALIGNMENT);
+static const size_t ARENA_HEADER_SIZE = lx_align_up(sizeof(arena_header_t), ARENA_ALIGNMENT);
+
+static inline char *block_data(arena_block_t *block)
+{
+	return (char *)block + ARENA_BLOCK_HEADER_SIZE;
+}
+
+static inline arena_header_t *allocation_header(void *p)
+{
+	return (arena_header_t *)((char *)p - ARENA_HEADER_SIZE);
+}
+
+static arena_block_t *allocate_block(arena_allocator_state_t *state, size_t capacity)
+{
+	arena_block_t *block = lx_alloc(state->allocator, ARENA_BLOCK_HEADER_SIZE + capacity);
+	*block = (arena_block_t) { .next_block = NULL, .capacity = capacity };
+	return block;
+}
+
+static inline size_t allocation_end(arena_allocator_state_t *s, char *data, size_t size)
+{
+	return (size_t)(data - block_data(s->current_block)) + lx_align_up(size, ARENA_ALIGNMENT);
+}
+
+static inline char *aligned_data(arena_allocator_state_t *s, size_t alignment)
+{
+	return (char *)lx_align_up((uintptr_t)block_data(s->current_block) + s->offset + ARENA_HEADER_SIZE, alignment);
+}
+
+static void *arena_allocate(arena_allocator_state_t *s, size_t size, size_t alignment)
+{
+	// Block data is aligned to ARENA_ALIGNMENT so this is the most padding an allocation can need
+	const size_t bytes = ARENA_HEADER_SIZE + (alignment - ARENA_ALIGNMENT) + lx_align_up(size, ARENA_ALIGNMENT);
+
+	// Move on to the next block, reusing blocks left over from a rewind or reset
+	while (allocation_end(s, aligned_data(s, alignment), size) > s->current_block->capacity) {
+		arena_block_t *next_block = s->current_block->next_block;
+		if (!next_block || next_block->capacity < bytes) {
+			arena_block_t *block = allocate_block(s, lx_max(s->block_size, bytes));
+			block->next_block = next_block;
+			s->current_block->next_block = block;
+			next_block = block;
+		}
+
+		s->current_block = next_block;
+		s->offset = 0;
+	}
+
+	char *data = aligned_data(s, alignment);
+	arena_header_t *header = (arena_header_t *)(data - ARENA_HEADER_SIZE);
+	header->size = size;
+	header->offset = s->offset;
+	s->offset = allocation_end(s, data, size);
+
+	s->last_allocation = data;
+	return data;
+}
+
+static void *arena_realloc(lx_allocator_state_t *state, void *p, size_t size, size_t alignment)
+{
+	LX_ASSERT(state, "Invalid state");
+
+	arena_allocator_state_t *s = (arena_allocator_state_t *)state;
+
+	if (!p)
+		return size ? arena_allocate(s, size, alignment) : NULL;
+
+	const bool is_last_allocation = p == s->last_allocation;
+	arena_header_t *header = allocation_header(p);
+
+	if (!size) {
+		// Only the most recent allocation can be given back
+		if (is_last_allocation) {
+			s->offset = header->offset;
+			s->last_allocation = NULL;
+		}
+		return NULL;
+	}
+
+	// Grow or shrink the most recent allocation in place
+	if (is_last_allocation) {
+		const size_t end = allocation_end(s, p, size);
+		if (end <= s->current_block->capacity) {
+			header->size = size;
+			s->offset = end;
+			return p;
+		}
+	}
+
+	void *new_p = arena_allocate(s, size, alignment);
+	memcpy(new_p, p, lx_min(header->size, size));
+	return new_p;
+}
+
+lx_allocator_t *lx_arena_allocator_create(lx_allocator_t *allocator, size_t block_size)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+	LX_ASSERT(block_size, "Invalid block size");
+
+	arena_allocator_state_t *state = lx_alloc(allocator, sizeof(arena_allocator_state_t));
+
+	*state = (arena_allocator_state_t) {
+		.allocator = allocator,
+		.block_size = lx_align_up(block_size, ARENA_ALIGNMENT),
+		.blocks = NULL,
+		.current_block = NULL,
+		.offset = 0,
+		.last_allocation = NULL
+	};
+
+	state->blocks = allocate_block(state, state->block_size);
+	state->current_block = state->blocks;
+
+	lx_allocator_t *arena_allocator = lx_alloc(allocator, sizeof(lx_allocator_t));
+	*arena_allocator = (lx_allocator_t) { .state = (lx_allocator_state_t *)state, .realloc = arena_realloc };
+
+	return arena_allocator;
+}
+
+void lx_arena_allocator_destroy(lx_allocator_t *arena_allocator)
+{
+	LX_ASSERT(arena_allocator, "Invalid arena allocator");
+
+	arena_allocator_state_t *s = (arena_allocator_state_t *)arena_allocator->state;
+	lx_allocator_t *allocator = s->allocator;
+
+	arena_block_t *block = s->blocks;
+	while (block) {
+		arena_block_t *next_block = block->next_block;
+		lx_free(allocator, block);
+		block = next_block;
+	}
+
+	*s = (arena_allocator_state_t) { 0 };
+	lx_free(allocator, s);
+	lx_free(allocator, arena_allocator);
+}
+
+lx_arena_marker_t lx_arena_allocator_mark(lx_allocator_t *arena_allocator)
+{
+	LX_ASSERT(arena_allocator, "Invalid arena allocator");
+
+	arena_allocator_state_t *s = (arena_allocator_state_t *)arena_allocator->state;
+	return (lx_arena_marker_t) { .block = s->current_block, .offset = s->offset };
+}
+
+void lx_arena_allocator_rewind(lx_allocator_t *arena_allocator, lx_arena_marker_t marker)
+{
+	LX_ASSERT(arena_allocator, "Invalid arena allocator");
+	LX_ASSERT(marker.block, "Invalid arena marker");
+
+	arena_allocator_state_t *s = (arena_allocator_state_t *)arena_allocator->state;
+	s->current_block = marker.block;
+	s->offset = marker.offset;
+	s->last_allocation = NULL;
+}
+
+void lx_arena_allocator_reset(lx_allocator_t *arena_allocator)
+{
+	LX_ASSERT(arena_allocator, "Invalid arena allocator");
+
+	arena_allocator_state_t *s = (arena_allocator_state_t *)arena_allocator->state;
+	s->current_block = s->blocks;
+	s->offset = 0;
+	s->last_allocation = NULL;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Position in an arena allocator that can be rewound to.
+ */
+typedef struct lx_arena_marker {
+	lx_any_t block;
+	size_t offset;
+} lx_arena_marker_t;
+
+/*
+ * Creates a new instance of a non thread safe bump pointer (linear) allocator. Memory is
+ * reserved from the given allocator in blocks of block_size bytes. Freeing is a no-op except for
+ * the most recent allocation, memory is reclaimed by rewinding to a marker or resetting the arena.
+ */
+lx_allocator_t *lx_arena_allocator_create(lx_allocator_t *allocator, size_t block_size);
+
+/*
+ * Destroy arena allocator and release all blocks.
+ */
+void lx_arena_allocator_destroy(lx_allocator_t *arena_allocator);
+
+/*
+ * Returns the current position of the arena.
+ */
+lx_arena_marker_t lx_arena_allocator_mark(lx_allocator_t *arena_allocator);
+
+/*
+ * Release all allocations made after the marker was taken.
+ */
+void lx_arena_allocator_rewind(lx_allocator_t *arena_allocator, lx_arena_marker_t marker);
+
+/*
+ * Release all allocations, blocks are kept for reuse.
+ */
+void lx_arena_allocator_reset(lx_allocator_t *arena_allocator);
+
+#ifdef __cplusplus
+}
+#endif
@@ -12,6 +12,7 @@ typedef struct block {
 typedef struct block_allocator_state {
 	lx_allocator_t *allocator;
 	size_t chunk_size;
+	size_t chunk_stride;
 	size_t block_size;
 	chunk_t *free_chunks;
 	block_t *blocks;
@@ -25,34 +26,33 @@ void add_block_to_free_list(block_allocator_state_t *state, block_t *block)
 		chunk_t *chunk = (chunk_t *)p;
 		chunk->next_chunk = state->free_chunks;
 		state->free_chunks = chunk;
-		p += state->chunk_size + sizeof(chunk_t);
+		p += state->chunk_stride;
 	}
 }
 
 block_t *allocate_block(block_allocator_state_t *state)
 {
 	block_t *block = lx_alloc(state->allocator, sizeof(block_t));
-	block->buffer = lx_alloc(state->allocator, (sizeof(chunk_t) + state->chunk_size) * state->block_size);
+	block->buffer = lx_alloc_aligned(state->allocator, state->chunk_stride * state->block_size, LX_CACHE_LINE_SIZE);
 	return block;
 }
 
-static void *block_realloc(lx_allocator_state_t *state, void *p, size_t size)
+static void *block_realloc(lx_allocator_state_t *state, void *p, size_t size, size_t alignment)
 {
 	LX_ASSERT(state, "Invalid state");
-	LX_ASSERT(p == NULL, "Block allocator does not support realloc");
+	LX_ASSERT(p == NULL || size == 0, "Block allocator does not support realloc");
 	
 	block_allocator_state_t *s = (block_allocator_state_t *)state;
 	
 	if (!size) {
 		chunk_t *chunk = p;
-		LX_ASSERT(chunk->next_chunk == NULL, "Invalid memory chunk");
-
 		chunk->next_chunk = s->free_chunks;
 		s->free_chunks = chunk;
 		return NULL;
 	}
 
 	LX_ASSERT(size == s->chunk_size, "Requested memory size doesn't match chunk size");
+	LX_ASSERT(alignment <= LX_CACHE_LINE_SIZE && s->chunk_stride % alignment == 0, "Alignment not supported by block allocator");
 
 	if (!s->free_chunks) {
 		block_t *block = allocate_block(s);
@@ -65,7 +65,6 @@ static void *block_realloc(lx_allocator_state_t *state, void *p, size_t size)
 
 	chunk_t *chunk = s->free_chunks;
 	s->free_chunks = chunk->next_chunk;
-	chunk->next_chunk = NULL;
 
 	return chunk;
 }
@@ -79,6 +78,7 @@ lx_allocator_t *lx_block_allocator_create(lx_allocator_t *allocator, size_t chun
 	*state = (block_allocator_state_t) {
 		.allocator = allocator,
 		.chunk_size = chunk_size,
+		.chunk_stride = lx_align_up(lx_max(chunk_size, sizeof(chunk_t)), LX_DEFAULT_ALIGNMENT),
 		.block_size = block_size,
 		.free_chunks = NULL,
 		.blocks = NULL
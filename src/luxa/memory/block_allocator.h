@@ -4,7 +4,9 @@
 #include <luxa/memory/allocator.h>
 
 /*
- * Creates a new instance of a fixed size non thread safe block allocator.
+ * Creates a new instance of a fixed size non thread safe block allocator. Chunks are padded to
+ * LX_DEFAULT_ALIGNMENT and can be allocated with any alignment that divides the padded chunk size,
+ * up to LX_CACHE_LINE_SIZE.
  */
 lx_allocator_t *lx_block_allocator_create(lx_allocator_t *allocator, size_t chunk_size, size_t block_size);
 
@@ -0,0 +1,297 @@
+#include <luxa/memory/pool_allocator.h>
+#include <luxa/memory/virtual_memory.h>
+#include <luxa/threading/threading.h>
+
+#define POOL_SPAN_SIZE (64 * 1024)
+#define POOL_SPANS_PER_SUPERBLOCK 16
+#define POOL_MIN_CHUNK_SIZE 16
+#define POOL_NUM_SIZE_CLASSES 9
+
+typedef struct pool_cache pool_cache_t;
+
+typedef struct chunk {
+	struct chunk *next_chunk;
+} chunk_t;
+
+/*
+ * Spans are aligned to the span size so the owning span of any chunk is found by masking the
+ * chunk address, which means chunks don't need a header of their own.
+ */
+typedef struct span {
+	pool_cache_t *cache;
+	size_t size_class;
+	size_t size;
+	struct span *next_span;
+} span_t;
+
+/*
+ * Allocations larger than a chunk are forwarded to the backing allocator with this header right
+ * before the returned address. Chunks are told apart from large blocks by their address alone,
+ * all spans are carved out of one reserved range of address space.
+ */
+typedef struct large_block {
+	void *allocation;
+	size_t size;
+} large_block_t;
+
+typedef struct bin {
+	chunk_t *free_chunks;
+	char *next_chunk;
+	char *end;
+} bin_t;
+
+struct pool_cache {
+	volatile lx_any_t remote_free_chunks[POOL_NUM_SIZE_CLASSES]; // chunk_t
+	char padding[LX_CACHE_LINE_SIZE];
+	bin_t bins[POOL_NUM_SIZE_CLASSES];
+	pool_cache_t *next_cache;
+};
+
+typedef struct pool_allocator_state {
+	lx_allocator_t *allocator;
+	lx_thread_local_storage_t local_storage;
+	lx_mutex_t mutex;
+	char *reserved; // Start of the reserved range, aligned to the span size
+	char *spans_end; // End of the spans committed so far
+	char *reserved_end;
+	void *reservation;
+	span_t *free_spans;
+	pool_cache_t *caches;
+} pool_allocator_state_t;
+
+
+static inline span_t *chunk_span(void *p)
+{
+	return (span_t *)((uintptr_t)p & ~((uintptr_t)POOL_SPAN_SIZE - 1));
+}
+
+static inline bool is_chunk(const pool_allocator_state_t *s, const void *p)
+{
+	// Nothing else can be placed inside the reserved range, the spans committed so far don't matter
+	return (const char *)p >= s->reserved && (const char *)p < s->reserved_end;
+}
+
+static inline large_block_t *large_block(void *p)
+{
+	return (large_block_t *)p - 1;
+}
+
+static inline size_t size_class(size_t size)
+{
+	size_t c = 0;
+	while (((size_t)POOL_MIN_CHUNK_SIZE << c) < size)
+		++c;
+	return c;
+}
+
+static inline size_t chunk_size(size_t size_class)
+{
+	return (size_t)POOL_MIN_CHUNK_SIZE << size_class;
+}
+
+static pool_cache_t *local_cache(pool_allocator_state_t *s)
+{
+	pool_cache_t *cache = lx_thread_local_get_value(s->local_storage);
+	if (cache)
+		return cache;
+
+	cache = lx_alloc(s->allocator, sizeof(pool_cache_t));
+	*cache = (pool_cache_t) { 0 };
+
+	lx_mutex_scope(&s->mutex, {
+		cache->next_cache = s->caches;
+		s->caches = cache;
+	});
+
+	lx_thread_local_set_value(s->local_storage, cache);
+	return cache;
+}
+
+static span_t *acquire_span(pool_allocator_state_t *s)
+{
+	span_t *span = NULL;
+
+	lx_mutex_lock(&s->mutex);
+
+	// Commit the next superblock of spans, once the reserved range is used up there are no more
+	const size_t superblock_size = POOL_SPANS_PER_SUPERBLOCK * POOL_SPAN_SIZE;
+	if (!s->free_spans && (size_t)(s->reserved_end - s->spans_end) >= superblock_size
+		&& lx_virtual_memory_commit(s->spans_end, superblock_size) == LX_SUCCESS) {
+		for (size_t i = 0; i < POOL_SPANS_PER_SUPERBLOCK; ++i) {
+			span_t *free_span = (span_t *)s->spans_end;
+			free_span->next_span = s->free_spans;
+			s->free_spans = free_span;
+			s->spans_end += POOL_SPAN_SIZE;
+		}
+	}
+
+	span = s->free_spans;
+	if (span)
+		s->free_spans = span->next_span;
+
+	lx_mutex_unlock(&s->mutex);
+
+	return span;
+}
+
+static void *allocate_large(pool_allocator_state_t *s, size_t size, size_t alignment)
+{
+	const size_t header_size = lx_align_up(sizeof(large_block_t), alignment);
+	char *allocation = lx_alloc_aligned(s->allocator, header_size + size, alignment);
+
+	void *p = allocation + header_size;
+	*large_block(p) = (large_block_t) { .allocation = allocation, .size = size };
+
+	return p;
+}
+
+static void *allocate(pool_allocator_state_t *s, size_t size, size_t alignment)
+{
+	LX_ASSERT(alignment < POOL_SPAN_SIZE, "Alignment not supported by pool allocator");
+
+	// Chunks are aligned to their size, so alignment is a matter of picking a large enough class
+	if (lx_max(size, alignment) > LX_POOL_MAX_CHUNK_SIZE)
+		return allocate_large(s, size, alignment);
+
+	const size_t c = size_class(lx_max(size, alignment));
+	pool_cache_t *cache = local_cache(s);
+	bin_t *bin = &cache->bins[c];
+
+	// Reclaim chunks freed by other threads
+	if (!bin->free_chunks && cache->remote_free_chunks[c]) {
+		bin->free_chunks = lx_atomic_swap_ptr(&cache->remote_free_chunks[c], NULL);
+	}
+
+	if (bin->free_chunks) {
+		chunk_t *chunk = bin->free_chunks;
+		bin->free_chunks = chunk->next_chunk;
+		return chunk;
+	}
+
+	const size_t bytes = chunk_size(c);
+	if ((size_t)(bin->end - bin->next_chunk) < bytes) {
+		span_t *span = acquire_span(s);
+		if (!span)
+			return allocate_large(s, size, alignment);
+
+		const size_t header_size = lx_align_up(sizeof(span_t), bytes);
+		memset(span, 0, header_size);
+		*span = (span_t) { .cache = cache, .size_class = c, .size = bytes };
+
+		bin->next_chunk = (char *)span + header_size;
+		bin->end = (char *)span + POOL_SPAN_SIZE;
+	}
+
+	void *chunk = bin->next_chunk;
+	bin->next_chunk += bytes;
+	return chunk;
+}
+
+static void deallocate(pool_allocator_state_t *s, void *p)
+{
+	if (!is_chunk(s, p)) {
+		lx_free(s->allocator, large_block(p)->allocation);
+		return;
+	}
+
+	span_t *span = chunk_span(p);
+
+	chunk_t *chunk = p;
+	pool_cache_t *cache = lx_thread_local_get_value(s->local_storage);
+
+	if (cache == span->cache) {
+		bin_t *bin = &cache->bins[span->size_class];
+		chunk->next_chunk = bin->free_chunks;
+		bin->free_chunks = chunk;
+		return;
+	}
+
+	// Hand the chunk back to the owning thread
+	volatile lx_any_t *remote_free_chunks = &span->cache->remote_free_chunks[span->size_class];
+	lx_any_t head;
+	do {
+		head = *remote_free_chunks;
+		chunk->next_chunk = head;
+	} while (lx_atomic_exchange_ptr(remote_free_chunks, chunk, head) != head);
+}
+
+static void *pool_realloc(lx_allocator_state_t *state, void *p, size_t size, size_t alignment)
+{
+	LX_ASSERT(state, "Invalid state");
+
+	pool_allocator_state_t *s = (pool_allocator_state_t *)state;
+
+	if (!p)
+		return size ? allocate(s, size, alignment) : NULL;
+
+	if (!size) {
+		deallocate(s, p);
+		return NULL;
+	}
+
+	span_t *span = is_chunk(s, p) ? chunk_span(p) : NULL;
+	const size_t old_size = span ? span->size : large_block(p)->size;
+
+	if (span && size <= old_size && size_class(lx_max(size, alignment)) == span->size_class)
+		return p;
+
+	void *new_p = allocate(s, size, alignment);
+	memcpy(new_p, p, lx_min(old_size, size));
+	deallocate(s, p);
+
+	return new_p;
+}
+
+lx_allocator_t *lx_pool_allocator_create(lx_allocator_t *allocator)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+
+	pool_allocator_state_t *state = lx_alloc(allocator, sizeof(pool_allocator_state_t));
+
+	// Reserve one span more than needed so the range can be aligned to the span size
+	void *reservation = lx_virtual_memory_reserve(LX_POOL_RESERVED_SIZE + POOL_SPAN_SIZE);
+	LX_ASSERT(reservation, "Failed to reserve address space");
+	char *reserved = (char *)lx_align_up((uintptr_t)reservation, POOL_SPAN_SIZE);
+
+	*state = (pool_allocator_state_t) {
+		.allocator = allocator,
+		.local_storage = lx_thread_local_create_storage(),
+		.reserved = reserved,
+		.spans_end = reserved,
+		.reserved_end = reserved + LX_POOL_RESERVED_SIZE,
+		.reservation = reservation,
+		.free_spans = NULL,
+		.caches = NULL
+	};
+
+	lx_mutex_create(&state->mutex);
+
+	lx_allocator_t *pool_allocator = lx_alloc(allocator, sizeof(lx_allocator_t));
+	*pool_allocator = (lx_allocator_t) { .state = (lx_allocator_state_t *)state, .realloc = pool_realloc };
+
+	return pool_allocator;
+}
+
+void lx_pool_allocator_destroy(lx_allocator_t *pool_allocator)
+{
+	LX_ASSERT(pool_allocator, "Invalid pool allocator");
+
+	pool_allocator_state_t *s = (pool_allocator_state_t *)pool_allocator->state;
+	lx_allocator_t *allocator = s->allocator;
+
+	lx_virtual_memory_release(s->reservation, LX_POOL_RESERVED_SIZE + POOL_SPAN_SIZE);
+
+	pool_cache_t *cache = s->caches;
+	while (cache) {
+		pool_cache_t *next_cache = cache->next_cache;
+		lx_free(allocator, cache);
+		cache = next_cache;
+	}
+
+	lx_thread_local_destroy_storage(s->local_storage);
+	lx_mutex_destroy(&s->mutex);
+
+	*s = (pool_allocator_state_t) { 0 };
+	lx_free(allocator, s);
+	lx_free(allocator, pool_allocator);
+}
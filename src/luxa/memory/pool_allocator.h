@@ -0,0 +1,37 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Largest allocation served from the size class bins, bigger allocations are forwarded to the
+ * backing allocator.
+ */
+#define LX_POOL_MAX_CHUNK_SIZE 4096
+
+/*
+ * Address space reserved for the size class bins, memory is committed as it's needed. Once it is
+ * used up small allocations are forwarded to the backing allocator as well.
+ */
+#define LX_POOL_RESERVED_SIZE ((size_t)1024 * 1024 * 1024)
+
+/*
+ * Creates a new instance of a thread safe small object allocator. Allocations are rounded up to
+ * power of two size classes and served from per thread caches without taking any locks. Memory
+ * freed by another thread is handed back to the owning cache through a lock-free list. Memory is
+ * retained by the pool until it is destroyed.
+ */
+lx_allocator_t *lx_pool_allocator_create(lx_allocator_t *allocator);
+
+/*
+ * Destroy pool allocator and release all memory.
+ */
+void lx_pool_allocator_destroy(lx_allocator_t *pool_allocator);
+
+#ifdef __cplusplus
+}
+#endif
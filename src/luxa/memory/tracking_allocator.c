@@ -0,0 +1,429 @@
+#include <luxa/memory/tracking_allocator.h>
+#include <luxa/threading/threading.h>
+#include <luxa/log.h>
+
+#define LOG_TAG "Memory"
+#define UNTAGGED_TAG "Untagged"
+
+// Counters of all tags are kept after the counters of the tags
+#define TOTAL_INDEX LX_TRACKING_MAX_TAGS
+
+// Live bytes of a thread are added to the shared counter, and the peak, in batches of this size
+#define TRACKING_FLUSH_BYTES (64 * 1024)
+
+typedef struct tracking_state tracking_state_t;
+
+typedef struct allocation_header {
+	struct allocation_header *prev;
+	struct allocation_header *next;
+	size_t size;
+	size_t offset; // Offset from the underlying allocation to the data
+	uint32_t tag;
+	uint32_t sampled;
+} allocation_header_t;
+
+typedef struct tag {
+	lx_allocator_t allocator;
+	tracking_state_t *tracking;
+	uint32_t index;
+	char *name;
+} tag_t;
+
+/*
+ * Counters of one thread, only written by that thread and summed over all threads when read.
+ * Unflushed bytes are live bytes not yet added to the shared counter.
+ */
+typedef struct thread_counters {
+	int64_t live_bytes;
+	int64_t live_allocations;
+	int64_t num_allocations;
+	int64_t num_frees;
+	int64_t unflushed_bytes;
+	int64_t unflushed_peak;
+	int64_t histogram[LX_ALLOCATION_HISTOGRAM_SIZE];
+} thread_counters_t;
+
+typedef struct shard {
+	thread_counters_t counters[LX_TRACKING_MAX_TAGS + 1];
+	struct shard *next_shard;
+} shard_t;
+
+typedef struct shared_bytes {
+	volatile int64_t live_bytes;
+	volatile int64_t peak_bytes;
+} shared_bytes_t;
+
+struct tracking_state {
+	lx_allocator_t *allocator;
+	uint32_t sample_rate;
+	volatile int64_t sequence;
+	lx_thread_local_storage_t local_storage;
+	lx_mutex_t mutex;
+	allocation_header_t *sampled_allocations;
+	shard_t *shards;
+	shared_bytes_t shared[LX_TRACKING_MAX_TAGS + 1];
+	tag_t *tags[LX_TRACKING_MAX_TAGS];
+	uint32_t num_tags;
+};
+
+static const size_t HEADER_SIZE = (sizeof(allocation_header_t) + 15) & ~(size_t)15;
+
+static inline allocation_header_t *allocation_header(void *p)
+{
+	return (allocation_header_t *)((char *)p - HEADER_SIZE);
+}
+
+static inline void *allocation_data(allocation_header_t *header)
+{
+	return (char *)header + HEADER_SIZE;
+}
+
+static inline allocation_header_t *place_header(void *allocation, size_t offset)
+{
+	return allocation_header((char *)allocation + offset);
+}
+
+static inline size_t histogram_bucket(size_t size)
+{
+	size_t bucket = 0;
+	while (size >>= 1)
+		++bucket;
+	return lx_min(bucket, LX_ALLOCATION_HISTOGRAM_SIZE - 1);
+}
+
+static void update_peak(shared_bytes_t *shared, int64_t live_bytes)
+{
+	int64_t peak = lx_atomic_load_64(&shared->peak_bytes);
+	while (live_bytes > peak) {
+		int64_t current = lx_atomic_exchange_64(&shared->peak_bytes, live_bytes, peak);
+		if (current == peak)
+			break;
+		peak = current;
+	}
+}
+
+static shard_t *local_shard(tracking_state_t *t)
+{
+	shard_t *shard = lx_thread_local_get_value(t->local_storage);
+	if (shard)
+		return shard;
+
+	shard = lx_alloc(t->allocator, sizeof(shard_t));
+	memset(shard, 0, sizeof(shard_t));
+
+	lx_mutex_scope(&t->mutex, {
+		shard->next_shard = t->shards;
+		t->shards = shard;
+	});
+
+	lx_thread_local_set_value(t->local_storage, shard);
+	return shard;
+}
+
+// Only the owning thread writes its counters, the stores just have to be atomic for readers
+static inline void add_local(int64_t *counter, int64_t amount)
+{
+	lx_atomic_store_64(counter, *counter + amount);
+}
+
+/*
+ * The peak seen by a thread is the shared live bytes at its last flush plus the most it has
+ * allocated since, which is exact as long as a single thread allocates and an estimate otherwise.
+ */
+static void add_live_bytes(thread_counters_t *counters, shared_bytes_t *shared, int64_t amount)
+{
+	add_local(&counters->live_bytes, amount);
+
+	const int64_t unflushed = counters->unflushed_bytes + amount;
+	if (unflushed >= TRACKING_FLUSH_BYTES || unflushed <= -TRACKING_FLUSH_BYTES) {
+		const int64_t live_bytes = lx_atomic_add_64(&shared->live_bytes, unflushed);
+		update_peak(shared, live_bytes - unflushed + lx_max(counters->unflushed_peak, unflushed));
+		lx_atomic_store_64(&counters->unflushed_bytes, 0);
+		lx_atomic_store_64(&counters->unflushed_peak, 0);
+	} else {
+		lx_atomic_store_64(&counters->unflushed_bytes, unflushed);
+		lx_atomic_store_64(&counters->unflushed_peak, lx_max(counters->unflushed_peak, unflushed));
+	}
+}
+
+static void record_allocation(tracking_state_t *t, uint32_t index, size_t size)
+{
+	shard_t *shard = local_shard(t);
+	const uint32_t indices[] = { index, TOTAL_INDEX };
+
+	for (size_t i = 0; i < 2; ++i) {
+		thread_counters_t *counters = &shard->counters[indices[i]];
+		add_live_bytes(counters, &t->shared[indices[i]], (int64_t)size);
+		add_local(&counters->live_allocations, 1);
+		add_local(&counters->num_allocations, 1);
+		add_local(&counters->histogram[histogram_bucket(size)], 1);
+	}
+}
+
+static void record_free(tracking_state_t *t, uint32_t index, size_t size)
+{
+	shard_t *shard = local_shard(t);
+	const uint32_t indices[] = { index, TOTAL_INDEX };
+
+	for (size_t i = 0; i < 2; ++i) {
+		thread_counters_t *counters = &shard->counters[indices[i]];
+		add_live_bytes(counters, &t->shared[indices[i]], -(int64_t)size);
+		add_local(&counters->live_allocations, -1);
+		add_local(&counters->num_frees, 1);
+	}
+}
+
+static void record_reallocation(tracking_state_t *t, uint32_t index, size_t old_size, size_t size)
+{
+	record_free(t, index, old_size);
+	record_allocation(t, index, size);
+}
+
+// Must be called with the mutex held
+static void sum_stats(tracking_state_t *t, uint32_t index, lx_allocation_stats_t *stats)
+{
+	*stats = (lx_allocation_stats_t) { 0 };
+
+	const int64_t shared_live_bytes = lx_atomic_load_64(&t->shared[index].live_bytes);
+	int64_t peak_bytes = lx_atomic_load_64(&t->shared[index].peak_bytes);
+
+	for (shard_t *shard = t->shards; shard; shard = shard->next_shard) {
+		const thread_counters_t *counters = &shard->counters[index];
+		stats->live_bytes += lx_atomic_load_64(&counters->live_bytes);
+		stats->live_allocations += lx_atomic_load_64(&counters->live_allocations);
+		stats->num_allocations += lx_atomic_load_64(&counters->num_allocations);
+		stats->num_frees += lx_atomic_load_64(&counters->num_frees);
+		for (size_t i = 0; i < LX_ALLOCATION_HISTOGRAM_SIZE; ++i) {
+			stats->histogram[i] += lx_atomic_load_64(&counters->histogram[i]);
+		}
+
+		peak_bytes = lx_max(peak_bytes, shared_live_bytes + lx_atomic_load_64(&counters->unflushed_peak));
+	}
+
+	stats->peak_bytes = lx_max(peak_bytes, stats->live_bytes);
+}
+
+static void link_sample(tracking_state_t *t, allocation_header_t *header)
+{
+	lx_mutex_scope(&t->mutex, {
+		header->prev = NULL;
+		header->next = t->sampled_allocations;
+		if (header->next)
+			header->next->prev = header;
+		t->sampled_allocations = header;
+	});
+}
+
+static void unlink_sample(tracking_state_t *t, allocation_header_t *header)
+{
+	lx_mutex_scope(&t->mutex, {
+		if (header->prev)
+			header->prev->next = header->next;
+		else
+			t->sampled_allocations = header->next;
+
+		if (header->next)
+			header->next->prev = header->prev;
+	});
+}
+
+static void *tracking_realloc(lx_allocator_state_t *state, void *p, size_t size, size_t alignment)
+{
+	LX_ASSERT(state, "Invalid state");
+
+	tag_t *tag = (tag_t *)state;
+	tracking_state_t *t = tag->tracking;
+
+	if (!p) {
+		if (!size)
+			return NULL;
+
+		const size_t offset = lx_align_up(HEADER_SIZE, alignment);
+		allocation_header_t *header = place_header(lx_alloc_aligned(t->allocator, offset + size, alignment), offset);
+		header->size = size;
+		header->offset = offset;
+		header->tag = tag->index;
+		header->sampled = t->sample_rate && (lx_atomic_add_64(&t->sequence, 1) % t->sample_rate) == 0;
+
+		if (header->sampled)
+			link_sample(t, header);
+
+		record_allocation(t, tag->index, size);
+
+		return allocation_data(header);
+	}
+
+	// Frees and reallocations are accounted to the tag that made the allocation
+	allocation_header_t *header = allocation_header(p);
+	const uint32_t owner = header->tag;
+	const size_t old_size = header->size;
+
+	if (header->sampled)
+		unlink_sample(t, header);
+
+	if (!size) {
+		record_free(t, owner, old_size);
+		lx_free(t->allocator, (char *)p - header->offset);
+		return NULL;
+	}
+
+	const size_t offset = header->offset;
+	header = place_header(lx_realloc_aligned(t->allocator, (char *)p - offset, offset + size, alignment), offset);
+	header->size = size;
+
+	if (header->sampled)
+		link_sample(t, header);
+
+	record_reallocation(t, owner, old_size, size);
+
+	return allocation_data(header);
+}
+
+// Returns NULL once all LX_TRACKING_MAX_TAGS tags are in use
+static tag_t *create_tag(tracking_state_t *t, const char *name)
+{
+	if (t->num_tags == LX_TRACKING_MAX_TAGS)
+		return NULL;
+
+	const size_t name_size = strlen(name) + 1;
+
+	tag_t *tag = lx_alloc(t->allocator, sizeof(tag_t));
+	*tag = (tag_t) {
+		.allocator = { .state = (lx_allocator_state_t *)tag, .realloc = tracking_realloc },
+		.tracking = t,
+		.index = t->num_tags,
+		.name = lx_alloc(t->allocator, name_size)
+	};
+
+	memcpy(tag->name, name, name_size);
+	t->tags[t->num_tags++] = tag;
+
+	return tag;
+}
+
+static tag_t *find_tag(tracking_state_t *t, const char *name)
+{
+	for (uint32_t i = 0; i < t->num_tags; ++i) {
+		if (strcmp(t->tags[i]->name, name) == 0)
+			return t->tags[i];
+	}
+
+	return NULL;
+}
+
+lx_allocator_t *lx_tracking_allocator_create(lx_allocator_t *allocator, uint32_t sample_rate)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+
+	tracking_state_t *state = lx_alloc(allocator, sizeof(tracking_state_t));
+
+	*state = (tracking_state_t) {
+		.allocator = allocator,
+		.sample_rate = sample_rate,
+		.sequence = 0,
+		.local_storage = lx_thread_local_create_storage(),
+		.sampled_allocations = NULL,
+		.shards = NULL,
+		.num_tags = 0
+	};
+
+	lx_mutex_create(&state->mutex);
+
+	tag_t *untagged = create_tag(state, UNTAGGED_TAG);
+	return &untagged->allocator;
+}
+
+void lx_tracking_allocator_destroy(lx_allocator_t *tracking_allocator)
+{
+	LX_ASSERT(tracking_allocator, "Invalid tracking allocator");
+
+	tracking_state_t *t = ((tag_t *)tracking_allocator->state)->tracking;
+	lx_allocator_t *allocator = t->allocator;
+
+	for (uint32_t i = 0; i < t->num_tags; ++i) {
+		lx_free(allocator, t->tags[i]->name);
+		lx_free(allocator, t->tags[i]);
+	}
+
+	shard_t *shard = t->shards;
+	while (shard) {
+		shard_t *next_shard = shard->next_shard;
+		lx_free(allocator, shard);
+		shard = next_shard;
+	}
+
+	lx_thread_local_destroy_storage(t->local_storage);
+	lx_mutex_destroy(&t->mutex);
+
+	*t = (tracking_state_t) { 0 };
+	lx_free(allocator, t);
+}
+
+lx_allocator_t *lx_tracking_allocator_tag(lx_allocator_t *tracking_allocator, const char *tag)
+{
+	LX_ASSERT(tracking_allocator, "Invalid tracking allocator");
+	LX_ASSERT(tag, "Invalid tag");
+
+	tracking_state_t *t = ((tag_t *)tracking_allocator->state)->tracking;
+	tag_t *result = NULL;
+
+	lx_mutex_scope(&t->mutex, {
+		result = find_tag(t, tag);
+		if (!result)
+			result = create_tag(t, tag);
+	});
+
+	if (!result) {
+		LX_LOG_ERROR(LOG_TAG, "Can't add tag %s, all %u tags are in use", tag, (uint32_t)LX_TRACKING_MAX_TAGS);
+		return &t->tags[0]->allocator;
+	}
+
+	return &result->allocator;
+}
+
+void lx_tracking_allocator_stats(lx_allocator_t *tracking_allocator, const char *tag, lx_allocation_stats_t *stats)
+{
+	LX_ASSERT(tracking_allocator, "Invalid tracking allocator");
+	LX_ASSERT(stats, "Invalid stats");
+
+	tracking_state_t *t = ((tag_t *)tracking_allocator->state)->tracking;
+
+	lx_mutex_scope(&t->mutex, {
+		tag_t *result = tag ? find_tag(t, tag) : NULL;
+		if (!tag)
+			sum_stats(t, TOTAL_INDEX, stats);
+		else if (result)
+			sum_stats(t, result->index, stats);
+		else
+			*stats = (lx_allocation_stats_t) { 0 };
+	});
+}
+
+size_t lx_tracking_allocator_report_leaks(lx_allocator_t *tracking_allocator)
+{
+	LX_ASSERT(tracking_allocator, "Invalid tracking allocator");
+
+	tracking_state_t *t = ((tag_t *)tracking_allocator->state)->tracking;
+
+	lx_mutex_lock(&t->mutex);
+
+	lx_allocation_stats_t stats;
+	for (uint32_t i = 0; i < t->num_tags; ++i) {
+		const tag_t *tag = t->tags[i];
+		sum_stats(t, tag->index, &stats);
+		if (!stats.live_allocations)
+			continue;
+
+		LX_LOG_WARNING(LOG_TAG, "%s: %lld byte(s) in %lld allocation(s) still alive (peak %lld byte(s))",
+			tag->name, stats.live_bytes, stats.live_allocations, stats.peak_bytes);
+	}
+
+	for (allocation_header_t *header = t->sampled_allocations; header; header = header->next) {
+		LX_LOG_WARNING(LOG_TAG, "%s: leaked %zu byte(s) at %p", t->tags[header->tag]->name, header->size, allocation_data(header));
+	}
+
+	sum_stats(t, TOTAL_INDEX, &stats);
+	lx_mutex_unlock(&t->mutex);
+
+	return (size_t)stats.live_allocations;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LX_TRACKING_MAX_TAGS 64
+
+/*
+ * Histogram bucket i counts allocations with a size in [2^i, 2^(i + 1)).
+ */
+#define LX_ALLOCATION_HISTOGRAM_SIZE 32
+
+typedef struct lx_allocation_stats {
+	int64_t live_bytes;
+	int64_t peak_bytes;
+	int64_t live_allocations;
+	int64_t num_allocations;
+	int64_t num_frees;
+	int64_t histogram[LX_ALLOCATION_HISTOGRAM_SIZE];
+} lx_allocation_stats_t;
+
+/*
+ * Creates a thread safe allocator that forwards to the given allocator and records statistics
+ * about live and peak bytes, allocation counts and sizes. Counters are kept per thread and summed
+ * when read, peak bytes are exact while a single thread allocates and an estimate otherwise. Every
+ * sample_rate:th allocation is also recorded individually so it can be reported if it is never
+ * freed, a sample rate of zero disables sampling.
+ */
+lx_allocator_t *lx_tracking_allocator_create(lx_allocator_t *allocator, uint32_t sample_rate);
+
+/*
+ * Destroy tracking allocator. Allocations still alive are not released.
+ */
+void lx_tracking_allocator_destroy(lx_allocator_t *tracking_allocator);
+
+/*
+ * Returns an allocator that shares state with the tracking allocator but accounts allocations to
+ * the given tag. The same allocator is returned for the same tag name. Once LX_TRACKING_MAX_TAGS
+ * tags are in use an error is logged and new tags get the untagged allocator instead.
+ */
+lx_allocator_t *lx_tracking_allocator_tag(lx_allocator_t *tracking_allocator, const char *tag);
+
+/*
+ * Name of the tag for the file and line it is expanded on, e.g. "src/luxa/renderer/mesh.c:16".
+ */
+#define LX_TRACKING_CALL_SITE __FILE__ ":" LX_STRINGIFY(__LINE__)
+
+/*
+ * Returns an allocator that accounts allocations to the call site, the same way as a named tag.
+ * Each call site takes one of the LX_TRACKING_MAX_TAGS tags and the lookup takes a lock, so get
+ * the allocator once and keep it rather than once per allocation.
+ */
+#define lx_tracking_allocator_call_site(tracking_allocator) lx_tracking_allocator_tag(tracking_allocator, LX_TRACKING_CALL_SITE)
+
+/*
+ * Copy statistics for a tag, or for all allocations if tag is NULL.
+ */
+void lx_tracking_allocator_stats(lx_allocator_t *tracking_allocator, const char *tag, lx_allocation_stats_t *stats);
+
+/*
+ * Log a summary per tag and all sampled allocations that are still alive. Returns the number of
+ * allocations that are still alive.
+ */
+size_t lx_tracking_allocator_report_leaks(lx_allocator_t *tracking_allocator);
+
+#ifdef __cplusplus
+}
+#endif
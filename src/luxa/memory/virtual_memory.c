@@ -0,0 +1,47 @@
+#include <luxa/memory/virtual_memory.h>
+#include <windows.h>
+
+size_t lx_virtual_memory_page_size()
+{
+	static size_t page_size = 0;
+
+	if (!page_size) {
+		SYSTEM_INFO system_info;
+		GetSystemInfo(&system_info);
+		page_size = system_info.dwPageSize;
+	}
+
+	return page_size;
+}
+
+void *lx_virtual_memory_reserve(size_t size)
+{
+	LX_ASSERT(size, "Invalid size");
+
+	return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+lx_result_t lx_virtual_memory_commit(void *p, size_t size)
+{
+	LX_ASSERT(p, "Invalid address");
+	LX_ASSERT((uintptr_t)p % lx_virtual_memory_page_size() == 0, "Address must be page aligned");
+
+	return VirtualAlloc(p, size, MEM_COMMIT, PAGE_READWRITE) ? LX_SUCCESS : LX_ERROR;
+}
+
+void lx_virtual_memory_decommit(void *p, size_t size)
+{
+	LX_ASSERT(p, "Invalid address");
+	LX_ASSERT((uintptr_t)p % lx_virtual_memory_page_size() == 0, "Address must be page aligned");
+
+	VirtualFree(p, size, MEM_DECOMMIT);
+}
+
+void lx_virtual_memory_release(void *p, size_t size)
+{
+	if (!p)
+		return;
+
+	// The whole reservation is always released on Windows, size is only kept for symmetry
+	VirtualFree(p, 0, MEM_RELEASE);
+}
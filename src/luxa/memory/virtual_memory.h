@@ -0,0 +1,37 @@
+#pragma once
+
+#include <luxa/platform.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Size of a virtual memory page in bytes.
+ */
+size_t lx_virtual_memory_page_size();
+
+/*
+ * Reserve a range of address space without backing it with memory. Returns NULL on failure.
+ */
+void *lx_virtual_memory_reserve(size_t size);
+
+/*
+ * Back a page aligned part of a reserved range with zero initialized memory.
+ */
+lx_result_t lx_virtual_memory_commit(void *p, size_t size);
+
+/*
+ * Give the memory backing a page aligned part of a reserved range back to the system while keeping
+ * the address range reserved.
+ */
+void lx_virtual_memory_decommit(void *p, size_t size);
+
+/*
+ * Release a range returned by lx_virtual_memory_reserve.
+ */
+void lx_virtual_memory_release(void *p, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,8 +8,23 @@
 #include <string.h>
 
 #define LX_ALIGN16 __declspec(align(16))
+#define LX_ALIGN64 __declspec(align(64))
+#define LX_CACHE_LINE_SIZE 64
 #define LX_INLINE inline
 
+// Widest instruction set the compiler may use, SSE2 is always there on x64
+#if defined(__AVX__)
+#define LX_SIMD_AVX 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LX_SIMD_SSE 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define LX_SIMD_NEON 1
+#endif
+
 #ifndef NULL
 #define NULL ((void*)0);
 #endif
@@ -40,6 +55,14 @@ typedef enum lx_result
 
 #define lx_max(a, b) ((a) > (b) ? (a) : (b))
 
+#define lx_is_power_of_two(x) ((x) && !((x) & ((x) - 1)))
+
+#define lx_align_up(size, alignment) (((size) + ((alignment) - 1)) & ~((size_t)(alignment) - 1))
+
+#define LX_STRINGIFY_(x) #x
+
+#define LX_STRINGIFY(x) LX_STRINGIFY_(x)
+
 typedef struct lx_range
 {
 	lx_any_t begin;
@@ -0,0 +1,457 @@
+#include <luxa/renderer/bvh.h>
+#include <luxa/threading/threading.h>
+
+// Leaves never hold more items than this, smaller leaves are made when splitting doesn't pay off
+#define BVH_MAX_LEAF_SIZE 8
+
+// Candidate split planes per axis are the borders between bins of equal width
+#define BVH_NUM_BINS 16
+
+// Cost of visiting a node relative to testing the box of an item
+#define BVH_TRAVERSAL_COST 1.0f
+
+// Subtrees with more items are built in a task of their own
+#define BVH_PARALLEL_BUILD_GRAIN_SIZE 4096
+
+// Deep enough for any tree built from 32 bit item counts with sane boxes
+#define BVH_STACK_SIZE 64
+
+/*
+ * Children of an inner node are stored next to each other, the left child at first. A node always
+ * comes before its children, so walking the nodes backwards visits children before parents.
+ */
+typedef struct bvh_node {
+	lx_aabb_t bounds;
+	uint32_t first; // First child for inner nodes, first item for leaves
+	uint32_t num_items; // Zero for inner nodes
+} bvh_node_t;
+
+struct lx_bvh {
+	lx_allocator_t *allocator;
+	bvh_node_t *nodes;
+	uint32_t *items;
+	lx_aabb_t *item_bounds; // Box of every item in leaf order, the leaves test these
+	lx_vec3_t *centers;
+	size_t capacity; // Items the node, item and center arrays have room for
+	size_t num_nodes;
+	size_t num_items;
+	float build_cost;
+	float cost;
+};
+
+typedef struct bvh_build bvh_build_t;
+
+typedef struct bvh_build_job {
+	bvh_build_t *build;
+	lx_task_t *task;
+	uint32_t node;
+	uint32_t begin;
+	uint32_t end;
+} bvh_build_job_t;
+
+struct bvh_build {
+	lx_bvh_t *bvh;
+	const lx_aabb_t *bounds;
+	lx_task_factory_t *task_factory;
+	bvh_build_job_t *jobs;
+	int64_t max_jobs;
+	volatile int64_t num_jobs;
+	volatile int64_t num_nodes;
+};
+
+typedef struct bvh_bin {
+	lx_aabb_t bounds;
+	uint32_t num_items;
+} bvh_bin_t;
+
+static void build_node(bvh_build_t *build, lx_task_t *task, uint32_t node_index, uint32_t begin, uint32_t end);
+
+static void build_job_task(lx_task_factory_t *task_factory, lx_task_t *task, bvh_build_job_t *job)
+{
+	build_node(job->build, task, job->node, job->begin, job->end);
+}
+
+static size_t bin_index(float center, float min, float scale)
+{
+	const size_t bin = (size_t)((center - min) * scale);
+	return lx_min(bin, BVH_NUM_BINS - 1);
+}
+
+/*
+ * Split the items of a node where the surface area heuristic is lowest. Returns the number of
+ * items that go to the left child, 0 if the node is cheaper as a leaf.
+ */
+static uint32_t split_node(bvh_build_t *build, const bvh_node_t *node, uint32_t begin, uint32_t end)
+{
+	lx_bvh_t *bvh = build->bvh;
+	const uint32_t num_items = end - begin;
+
+	lx_aabb_t center_bounds;
+	lx_aabb_empty(&center_bounds);
+	for (uint32_t i = begin; i < end; ++i) {
+		lx_aabb_add_point(&center_bounds, &bvh->centers[bvh->items[i]], &center_bounds);
+	}
+
+	float best_cost = FLT_MAX;
+	size_t best_axis = 0;
+	size_t best_split = 0;
+
+	for (size_t axis = 0; axis < 3; ++axis) {
+		const float min = (&center_bounds.min.x)[axis];
+		const float extent = (&center_bounds.max.x)[axis] - min;
+		if (extent <= 0.0f)
+			continue;
+
+		bvh_bin_t bins[BVH_NUM_BINS];
+		for (size_t b = 0; b < BVH_NUM_BINS; ++b) {
+			lx_aabb_empty(&bins[b].bounds);
+			bins[b].num_items = 0;
+		}
+
+		const float scale = BVH_NUM_BINS / extent;
+		for (uint32_t i = begin; i < end; ++i) {
+			const uint32_t item = bvh->items[i];
+			bvh_bin_t *bin = &bins[bin_index((&bvh->centers[item].x)[axis], min, scale)];
+			lx_aabb_merge(&bin->bounds, &build->bounds[item], &bin->bounds);
+			bin->num_items++;
+		}
+
+		// Sweep from the right first, then from the left adding up the cost of every split plane
+		float right_area[BVH_NUM_BINS];
+		lx_aabb_t right;
+		lx_aabb_empty(&right);
+		for (size_t b = BVH_NUM_BINS - 1; b > 0; --b) {
+			lx_aabb_merge(&right, &bins[b].bounds, &right);
+			right_area[b] = lx_aabb_area(&right);
+		}
+
+		lx_aabb_t left;
+		lx_aabb_empty(&left);
+		uint32_t num_left = 0;
+		for (size_t split = 1; split < BVH_NUM_BINS; ++split) {
+			lx_aabb_merge(&left, &bins[split - 1].bounds, &left);
+			num_left += bins[split - 1].num_items;
+
+			const float cost = lx_aabb_area(&left) * num_left + right_area[split] * (num_items - num_left);
+			if (num_left && num_left < num_items && cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_split = split;
+			}
+		}
+	}
+
+	// All centers in one spot, halve the items to keep the leaves small
+	if (!best_split)
+		return num_items > BVH_MAX_LEAF_SIZE ? num_items / 2 : 0;
+
+	const float area = lx_aabb_area(&node->bounds);
+	const float split_cost = BVH_TRAVERSAL_COST + (area > 0.0f ? best_cost / area : num_items);
+	if (num_items <= BVH_MAX_LEAF_SIZE && (float)num_items <= split_cost)
+		return 0;
+
+	const float min = (&center_bounds.min.x)[best_axis];
+	const float scale = BVH_NUM_BINS / ((&center_bounds.max.x)[best_axis] - min);
+	uint32_t left = begin;
+	uint32_t right = end;
+	while (left < right) {
+		if (bin_index((&bvh->centers[bvh->items[left]].x)[best_axis], min, scale) < best_split) {
+			++left;
+		} else {
+			const uint32_t item = bvh->items[left];
+			bvh->items[left] = bvh->items[--right];
+			bvh->items[right] = item;
+		}
+	}
+
+	return left - begin;
+}
+
+static void build_node(bvh_build_t *build, lx_task_t *task, uint32_t node_index, uint32_t begin, uint32_t end)
+{
+	lx_bvh_t *bvh = build->bvh;
+
+	for (;;) {
+		bvh_node_t *node = &bvh->nodes[node_index];
+		lx_aabb_empty(&node->bounds);
+		for (uint32_t i = begin; i < end; ++i) {
+			lx_aabb_merge(&node->bounds, &build->bounds[bvh->items[i]], &node->bounds);
+		}
+
+		const uint32_t num_left = split_node(build, node, begin, end);
+		if (!num_left) {
+			node->first = begin;
+			node->num_items = end - begin;
+			for (uint32_t i = begin; i < end; ++i) {
+				bvh->item_bounds[i] = build->bounds[bvh->items[i]];
+			}
+			return;
+		}
+
+		const uint32_t left = (uint32_t)(lx_atomic_add_64(&build->num_nodes, 2) - 2);
+		const uint32_t middle = begin + num_left;
+		node->first = left;
+		node->num_items = 0;
+
+		// Large left subtrees go to another worker while this one continues with the right subtree,
+		// once the job array is full the rest is built inline
+		const int64_t job_index = task && num_left > BVH_PARALLEL_BUILD_GRAIN_SIZE
+			? lx_atomic_add_64(&build->num_jobs, 1) - 1
+			: build->max_jobs;
+
+		if (job_index < build->max_jobs) {
+			bvh_build_job_t *job = &build->jobs[job_index];
+			*job = (bvh_build_job_t) { .build = build, .node = left, .begin = begin, .end = middle };
+			job->task = lx_task_create_child(build->task_factory, task, build_job_task, job);
+			lx_task_start(build->task_factory, job->task);
+		} else {
+			build_node(build, task, left, begin, middle);
+		}
+
+		node_index = left + 1;
+		begin = middle;
+	}
+}
+
+/*
+ * Expected cost of a query through the tree relative to testing the root box, inner nodes cost a
+ * traversal step and leaves a test per item, weighted by the chance that a query reaches them.
+ */
+static float tree_cost(const lx_bvh_t *bvh)
+{
+	const float root_area = lx_aabb_area(&bvh->nodes[0].bounds);
+	if (root_area <= 0.0f)
+		return 1.0f;
+
+	float cost = 0.0f;
+	for (size_t i = 0; i < bvh->num_nodes; ++i) {
+		const bvh_node_t *node = &bvh->nodes[i];
+		cost += lx_aabb_area(&node->bounds) * (node->num_items ? (float)node->num_items : BVH_TRAVERSAL_COST);
+	}
+
+	return cost / root_area;
+}
+
+static void reserve(lx_bvh_t *bvh, size_t num_bounds)
+{
+	if (bvh->capacity >= num_bounds)
+		return;
+
+	if (bvh->capacity) {
+		lx_free(bvh->allocator, bvh->nodes);
+		lx_free(bvh->allocator, bvh->items);
+		lx_free(bvh->allocator, bvh->item_bounds);
+		lx_free(bvh->allocator, bvh->centers);
+	}
+
+	// A binary tree with a leaf per item has fewer than twice as many nodes as items
+	bvh->capacity = lx_max(num_bounds, bvh->capacity * 2);
+	bvh->nodes = lx_alloc(bvh->allocator, sizeof(bvh_node_t) * bvh->capacity * 2);
+	bvh->items = lx_alloc(bvh->allocator, sizeof(uint32_t) * bvh->capacity);
+	bvh->item_bounds = lx_alloc(bvh->allocator, sizeof(lx_aabb_t) * bvh->capacity);
+	bvh->centers = lx_alloc(bvh->allocator, sizeof(lx_vec3_t) * bvh->capacity);
+}
+
+lx_bvh_t *lx_bvh_create(lx_allocator_t *allocator)
+{
+	lx_bvh_t *bvh = lx_alloc(allocator, sizeof(lx_bvh_t));
+	*bvh = (lx_bvh_t) { .allocator = allocator, .build_cost = 1.0f, .cost = 1.0f };
+
+	reserve(bvh, 1);
+	bvh->num_nodes = 1;
+	bvh->nodes[0] = (bvh_node_t) { 0 };
+	lx_aabb_empty(&bvh->nodes[0].bounds);
+
+	return bvh;
+}
+
+void lx_bvh_destroy(lx_bvh_t *bvh)
+{
+	LX_ASSERT(bvh, "Invalid BVH");
+
+	lx_free(bvh->allocator, bvh->centers);
+	lx_free(bvh->allocator, bvh->item_bounds);
+	lx_free(bvh->allocator, bvh->items);
+	lx_free(bvh->allocator, bvh->nodes);
+	lx_free(bvh->allocator, bvh);
+}
+
+void lx_bvh_build(lx_bvh_t *bvh, const lx_aabb_t *bounds, size_t num_bounds, lx_task_factory_t *task_factory)
+{
+	LX_ASSERT(bvh, "Invalid BVH");
+	LX_ASSERT(num_bounds <= UINT32_MAX, "Too many items");
+
+	reserve(bvh, num_bounds);
+	bvh->num_items = 0;
+
+	for (size_t i = 0; i < num_bounds; ++i) {
+		if (lx_aabb_is_empty(&bounds[i]))
+			continue;
+
+		bvh->items[bvh->num_items++] = (uint32_t)i;
+		lx_aabb_center(&bounds[i], &bvh->centers[i]);
+	}
+
+	bvh_build_t build = {
+		.bvh = bvh,
+		.bounds = bounds,
+		.task_factory = task_factory,
+		.jobs = NULL,
+		.max_jobs = 0,
+		.num_jobs = 0,
+		.num_nodes = 1
+	};
+
+	if (!bvh->num_items) {
+		bvh->nodes[0] = (bvh_node_t) { 0 };
+		lx_aabb_empty(&bvh->nodes[0].bounds);
+	} else if (task_factory && bvh->num_items > BVH_PARALLEL_BUILD_GRAIN_SIZE) {
+		// Balanced splits need about this many jobs, lopsided ones build inline when it runs out
+		build.max_jobs = (int64_t)(2 * bvh->num_items / BVH_PARALLEL_BUILD_GRAIN_SIZE + 1);
+		build.jobs = lx_alloc(bvh->allocator, sizeof(bvh_build_job_t) * (size_t)build.max_jobs);
+		build.num_jobs = 1;
+
+		bvh_build_job_t *root = &build.jobs[0];
+		*root = (bvh_build_job_t) { .build = &build, .node = 0, .begin = 0, .end = (uint32_t)bvh->num_items };
+		root->task = lx_task_create(task_factory, build_job_task, root);
+		lx_task_start(task_factory, root->task);
+		lx_task_wait(task_factory, root->task);
+
+		const int64_t num_jobs = lx_min(build.num_jobs, build.max_jobs);
+		for (int64_t i = 0; i < num_jobs; ++i) {
+			lx_task_destroy(task_factory, build.jobs[i].task);
+		}
+
+		lx_free(bvh->allocator, build.jobs);
+	} else {
+		build_node(&build, NULL, 0, 0, (uint32_t)bvh->num_items);
+	}
+
+	bvh->num_nodes = (size_t)build.num_nodes;
+	bvh->build_cost = tree_cost(bvh);
+	bvh->cost = bvh->build_cost;
+}
+
+void lx_bvh_refit(lx_bvh_t *bvh, const lx_aabb_t *bounds)
+{
+	LX_ASSERT(bvh, "Invalid BVH");
+
+	if (!bvh->num_items)
+		return;
+
+	for (size_t i = bvh->num_nodes; i-- > 0;) {
+		bvh_node_t *node = &bvh->nodes[i];
+		if (node->num_items) {
+			lx_aabb_empty(&node->bounds);
+			for (uint32_t j = node->first; j < node->first + node->num_items; ++j) {
+				bvh->item_bounds[j] = bounds[bvh->items[j]];
+				lx_aabb_merge(&node->bounds, &bvh->item_bounds[j], &node->bounds);
+			}
+		} else {
+			lx_aabb_merge(&bvh->nodes[node->first].bounds, &bvh->nodes[node->first + 1].bounds, &node->bounds);
+		}
+	}
+
+	bvh->cost = tree_cost(bvh);
+}
+
+float lx_bvh_refit_cost(const lx_bvh_t *bvh)
+{
+	LX_ASSERT(bvh, "Invalid BVH");
+	return bvh->build_cost > 0.0f ? bvh->cost / bvh->build_cost : 1.0f;
+}
+
+size_t lx_bvh_num_items(const lx_bvh_t *bvh)
+{
+	LX_ASSERT(bvh, "Invalid BVH");
+	return bvh->num_items;
+}
+
+const lx_aabb_t *lx_bvh_bounds(const lx_bvh_t *bvh)
+{
+	LX_ASSERT(bvh, "Invalid BVH");
+	return &bvh->nodes[0].bounds;
+}
+
+void lx_bvh_query_aabb(const lx_bvh_t *bvh, const lx_aabb_t *bounds, lx_array_t *items)
+{
+	LX_ASSERT(bvh, "Invalid BVH");
+	LX_ASSERT(items, "Invalid item array");
+
+	if (!bvh->num_items)
+		return;
+
+	uint32_t stack[BVH_STACK_SIZE];
+	size_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size) {
+		const bvh_node_t *node = &bvh->nodes[stack[--stack_size]];
+		if (!lx_aabb_intersects(&node->bounds, bounds))
+			continue;
+
+		if (node->num_items) {
+			for (uint32_t i = node->first; i < node->first + node->num_items; ++i) {
+				if (lx_aabb_intersects(&bvh->item_bounds[i], bounds))
+					lx_array_push_back(items, &bvh->items[i]);
+			}
+		} else {
+			LX_ASSERT(stack_size + 2 <= BVH_STACK_SIZE, "BVH is too deep");
+			stack[stack_size++] = node->first;
+			stack[stack_size++] = node->first + 1;
+		}
+	}
+}
+
+bool lx_bvh_raycast(const lx_bvh_t *bvh, const lx_ray_t *ray, float max_distance, uint32_t *item, float *distance)
+{
+	LX_ASSERT(bvh, "Invalid BVH");
+
+	if (!bvh->num_items)
+		return false;
+
+	const lx_vec3_t inv_direction = { 1.0f / ray->direction.x, 1.0f / ray->direction.y, 1.0f / ray->direction.z };
+	float closest = max_distance;
+	bool hit = false;
+
+	uint32_t stack[BVH_STACK_SIZE];
+	size_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size) {
+		const bvh_node_t *node = &bvh->nodes[stack[--stack_size]];
+		float d;
+		if (!lx_aabb_intersect_ray(&node->bounds, ray, &inv_direction, closest, &d))
+			continue;
+
+		if (node->num_items) {
+			for (uint32_t i = node->first; i < node->first + node->num_items; ++i) {
+				if (lx_aabb_intersect_ray(&bvh->item_bounds[i], ray, &inv_direction, closest, &d) && (!hit || d < closest)) {
+					closest = d;
+					*item = bvh->items[i];
+					*distance = d;
+					hit = true;
+				}
+			}
+			continue;
+		}
+
+		// Visit the nearer child first so the far one is more likely to be culled by the closest hit
+		float left_distance = FLT_MAX, right_distance = FLT_MAX;
+		const bool left_hit = lx_aabb_intersect_ray(&bvh->nodes[node->first].bounds, ray, &inv_direction, closest, &left_distance);
+		const bool right_hit = lx_aabb_intersect_ray(&bvh->nodes[node->first + 1].bounds, ray, &inv_direction, closest, &right_distance);
+
+		LX_ASSERT(stack_size + 2 <= BVH_STACK_SIZE, "BVH is too deep");
+		if (left_hit && right_hit) {
+			const bool left_first = left_distance <= right_distance;
+			stack[stack_size++] = left_first ? node->first + 1 : node->first;
+			stack[stack_size++] = left_first ? node->first : node->first + 1;
+		} else if (left_hit) {
+			stack[stack_size++] = node->first;
+		} else if (right_hit) {
+			stack[stack_size++] = node->first + 1;
+		}
+	}
+
+	return hit;
+}
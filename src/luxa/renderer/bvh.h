@@ -0,0 +1,67 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+#include <luxa/collections/array.h>
+#include <luxa/math/math.h>
+#include <luxa/threading/task/task.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lx_bvh lx_bvh_t;
+
+/*
+ * Bounding volume hierarchy over a set of boxes, items are identified by their index in the box
+ * array the hierarchy was built from. Empty boxes are left out.
+ */
+lx_bvh_t *lx_bvh_create(lx_allocator_t *allocator);
+
+void lx_bvh_destroy(lx_bvh_t *bvh);
+
+/*
+ * Build the hierarchy from scratch. Nodes are split where the surface area heuristic predicts the
+ * cheapest queries, large subtrees are built in parallel on the task factory, pass NULL to build on
+ * the calling thread only.
+ */
+void lx_bvh_build(lx_bvh_t *bvh, const lx_aabb_t *bounds, size_t num_bounds, lx_task_factory_t *task_factory);
+
+/*
+ * Update the node bounds to the moved item boxes, keeping the structure of the last build. The box
+ * array may have grown since, but items are the ones of the last build, rebuild when boxes become
+ * empty or stop being empty. Much cheaper than a build, but queries slow down as items drift away
+ * from where they were when it was built.
+ */
+void lx_bvh_refit(lx_bvh_t *bvh, const lx_aabb_t *bounds);
+
+/*
+ * Expected cost of a query relative to the cost right after the last build, 1 after a build. Grows
+ * as refits make nodes overlap, rebuild once it is too high.
+ */
+float lx_bvh_refit_cost(const lx_bvh_t *bvh);
+
+/*
+ * Number of items in the hierarchy, items with empty boxes are not counted.
+ */
+size_t lx_bvh_num_items(const lx_bvh_t *bvh);
+
+/*
+ * Box around all items.
+ */
+const lx_aabb_t *lx_bvh_bounds(const lx_bvh_t *bvh);
+
+/*
+ * Append the items whose box intersects the box to items, an array of uint32_t.
+ */
+void lx_bvh_query_aabb(const lx_bvh_t *bvh, const lx_aabb_t *bounds, lx_array_t *items);
+
+/*
+ * Find the item whose box the ray enters first within max_distance. Returns false if the ray misses
+ * every item, otherwise item and distance are set.
+ */
+bool lx_bvh_raycast(const lx_bvh_t *bvh, const lx_ray_t *ray, float max_distance, uint32_t *item, float *distance);
+
+#ifdef __cplusplus
+}
+#endif
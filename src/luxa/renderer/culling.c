@@ -0,0 +1,145 @@
+#include <luxa/renderer/culling.h>
+
+#if defined(LX_SIMD_AVX)
+#include <immintrin.h>
+#elif defined(LX_SIMD_SSE)
+#include <emmintrin.h>
+#endif
+
+/*
+ * A box is behind a plane when its center is further behind the plane than the box reaches along
+ * the plane normal, dot(n, c) + w + dot(|n|, e) < 0.
+ */
+typedef struct cull_plane {
+	float normal_x, normal_y, normal_z, w;
+	float abs_normal_x, abs_normal_y, abs_normal_z;
+} cull_plane_t;
+
+static size_t cull_scalar(const cull_plane_t *planes, const lx_cull_bounds_t *bounds, size_t begin, size_t end, uint32_t *visible)
+{
+	size_t num_visible = 0;
+
+	for (size_t i = begin; i < end; ++i) {
+		bool inside = true;
+		for (size_t p = 0; p < 6; ++p) {
+			const cull_plane_t *plane = &planes[p];
+			const float distance = plane->normal_x * bounds->center_x[i] + plane->normal_y * bounds->center_y[i] + plane->normal_z * bounds->center_z[i] + plane->w +
+				plane->abs_normal_x * bounds->extent_x[i] + plane->abs_normal_y * bounds->extent_y[i] + plane->abs_normal_z * bounds->extent_z[i];
+			inside &= distance >= 0.0f;
+		}
+
+		// Always write, only advance past visible boxes
+		visible[num_visible] = (uint32_t)i;
+		num_visible += inside;
+	}
+
+	return num_visible;
+}
+
+#if defined(LX_SIMD_AVX)
+
+#define CULL_BATCH_SIZE 8
+
+static size_t cull_batches(const cull_plane_t *planes, const lx_cull_bounds_t *bounds, size_t begin, size_t end, uint32_t *visible)
+{
+	size_t num_visible = 0;
+	size_t i = begin;
+
+	for (; i + CULL_BATCH_SIZE <= end; i += CULL_BATCH_SIZE) {
+		const __m256 center_x = _mm256_loadu_ps(bounds->center_x + i);
+		const __m256 center_y = _mm256_loadu_ps(bounds->center_y + i);
+		const __m256 center_z = _mm256_loadu_ps(bounds->center_z + i);
+		const __m256 extent_x = _mm256_loadu_ps(bounds->extent_x + i);
+		const __m256 extent_y = _mm256_loadu_ps(bounds->extent_y + i);
+		const __m256 extent_z = _mm256_loadu_ps(bounds->extent_z + i);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (size_t p = 0; p < 6; ++p) {
+			const cull_plane_t *plane = &planes[p];
+			__m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane->normal_x), center_x), _mm256_set1_ps(plane->w));
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane->normal_y), center_y));
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane->normal_z), center_z));
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane->abs_normal_x), extent_x));
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane->abs_normal_y), extent_y));
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane->abs_normal_z), extent_z));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+		}
+
+		const int mask = _mm256_movemask_ps(inside);
+		for (size_t lane = 0; lane < CULL_BATCH_SIZE; ++lane) {
+			visible[num_visible] = (uint32_t)(i + lane);
+			num_visible += (mask >> lane) & 1;
+		}
+	}
+
+	return num_visible + cull_scalar(planes, bounds, i, end, visible + num_visible);
+}
+
+#elif defined(LX_SIMD_SSE)
+
+#define CULL_BATCH_SIZE 4
+
+static size_t cull_batches(const cull_plane_t *planes, const lx_cull_bounds_t *bounds, size_t begin, size_t end, uint32_t *visible)
+{
+	size_t num_visible = 0;
+	size_t i = begin;
+
+	for (; i + CULL_BATCH_SIZE <= end; i += CULL_BATCH_SIZE) {
+		const __m128 center_x = _mm_loadu_ps(bounds->center_x + i);
+		const __m128 center_y = _mm_loadu_ps(bounds->center_y + i);
+		const __m128 center_z = _mm_loadu_ps(bounds->center_z + i);
+		const __m128 extent_x = _mm_loadu_ps(bounds->extent_x + i);
+		const __m128 extent_y = _mm_loadu_ps(bounds->extent_y + i);
+		const __m128 extent_z = _mm_loadu_ps(bounds->extent_z + i);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (size_t p = 0; p < 6; ++p) {
+			const cull_plane_t *plane = &planes[p];
+			__m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane->normal_x), center_x), _mm_set1_ps(plane->w));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane->normal_y), center_y));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane->normal_z), center_z));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane->abs_normal_x), extent_x));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane->abs_normal_y), extent_y));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane->abs_normal_z), extent_z));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+		}
+
+		const int mask = _mm_movemask_ps(inside);
+		for (size_t lane = 0; lane < CULL_BATCH_SIZE; ++lane) {
+			visible[num_visible] = (uint32_t)(i + lane);
+			num_visible += (mask >> lane) & 1;
+		}
+	}
+
+	return num_visible + cull_scalar(planes, bounds, i, end, visible + num_visible);
+}
+
+#else
+
+static size_t cull_batches(const cull_plane_t *planes, const lx_cull_bounds_t *bounds, size_t begin, size_t end, uint32_t *visible)
+{
+	return cull_scalar(planes, bounds, begin, end, visible);
+}
+
+#endif
+
+size_t lx_frustum_cull(const lx_frustum_t *frustum, const lx_cull_bounds_t *bounds, size_t begin, size_t end, uint32_t *visible)
+{
+	LX_ASSERT(frustum, "Invalid frustum");
+	LX_ASSERT(bounds, "Invalid bounds");
+	LX_ASSERT(end <= bounds->count && end <= UINT32_MAX, "Invalid range");
+
+	if (begin >= end)
+		return 0;
+
+	cull_plane_t planes[6];
+	for (size_t p = 0; p < 6; ++p) {
+		const lx_vec4_t *plane = &frustum->planes[p];
+		planes[p] = (cull_plane_t) {
+			.normal_x = plane->x, .normal_y = plane->y, .normal_z = plane->z, .w = plane->w,
+			.abs_normal_x = fabsf(plane->x), .abs_normal_y = fabsf(plane->y), .abs_normal_z = fabsf(plane->z)
+		};
+	}
+
+	return cull_batches(planes, bounds, begin, end, visible);
+}
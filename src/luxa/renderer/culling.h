@@ -0,0 +1,33 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/math/math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bounds of items as separate arrays of box centers and half extents, see lx_aabb_center_extent.
+ * Culling loads several items per array at once and tests them against a plane together.
+ */
+typedef struct lx_cull_bounds {
+	const float *center_x;
+	const float *center_y;
+	const float *center_z;
+	const float *extent_x;
+	const float *extent_y;
+	const float *extent_z;
+	size_t count;
+} lx_cull_bounds_t;
+
+/*
+ * Write the indices in [begin, end) of the boxes that intersect the frustum to visible, in order,
+ * and return how many were written. Visible must have room for end - begin indices. Uses AVX or SSE
+ * when the compiler targets them, the test is the one of lx_frustum_intersects_aabb.
+ */
+size_t lx_frustum_cull(const lx_frustum_t *frustum, const lx_cull_bounds_t *bounds, size_t begin, size_t end, uint32_t *visible);
+
+#ifdef __cplusplus
+}
+#endif
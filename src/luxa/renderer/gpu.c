@@ -253,6 +253,7 @@ void lx_gpu_destroy_buffer(lx_gpu_device_t *device, lx_gpu_buffer_t *buffer)
 
     vkDestroyBuffer(device->handle, buffer->handle, NULL);
     vkFreeMemory(device->handle, buffer->memory, NULL);
+    lx_free(device->gpu->allocator, buffer);
 }
 
 bool lx_gpu_map_memory(lx_gpu_device_t *device, lx_gpu_buffer_t *buffer)
@@ -7,6 +7,8 @@ struct lx_mesh {
     lx_array_t *indices; // uint32_t
     lx_any_t vertex_buffer;
     lx_any_t index_buffer;
+    lx_aabb_t bounds;
+    lx_sphere_t bounding_sphere;
 };
 
 lx_mesh_t *lx_mesh_create(lx_allocator_t *allocator)
@@ -18,8 +20,10 @@ lx_mesh_t *lx_mesh_create(lx_allocator_t *allocator)
         .vertices = lx_array_create(allocator, sizeof(lx_vertex_t)),
         .indices = lx_array_create(allocator, sizeof(uint32_t)),
         .vertex_buffer = NULL,
-        .index_buffer = NULL
+        .index_buffer = NULL,
+        .bounding_sphere = { 0 }
     };
+    lx_aabb_empty(&mesh->bounds);
 
     return mesh;
 }
@@ -64,6 +68,30 @@ const uint32_t *lx_mesh_indices(const lx_mesh_t *mesh)
 void lx_mesh_set_vertices(lx_mesh_t *mesh, lx_vertex_t *vertices, size_t num_vertices)
 {
     lx_array_copy(mesh->vertices, vertices, num_vertices);
+
+    lx_aabb_empty(&mesh->bounds);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        lx_aabb_add_point(&mesh->bounds, &vertices[i].position, &mesh->bounds);
+    }
+
+    // Center the sphere on the box, then fit the radius to the vertices which is tighter than the
+    // sphere around the box
+    lx_sphere_from_aabb(&mesh->bounds, &mesh->bounding_sphere);
+    float squared_radius = 0.0f;
+    for (size_t i = 0; i < num_vertices; ++i) {
+        squared_radius = fmaxf(squared_radius, lx_vec3_squared_distance(&mesh->bounding_sphere.center, &vertices[i].position));
+    }
+    mesh->bounding_sphere.radius = lx_sqrtf(squared_radius);
+}
+
+const lx_aabb_t *lx_mesh_bounds(const lx_mesh_t *mesh)
+{
+    return &mesh->bounds;
+}
+
+const lx_sphere_t *lx_mesh_bounding_sphere(const lx_mesh_t *mesh)
+{
+    return &mesh->bounding_sphere;
 }
 
 void lx_mesh_set_indices(lx_mesh_t *mesh, uint32_t *indices, size_t num_indices)
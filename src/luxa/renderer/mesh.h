@@ -32,8 +32,21 @@ const lx_vertex_t *lx_mesh_vertices(const lx_mesh_t *mesh);
 
 const uint32_t *lx_mesh_indices(const lx_mesh_t *mesh);
 
+/*
+ * Copy the vertices and recompute the bounds of the mesh.
+ */
 void lx_mesh_set_vertices(lx_mesh_t *mesh, lx_vertex_t *vertices, size_t num_vertices);
 
+/*
+ * Box around the vertex positions in mesh space, empty until vertices are set.
+ */
+const lx_aabb_t *lx_mesh_bounds(const lx_mesh_t *mesh);
+
+/*
+ * Sphere around the vertex positions in mesh space, centered on the bounds.
+ */
+const lx_sphere_t *lx_mesh_bounding_sphere(const lx_mesh_t *mesh);
+
 void lx_mesh_set_indices(lx_mesh_t *mesh, uint32_t *indices, size_t num_indices);
 
 void lx_mesh_set_vertex_buffer(lx_mesh_t *mesh, lx_any_t vertex_buffer);
@@ -2,11 +2,14 @@
 #include <luxa/renderer/gpu.h>
 #include <luxa/renderer/render_pipeline.h>
 #include <luxa/renderer/mesh.h>
+#include <luxa/renderer/culling.h>
+#include <luxa/memory/arena_allocator.h>
 #include <luxa/log.h>
 #include <luxa/collections/array.h>
 #include <vulkan/vulkan.h>
 
 #define LOG_TAG "Renderer"
+#define FRAME_ALLOCATOR_BLOCK_SIZE (256 * 1024)
 
 typedef struct depth_buffer {
 	lx_gpu_image_t *image;
@@ -49,6 +52,7 @@ typedef struct swap_chain {
 struct lx_renderer
 {
 	lx_allocator_t *allocator;
+	lx_allocator_t *frame_allocator;
     lx_array_t *gpus; // lx_gpu_t
     lx_gpu_device_t *device;
     lx_array_t *frame_buffers; // frame_buffer_t
@@ -830,6 +834,7 @@ lx_result_t lx_renderer_create(lx_allocator_t *allocator, lx_renderer_t **render
     lx_renderer_t *vulkan_renderer = lx_alloc(allocator, sizeof(lx_renderer_t));
 	*vulkan_renderer = (lx_renderer_t) { 0 };
 	vulkan_renderer->allocator = allocator;
+	vulkan_renderer->frame_allocator = lx_arena_allocator_create(allocator, FRAME_ALLOCATOR_BLOCK_SIZE);
 	vulkan_renderer->record_command_buffer = true;
 
 	// Initialize Vulkan instance
@@ -943,6 +948,12 @@ void lx_renderer_destroy(lx_allocator_t *allocator, lx_renderer_t *renderer)
 	lx_gpu_destroy_semaphore(renderer->device, renderer->semaphore_image_available);
     lx_gpu_destroy_semaphore(renderer->device, renderer->semaphore_render_finished);
 
+	// Destroy uniform buffer(s)
+    if (renderer->model_view_proj_gpu_buffer) {
+        lx_gpu_destroy_buffer(renderer->device, renderer->model_view_proj_gpu_buffer);
+        renderer->model_view_proj_gpu_buffer = NULL;
+    }
+
 	// Destroy depth buffer
 	destroy_depth_buffer(renderer);
 	
@@ -1014,6 +1025,11 @@ void lx_renderer_destroy(lx_allocator_t *allocator, lx_renderer_t *renderer)
 	if (renderer->instance) {
 		vkDestroyInstance(renderer->instance, NULL);
 	}
+
+	// Destroy frame allocator
+	if (renderer->frame_allocator) {
+		lx_arena_allocator_destroy(renderer->frame_allocator);
+	}
 	
 	lx_free(allocator, renderer);
 }
@@ -1104,6 +1120,17 @@ void lx_renderer_render_frame(lx_renderer_t *renderer, lx_scene_t *scene, lx_cam
     lx_mat4_look_to(&camera->direction, &camera->position, &camera->up, &model_view_proj[1]);
     lx_mat4_perspective_fov(camera->near_plane, camera->far_plane, camera->fov, aspect_ratio, &model_view_proj[2]);
 
+    // Cull nodes outside the view frustum before recording, only visible nodes are drawn
+    lx_mat4_t view_proj;
+    lx_frustum_t frustum;
+    lx_mat4_mul(&model_view_proj[1], &model_view_proj[2], &view_proj);
+    lx_frustum_from_view_projection(&view_proj, &frustum);
+
+    lx_cull_bounds_t cull_bounds;
+    lx_scene_cull_bounds(scene, &cull_bounds);
+    uint32_t *visible_nodes = lx_alloc(renderer->frame_allocator, sizeof(uint32_t) * cull_bounds.count);
+    const size_t num_visible_nodes = lx_frustum_cull(&frustum, &cull_bounds, 1, cull_bounds.count, visible_nodes);
+
     VkCommandBuffer *command_buffer = lx_array_at(renderer->command_pool->command_buffers, image_index);
     VkCommandBufferBeginInfo buffer_begin_info = { 0 };
     buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -1133,8 +1160,8 @@ void lx_renderer_render_frame(lx_renderer_t *renderer, lx_scene_t *scene, lx_cam
 
     // Draw meshes
     vkCmdBindPipeline(*command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->render_pipeline->handle);
-    const size_t scene_size = lx_scene_size(scene);
-    for (lx_scene_node_t node = 1; node < scene_size; ++node) {
+    for (size_t i = 0; i < num_visible_nodes; ++i) {
+        const lx_scene_node_t node = visible_nodes[i];
         lx_renderable_t renderable = lx_scene_renderable(scene, node);
 
         if (!lx_is_some_renderable(renderable))
@@ -1168,6 +1195,7 @@ void lx_renderer_render_frame(lx_renderer_t *renderer, lx_scene_t *scene, lx_cam
     // Stop recording
     if (vkEndCommandBuffer(*command_buffer) != VK_SUCCESS) {
         LX_LOG_ERROR(LOG_TAG, "Failed to record command buffer");
+        lx_arena_allocator_reset(renderer->frame_allocator);
         return;
     }
 
@@ -1191,6 +1219,7 @@ void lx_renderer_render_frame(lx_renderer_t *renderer, lx_scene_t *scene, lx_cam
     result = vkQueueSubmit(renderer->device->graphics_queue, 1, &submit_info, VK_NULL_HANDLE);
     if (result != VK_SUCCESS) {
     	LX_LOG_ERROR(LOG_TAG, "Failed to sumbit draw command buffer (Error: %d)", result);
+    	lx_arena_allocator_reset(renderer->frame_allocator);
     	return;
     }
 
@@ -1212,6 +1241,15 @@ void lx_renderer_render_frame(lx_renderer_t *renderer, lx_scene_t *scene, lx_cam
     }
 
     vkQueueWaitIdle(renderer->device->presentation_queue);
+
+    // Release per frame scratch memory
+    lx_arena_allocator_reset(renderer->frame_allocator);
+}
+
+lx_allocator_t *lx_renderer_frame_allocator(lx_renderer_t *renderer)
+{
+	LX_ASSERT(renderer, "Invalid renderer");
+	return renderer->frame_allocator;
 }
 
 void lx_renderer_device_wait_idle(lx_renderer_t *renderer)
@@ -1318,6 +1356,11 @@ void lx_renderer_initialize_scene(lx_renderer_t *renderer, lx_scene_t *scene)
             continue;
 
         lx_mesh_t *mesh = rd->data;
+
+        // Nodes are culled by their bounds, nodes without any would never be drawn
+        if (lx_aabb_is_empty(lx_scene_local_bounds(scene, i)))
+            lx_scene_set_local_bounds(scene, i, lx_mesh_bounds(mesh));
+
         size_t size = lx_mesh_vertices_byte_size(mesh);
         
         // Create vertex buffer
@@ -1360,4 +1403,33 @@ void lx_renderer_initialize_scene(lx_renderer_t *renderer, lx_scene_t *scene)
     write_descriptor_set.pBufferInfo = &descriptor_buffer_info;
 
     vkUpdateDescriptorSets(renderer->device->handle, 1, &write_descriptor_set, 0, NULL);
+}
+
+void lx_renderer_release_scene(lx_renderer_t *renderer, lx_scene_t *scene)
+{
+    const size_t scene_size = lx_scene_size(scene);
+    for (size_t i = 1; i < scene_size; ++i) {
+        lx_renderable_t renderable = lx_scene_renderable(scene, i);
+
+        if (!lx_is_some_renderable(renderable))
+            continue;
+
+        lx_scene_render_data_t *rd = lx_scene_render_data(scene, renderable);
+        if (!rd)
+            continue;
+
+        lx_mesh_t *mesh = rd->data;
+
+        lx_gpu_buffer_t *vertex_buffer = lx_mesh_vertex_buffer(mesh);
+        if (vertex_buffer) {
+            lx_gpu_destroy_buffer(renderer->device, vertex_buffer);
+            lx_mesh_set_vertex_buffer(mesh, NULL);
+        }
+
+        lx_gpu_buffer_t *index_buffer = lx_mesh_index_buffer(mesh);
+        if (index_buffer) {
+            lx_gpu_destroy_buffer(renderer->device, index_buffer);
+            lx_mesh_set_index_buffer(mesh, NULL);
+        }
+    }
 }
\ No newline at end of file
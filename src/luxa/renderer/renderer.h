@@ -29,8 +29,18 @@ void lx_renderer_destroy(lx_allocator_t *allocator, lx_renderer_t *renderer);
 
 void lx_renderer_render_frame(lx_renderer_t *renderer, lx_scene_t *scene, lx_camera_t *camera);
 
+/*
+ * Scratch allocator that is reset when a frame has been presented.
+ */
+lx_allocator_t *lx_renderer_frame_allocator(lx_renderer_t *renderer);
+
 void lx_renderer_initialize_scene(lx_renderer_t *renderer, lx_scene_t *scene);
 
+/*
+ * Destroy the gpu buffers lx_renderer_initialize_scene created for the meshes of the scene.
+ */
+void lx_renderer_release_scene(lx_renderer_t *renderer, lx_scene_t *scene);
+
 void lx_renderer_device_wait_idle(lx_renderer_t *renderer);
 
 lx_result_t lx_renderer_reset_swap_chain(lx_renderer_t *renderer, lx_extent2_t swap_chain_extent);
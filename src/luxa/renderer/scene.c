@@ -1,79 +1,362 @@
 #include <luxa/renderer/scene.h>
+#include <luxa/renderer/bvh.h>
 #include <luxa/collections/map.h>
+#include <luxa/collections/virtual_array.h>
 #include <luxa/hash.h>
+#include <luxa/threading/threading.h>
+#include <luxa/threading/task/parallel_for.h>
+#include <luxa/log.h>
 
-static const size_t SCENE_NODE_SIZE =
-    sizeof(lx_scene_node_t) +   // Parent
-    sizeof(lx_scene_node_t) +   // First child
-    sizeof(lx_scene_node_t) +   // Next sibling
-    sizeof(lx_renderable_t) +   // Renderable
-    sizeof(lx_mat4_t);          // Transform
+static const char *LOG_TAG = "Scene";
 
-typedef struct buffer {
-    void *data;
-    size_t size;
-    size_t capacity;
-} buffer_t;
+// Levels smaller than this are updated on the calling thread
+#define SCENE_PARALLEL_UPDATE_GRAIN_SIZE 1024
+
+// Depth of destroyed nodes waiting to be reused
+#define SCENE_FREE_NODE_DEPTH UINT32_MAX
+
+// Rebuild the BVH instead of refitting it once refits have made queries this much more expensive
+#define SCENE_BVH_REBUILD_COST 1.5f
+
+typedef enum scene_column {
+    SCENE_COLUMN_TRANSFORM,
+    SCENE_COLUMN_WORLD_TRANSFORM,
+    SCENE_COLUMN_PARENT,
+    SCENE_COLUMN_FIRST_CHILD,
+    SCENE_COLUMN_LAST_CHILD,
+    SCENE_COLUMN_NEXT_SIBLING,
+    SCENE_COLUMN_PREVIOUS_SIBLING,
+    SCENE_COLUMN_RENDERABLE,
+    SCENE_COLUMN_DEPTH,
+    SCENE_COLUMN_LEVEL_INDEX,
+    SCENE_COLUMN_DIRTY,
+    SCENE_COLUMN_WORLD_VERSION,
+    SCENE_COLUMN_BOUNDS,
+    SCENE_COLUMN_WORLD_BOUNDS,
+    SCENE_COLUMN_WORLD_CENTER_X,
+    SCENE_COLUMN_WORLD_CENTER_Y,
+    SCENE_COLUMN_WORLD_CENTER_Z,
+    SCENE_COLUMN_WORLD_EXTENT_X,
+    SCENE_COLUMN_WORLD_EXTENT_Y,
+    SCENE_COLUMN_WORLD_EXTENT_Z,
+    SCENE_NUM_COLUMNS
+} scene_column_t;
+
+static const size_t SCENE_COLUMN_SIZE[SCENE_NUM_COLUMNS] = {
+    sizeof(lx_mat4_t),          // Transform
+    sizeof(lx_mat4_t),          // World transform
+    sizeof(lx_scene_node_t),    // Parent
+    sizeof(lx_scene_node_t),    // First child
+    sizeof(lx_scene_node_t),    // Last child
+    sizeof(lx_scene_node_t),    // Next sibling
+    sizeof(lx_scene_node_t),    // Previous sibling
+    sizeof(lx_renderable_t),    // Renderable
+    sizeof(uint32_t),           // Depth
+    sizeof(uint32_t),           // Level index
+    sizeof(uint8_t),            // Dirty
+    sizeof(uint32_t),           // World version
+    sizeof(lx_aabb_t),          // Bounds
+    sizeof(lx_aabb_t),          // World bounds
+    sizeof(float),              // World center x
+    sizeof(float),              // World center y
+    sizeof(float),              // World center z
+    sizeof(float),              // World extent x
+    sizeof(float),              // World extent y
+    sizeof(float)               // World extent z
+};
+
+/*
+ * Nodes at the same depth, updated together once the level above is done. Dirty nodes is the number
+ * of nodes of the level whose local transform changed since the last update.
+ */
+typedef struct scene_level {
+    lx_array_t *nodes; // lx_scene_node_t
+    size_t num_dirty_nodes;
+} scene_level_t;
+
+typedef struct level_update {
+    lx_scene_t *scene;
+    const lx_scene_node_t *nodes;
+    uint32_t version;
+    volatile int64_t num_updated_nodes;
+} level_update_t;
 
 struct lx_scene {
     lx_allocator_t *allocator;
     
-    // Scene node
-    buffer_t buffer;
+    // Scene node, each column reserves room for LX_SCENE_MAX_NODES up front so nodes never move
+    size_t size;
+    size_t num_free_nodes;
+    lx_scene_node_t free_node; // Destroyed nodes are linked through next sibling
+    lx_virtual_array_t *columns[SCENE_NUM_COLUMNS];
     lx_scene_node_t *parent;
     lx_scene_node_t *first_child;
+    lx_scene_node_t *last_child;
     lx_scene_node_t *next_sibling;
+    lx_scene_node_t *previous_sibling;
     lx_renderable_t *renderable;
     lx_mat4_t *transform;
+    lx_mat4_t *world_transform;
+    uint32_t *depth;
+    uint32_t *level_index;
+    uint8_t *dirty;
+    uint32_t *world_version; // Update that last recomputed the world transform
+    lx_aabb_t *bounds;
+    lx_aabb_t *world_bounds;
+    float *world_center[3]; // World bounds again as centers and extents per axis, for culling
+    float *world_extent[3];
+
+    lx_array_t *levels; // scene_level_t
+    uint32_t version;
+
+    // Items are nodes, rebuilt when nodes gain or lose bounds and refitted when they move
+    lx_bvh_t *bvh;
+    bool rebuild_bvh;
 
-    lx_array_t *render_data; // render_data_t
+    lx_slot_map_t *render_data; // lx_scene_render_data_t
 };
 
-void allocate_buffer(lx_scene_t *scene, size_t capacity)
+static void set_world_bounds(lx_scene_t *scene, lx_scene_node_t node, const lx_aabb_t *bounds)
 {
-    scene->buffer.capacity = capacity;
-    scene->buffer.data = lx_realloc(scene->allocator, scene->buffer.data, capacity * SCENE_NODE_SIZE);
+    lx_vec3_t center, extent;
+    lx_aabb_center_extent(bounds, &center, &extent);
 
-    scene->parent = (lx_scene_node_t *)scene->buffer.data;
-    scene->first_child = (lx_scene_node_t *)(scene->parent + scene->buffer.capacity);
-    scene->next_sibling = (lx_scene_node_t *)(scene->first_child + scene->buffer.capacity);
-    scene->renderable = (lx_renderable_t *)(scene->next_sibling + scene->buffer.capacity);
-    scene->transform = (lx_mat4_t *)(scene->renderable + scene->buffer.capacity);
+    scene->world_bounds[node] = *bounds;
+    scene->world_center[0][node] = center.x;
+    scene->world_center[1][node] = center.y;
+    scene->world_center[2][node] = center.z;
+    scene->world_extent[0][node] = extent.x;
+    scene->world_extent[1][node] = extent.y;
+    scene->world_extent[2][node] = extent.z;
 }
 
-lx_scene_t *lx_scene_create(lx_allocator_t *allocator)
+static void clear_bounds(lx_scene_t *scene, lx_scene_node_t node)
+{
+    lx_aabb_empty(&scene->bounds[node]);
+    set_world_bounds(scene, node, &scene->bounds[node]);
+}
+
+// On failure the columns that were already resized are shrunk back, so all columns keep one size
+static lx_result_t resize_columns(lx_scene_t *scene, size_t size)
+{
+    for (size_t i = 0; i < SCENE_NUM_COLUMNS; ++i) {
+        lx_result_t result = lx_virtual_array_resize(scene->columns[i], size);
+        if (result != LX_SUCCESS) {
+            for (size_t j = 0; j < i; ++j) {
+                lx_virtual_array_resize(scene->columns[j], scene->size);
+            }
+
+            return result;
+        }
+    }
+
+    scene->size = size;
+    return LX_SUCCESS;
+}
+
+static scene_level_t *level_at(lx_scene_t *scene, size_t depth)
+{
+    while (lx_array_size(scene->levels) <= depth) {
+        scene_level_t level = { .nodes = lx_array_create(scene->allocator, sizeof(lx_scene_node_t)) };
+        lx_array_push_back(scene->levels, &level);
+    }
+
+    return lx_array_at(scene->levels, depth);
+}
+
+static void mark_dirty(lx_scene_t *scene, lx_scene_node_t node)
+{
+    if (scene->dirty[node])
+        return;
+
+    scene->dirty[node] = 1;
+    level_at(scene, scene->depth[node])->num_dirty_nodes++;
+}
+
+static void add_to_level(lx_scene_t *scene, lx_scene_node_t node, uint32_t depth)
+{
+    scene_level_t *level = level_at(scene, depth);
+    scene->depth[node] = depth;
+    scene->level_index[node] = (uint32_t)lx_array_size(level->nodes);
+    scene->dirty[node] = 0;
+    lx_array_push_back(level->nodes, &node);
+    mark_dirty(scene, node);
+}
+
+// The last node of the level takes the place of the removed node
+static void remove_from_level(lx_scene_t *scene, lx_scene_node_t node)
+{
+    scene_level_t *level = lx_array_at(scene->levels, scene->depth[node]);
+    if (scene->dirty[node])
+        level->num_dirty_nodes--;
+
+    const lx_scene_node_t last = *(lx_scene_node_t *)lx_array_pop_back(level->nodes);
+    if (last != node) {
+        *(lx_scene_node_t *)lx_array_at(level->nodes, scene->level_index[node]) = last;
+        scene->level_index[last] = scene->level_index[node];
+    }
+}
+
+static void link_last_child(lx_scene_t *scene, lx_scene_node_t parent, lx_scene_node_t node)
+{
+    const lx_scene_node_t last_child = scene->last_child[parent];
+
+    scene->parent[node] = parent;
+    scene->previous_sibling[node] = last_child;
+    scene->next_sibling[node] = 0;
+
+    if (lx_is_some_scene_node(last_child)) {
+        scene->next_sibling[last_child] = node;
+    } else {
+        scene->first_child[parent] = node;
+    }
+
+    scene->last_child[parent] = node;
+}
+
+static void unlink_node(lx_scene_t *scene, lx_scene_node_t node)
+{
+    const lx_scene_node_t parent = scene->parent[node];
+    const lx_scene_node_t previous = scene->previous_sibling[node];
+    const lx_scene_node_t next = scene->next_sibling[node];
+
+    if (lx_is_some_scene_node(previous)) {
+        scene->next_sibling[previous] = next;
+    } else {
+        scene->first_child[parent] = next;
+    }
+
+    if (lx_is_some_scene_node(next)) {
+        scene->previous_sibling[next] = previous;
+    } else {
+        scene->last_child[parent] = previous;
+    }
+}
+
+/*
+ * Next node of the subtree in depth first order, or nil once the whole subtree has been visited.
+ * Walks the hierarchy links so no stack is needed.
+ */
+static lx_scene_node_t next_in_subtree(const lx_scene_t *scene, lx_scene_node_t node, lx_scene_node_t subtree)
+{
+    if (lx_is_some_scene_node(scene->first_child[node]))
+        return scene->first_child[node];
+
+    while (node != subtree) {
+        if (lx_is_some_scene_node(scene->next_sibling[node]))
+            return scene->next_sibling[node];
+
+        node = scene->parent[node];
+    }
+
+    return lx_nil_scene_node();
+}
+
+/*
+ * A node is recomputed when its local transform changed or when its parent was recomputed by the
+ * same update. Node 0 is the parent of the root and is never recomputed.
+ */
+static void update_level_nodes(size_t begin, size_t end, level_update_t *update)
 {
-    const size_t default_capacity = 128;
+    lx_scene_t *scene = update->scene;
+    const uint32_t version = update->version;
+    int64_t num_updated_nodes = 0;
+
+    for (size_t i = begin; i < end; ++i) {
+        const lx_scene_node_t node = update->nodes[i];
+        const lx_scene_node_t parent = scene->parent[node];
+        if (!scene->dirty[node] && scene->world_version[parent] != version)
+            continue;
+
+        lx_mat4_mul(&scene->transform[node], &scene->world_transform[parent], &scene->world_transform[node]);
+        lx_aabb_t world_bounds;
+        lx_aabb_transform(&scene->bounds[node], &scene->world_transform[node], &world_bounds);
+        set_world_bounds(scene, node, &world_bounds);
+        scene->world_version[node] = version;
+        scene->dirty[node] = 0;
+        num_updated_nodes++;
+    }
 
+    if (num_updated_nodes)
+        lx_atomic_add_64(&update->num_updated_nodes, num_updated_nodes);
+}
+
+lx_scene_t *lx_scene_create(lx_allocator_t *allocator)
+{
     lx_scene_t *scene = lx_alloc(allocator, sizeof(lx_scene_t));
     *scene = (lx_scene_t) { 0 };
 
     scene->allocator = allocator;
 
     // Init scene node
-    allocate_buffer(scene, default_capacity);
-    memset(scene->buffer.data, 0, scene->buffer.capacity * SCENE_NODE_SIZE);
-    scene->buffer.size = 2;
+    for (size_t i = 0; i < SCENE_NUM_COLUMNS; ++i) {
+        scene->columns[i] = lx_virtual_array_create(allocator, SCENE_COLUMN_SIZE[i], LX_SCENE_MAX_NODES);
+    }
+
+    scene->transform = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_TRANSFORM]);
+    scene->parent = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_PARENT]);
+    scene->first_child = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_FIRST_CHILD]);
+    scene->last_child = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_LAST_CHILD]);
+    scene->next_sibling = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_NEXT_SIBLING]);
+    scene->previous_sibling = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_PREVIOUS_SIBLING]);
+    scene->renderable = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_RENDERABLE]);
+    scene->world_transform = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_WORLD_TRANSFORM]);
+    scene->depth = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_DEPTH]);
+    scene->level_index = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_LEVEL_INDEX]);
+    scene->dirty = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_DIRTY]);
+    scene->world_version = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_WORLD_VERSION]);
+    scene->bounds = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_BOUNDS]);
+    scene->world_bounds = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_WORLD_BOUNDS]);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        scene->world_center[axis] = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_WORLD_CENTER_X + axis]);
+        scene->world_extent[axis] = lx_virtual_array_begin(scene->columns[SCENE_COLUMN_WORLD_EXTENT_X + axis]);
+    }
+
+    resize_columns(scene, 2);
+    lx_mat4_identity(&scene->transform[0]);
+    lx_mat4_identity(&scene->world_transform[0]);
     lx_mat4_identity(&scene->transform[1]);
+    lx_mat4_identity(&scene->world_transform[1]);
+    clear_bounds(scene, 0);
+    clear_bounds(scene, 1);
+    scene->world_version[0] = 0;
+
+    // The root is the only node of the first level
+    scene->levels = lx_array_create(allocator, sizeof(scene_level_t));
+    scene->version = 0;
+    add_to_level(scene, lx_scene_root_node(), 0);
+
+    scene->bvh = lx_bvh_create(allocator);
+    scene->rebuild_bvh = false;
 
     // Init render data
-    scene->render_data = lx_array_create(allocator, sizeof(lx_scene_render_data_t));
-    lx_scene_render_data_t nil_render_data = { 0 };
-    lx_array_push_back(scene->render_data, &nil_render_data); 
-    
+    scene->render_data = lx_slot_map_create(allocator, sizeof(lx_scene_render_data_t));
+
     return scene;
 }
 
 void lx_scene_destroy(lx_scene_t *scene)
 {
-    lx_array_destroy(scene->render_data);
-    lx_free(scene->allocator, scene->buffer.data);
+    lx_slot_map_destroy(scene->render_data);
+    lx_bvh_destroy(scene->bvh);
+
+    for (size_t i = 0; i < lx_array_size(scene->levels); ++i) {
+        lx_array_destroy(((scene_level_t *)lx_array_at(scene->levels, i))->nodes);
+    }
+    lx_array_destroy(scene->levels);
+
+    for (size_t i = 0; i < SCENE_NUM_COLUMNS; ++i) {
+        lx_virtual_array_destroy(scene->columns[i]);
+    }
+    
+    lx_allocator_t *allocator = scene->allocator;
     *scene = (lx_scene_t) { 0 };
+    lx_free(allocator, scene);
 }
 
 size_t lx_scene_size(const lx_scene_t *scene)
 {
-    return scene->buffer.size;
+    return scene->size;
 }
 
 lx_scene_node_t lx_scene_first_child(lx_scene_t *scene, lx_scene_node_t parent)
@@ -88,47 +371,203 @@ lx_scene_node_t lx_scene_next_sibling(lx_scene_t *scene, lx_scene_node_t node)
     return scene->next_sibling[node];
 }
 
+lx_scene_node_t lx_scene_parent(lx_scene_t *scene, lx_scene_node_t node)
+{
+    LX_ASSERT(lx_is_some_scene_node(node), "Invalid node");
+    return scene->parent[node];
+}
+
+size_t lx_scene_num_nodes(const lx_scene_t *scene)
+{
+    return scene->size - 2 - scene->num_free_nodes;
+}
+
+bool lx_scene_is_alive(const lx_scene_t *scene, lx_scene_node_t node)
+{
+    return lx_is_some_scene_node(node) && node < scene->size && scene->depth[node] != SCENE_FREE_NODE_DEPTH;
+}
+
 lx_scene_node_t lx_scene_create_node(lx_scene_t *scene, lx_scene_node_t parent)
 {
-    LX_ASSERT(lx_is_some_scene_node(parent), "Invalid parent");
-    
-    if (scene->buffer.size >= scene->buffer.capacity)
-        allocate_buffer(scene, scene->buffer.capacity * 2);
-    
-    lx_scene_node_t node = scene->buffer.size;
-    scene->buffer.size++;
+    LX_ASSERT(lx_scene_is_alive(scene, parent), "Invalid parent");
+
+    // Reuse destroyed nodes before growing the columns
+    lx_scene_node_t node = scene->free_node;
+    if (lx_is_some_scene_node(node)) {
+        scene->free_node = scene->next_sibling[node];
+        scene->num_free_nodes--;
+    } else {
+        node = scene->size;
+        if (resize_columns(scene, scene->size + 1) != LX_SUCCESS) {
+            LX_LOG_ERROR(LOG_TAG, "Scene is full, it can hold at most %u node(s)", (uint32_t)LX_SCENE_MAX_NODES);
+            return lx_nil_scene_node();
+        }
+    }
 
-    scene->parent[node] = parent;
     scene->first_child[node] = 0;
-    scene->next_sibling[node] = 0;
+    scene->last_child[node] = 0;
     scene->renderable[node] = 0;
+    scene->world_version[node] = 0;
     lx_mat4_identity(&scene->transform[node]);
+    lx_mat4_identity(&scene->world_transform[node]);
+    clear_bounds(scene, node);
+    link_last_child(scene, parent, node);
+    add_to_level(scene, node, scene->depth[parent] + 1);
 
-    lx_scene_node_t first_child = scene->first_child[parent];
-    if (lx_is_nil_scene_node(first_child)) {
-        scene->first_child[parent] = node;
-        return node;
+    return node;
+}
+
+void lx_scene_destroy_node(lx_scene_t *scene, lx_scene_node_t node)
+{
+    LX_ASSERT(lx_scene_is_alive(scene, node), "Invalid node");
+    LX_ASSERT(node != lx_scene_root_node(), "The root node can't be destroyed");
+
+    // Collect the subtree first, freeing a node overwrites the links the walk follows
+    lx_array_t *subtree = lx_array_create(scene->allocator, sizeof(lx_scene_node_t));
+    for (lx_scene_node_t n = node; lx_is_some_scene_node(n); n = next_in_subtree(scene, n, node)) {
+        lx_array_push_back(subtree, &n);
     }
 
-    lx_scene_node_t sibling = first_child;
-    while (scene->next_sibling[sibling]) {
-        sibling = scene->next_sibling[sibling];
+    unlink_node(scene, node);
+
+    lx_array_for(lx_scene_node_t, n, subtree) {
+        remove_from_level(scene, *n);
+        scene->depth[*n] = SCENE_FREE_NODE_DEPTH;
+        scene->parent[*n] = 0;
+        scene->first_child[*n] = 0;
+        scene->last_child[*n] = 0;
+        scene->previous_sibling[*n] = 0;
+        scene->renderable[*n] = 0;
+        scene->dirty[*n] = 0;
+        scene->rebuild_bvh |= !lx_aabb_is_empty(&scene->bounds[*n]);
+        clear_bounds(scene, *n);
+        scene->next_sibling[*n] = scene->free_node;
+        scene->free_node = *n;
     }
-    scene->next_sibling[sibling] = node;
-    
-    return node;
+
+    scene->num_free_nodes += lx_array_size(subtree);
+    lx_array_destroy(subtree);
+}
+
+void lx_scene_set_parent(lx_scene_t *scene, lx_scene_node_t node, lx_scene_node_t parent)
+{
+    LX_ASSERT(lx_scene_is_alive(scene, node), "Invalid node");
+    LX_ASSERT(lx_scene_is_alive(scene, parent), "Invalid parent");
+    LX_ASSERT(node != lx_scene_root_node(), "The root node can't be moved");
+
+    for (lx_scene_node_t ancestor = parent; lx_is_some_scene_node(ancestor); ancestor = scene->parent[ancestor]) {
+        LX_ASSERT(ancestor != node, "A node can't be moved into its own subtree");
+    }
+
+    unlink_node(scene, node);
+    link_last_child(scene, parent, node);
+
+    // The whole subtree changes world transform, and depth unless the new parent is at the same depth
+    if (scene->depth[parent] + 1 != scene->depth[node]) {
+        for (lx_scene_node_t n = node; lx_is_some_scene_node(n); n = next_in_subtree(scene, n, node)) {
+            remove_from_level(scene, n);
+            add_to_level(scene, n, scene->depth[scene->parent[n]] + 1);
+        }
+    }
+
+    mark_dirty(scene, node);
+}
+
+void lx_scene_compact(lx_scene_t *scene, lx_scene_node_t *node_map)
+{
+    LX_ASSERT(scene, "Invalid scene");
+
+    const size_t old_size = scene->size;
+    const size_t new_size = old_size - scene->num_free_nodes;
+
+    // Number nodes breadth first, children of a node end up next to each other and every level is
+    // a sorted run of nodes
+    lx_scene_node_t *order = lx_alloc(scene->allocator, sizeof(lx_scene_node_t) * new_size);
+    lx_scene_node_t *new_node = lx_alloc(scene->allocator, sizeof(lx_scene_node_t) * old_size);
+    memset(new_node, 0, sizeof(lx_scene_node_t) * old_size);
+
+    order[0] = 0;
+    order[1] = lx_scene_root_node();
+    size_t num_ordered = 2;
+    for (size_t i = 1; i < num_ordered; ++i) {
+        new_node[order[i]] = i;
+        for (lx_scene_node_t child = scene->first_child[order[i]]; lx_is_some_scene_node(child); child = scene->next_sibling[child]) {
+            order[num_ordered++] = child;
+        }
+    }
+
+    LX_ASSERT(num_ordered == new_size, "Scene hierarchy is corrupt");
+
+    // Gather every column in the new order through a scratch buffer
+    char *scratch = lx_alloc(scene->allocator, sizeof(lx_mat4_t) * new_size);
+    for (size_t c = 0; c < SCENE_NUM_COLUMNS; ++c) {
+        const size_t column_size = SCENE_COLUMN_SIZE[c];
+        char *column = lx_virtual_array_begin(scene->columns[c]);
+        for (size_t i = 0; i < new_size; ++i) {
+            memcpy(scratch + column_size * i, column + column_size * order[i], column_size);
+        }
+
+        memcpy(column, scratch, column_size * new_size);
+    }
+
+    resize_columns(scene, new_size);
+
+    lx_scene_node_t *links[] = { scene->parent, scene->first_child, scene->last_child, scene->next_sibling, scene->previous_sibling };
+    for (size_t l = 0; l < sizeof(links) / sizeof(links[0]); ++l) {
+        for (size_t i = 1; i < new_size; ++i) {
+            links[l][i] = new_node[links[l][i]];
+        }
+    }
+
+    // Rebuild the levels in the new order
+    for (size_t depth = 0; depth < lx_array_size(scene->levels); ++depth) {
+        scene_level_t *level = lx_array_at(scene->levels, depth);
+        lx_array_clear(level->nodes);
+        level->num_dirty_nodes = 0;
+    }
+
+    for (lx_scene_node_t node = 1; node < new_size; ++node) {
+        scene_level_t *level = lx_array_at(scene->levels, scene->depth[node]);
+        scene->level_index[node] = (uint32_t)lx_array_size(level->nodes);
+        lx_array_push_back(level->nodes, &node);
+        level->num_dirty_nodes += scene->dirty[node];
+    }
+
+    scene->free_node = 0;
+    scene->num_free_nodes = 0;
+    scene->rebuild_bvh = true;
+
+    if (node_map) {
+        memcpy(node_map, new_node, sizeof(lx_scene_node_t) * old_size);
+    }
+
+    lx_free(scene->allocator, scratch);
+    lx_free(scene->allocator, new_node);
+    lx_free(scene->allocator, order);
 }
 
 lx_renderable_t lx_scene_create_renderable(lx_scene_t *scene, lx_renderable_type_t type, lx_any_t render_data)
 {
     LX_ASSERT(type == LX_RENDERABLE_TYPE_MESH, "Only meshes is allowed");
 
-    lx_renderable_t handle = lx_array_size(scene->render_data);
-    lx_scene_render_data_t rendera_data = { .handle = handle,.type = type, .data = render_data };
-    lx_array_push_back(scene->render_data, &rendera_data);
+    lx_scene_render_data_t rendera_data = { .type = type, .data = render_data };
+    lx_renderable_t handle = lx_slot_map_insert(scene->render_data, &rendera_data);
+    ((lx_scene_render_data_t *)lx_slot_map_at(scene->render_data, handle))->handle = handle;
     return handle;
 }
 
+bool lx_scene_destroy_renderable(lx_scene_t *scene, lx_renderable_t renderable)
+{
+    LX_ASSERT(scene, "Invalid scene");
+    return lx_slot_map_remove(scene->render_data, renderable);
+}
+
+size_t lx_scene_num_renderables(const lx_scene_t *scene)
+{
+    LX_ASSERT(scene, "Invalid scene");
+    return lx_slot_map_size(scene->render_data);
+}
+
 void lx_scene_attach_renderable(lx_scene_t *scene, lx_scene_node_t node, lx_renderable_t renderable)
 {
     LX_ASSERT(scene, "Invalid scene");
@@ -145,10 +584,154 @@ lx_renderable_t lx_scene_renderable(lx_scene_t *scene, lx_scene_node_t node)
 
 lx_scene_render_data_t *lx_scene_render_data(lx_scene_t *scene, lx_renderable_t renderable)
 {
-    return lx_array_at(scene->render_data, renderable);
+    return lx_slot_map_at(scene->render_data, renderable);
 }
 
-const lx_mat4_t *lx_scene_world_transform(const lx_scene_t *scene, lx_scene_node_t node)
+const lx_mat4_t *lx_scene_local_transform(const lx_scene_t *scene, lx_scene_node_t node)
 {
+    LX_ASSERT(lx_is_some_scene_node(node), "Invalid scene node");
     return &scene->transform[node];
 }
+
+void lx_scene_set_local_transform(lx_scene_t *scene, lx_scene_node_t node, const lx_mat4_t *transform)
+{
+    LX_ASSERT(scene, "Invalid scene");
+    LX_ASSERT(lx_scene_is_alive(scene, node), "Invalid scene node");
+
+    scene->transform[node] = *transform;
+    mark_dirty(scene, node);
+}
+
+const lx_mat4_t *lx_scene_world_transform(const lx_scene_t *scene, lx_scene_node_t node)
+{
+    return &scene->world_transform[node];
+}
+
+const lx_aabb_t *lx_scene_local_bounds(const lx_scene_t *scene, lx_scene_node_t node)
+{
+    LX_ASSERT(lx_is_some_scene_node(node), "Invalid scene node");
+    return &scene->bounds[node];
+}
+
+void lx_scene_set_local_bounds(lx_scene_t *scene, lx_scene_node_t node, const lx_aabb_t *bounds)
+{
+    LX_ASSERT(scene, "Invalid scene");
+    LX_ASSERT(lx_scene_is_alive(scene, node), "Invalid scene node");
+
+    // The BVH leaves out nodes without bounds, refitting can't add or remove them
+    if (lx_aabb_is_empty(&scene->bounds[node]) != lx_aabb_is_empty(bounds))
+        scene->rebuild_bvh = true;
+
+    scene->bounds[node] = *bounds;
+    mark_dirty(scene, node);
+}
+
+const lx_aabb_t *lx_scene_world_bounds(const lx_scene_t *scene, lx_scene_node_t node)
+{
+    LX_ASSERT(lx_is_some_scene_node(node), "Invalid scene node");
+    return &scene->world_bounds[node];
+}
+
+const lx_aabb_t *lx_scene_bounds(const lx_scene_t *scene)
+{
+    LX_ASSERT(scene, "Invalid scene");
+    return lx_bvh_bounds(scene->bvh);
+}
+
+void lx_scene_cull_bounds(const lx_scene_t *scene, lx_cull_bounds_t *bounds)
+{
+    LX_ASSERT(scene, "Invalid scene");
+    LX_ASSERT(bounds, "Invalid bounds");
+
+    *bounds = (lx_cull_bounds_t) {
+        .center_x = scene->world_center[0],
+        .center_y = scene->world_center[1],
+        .center_z = scene->world_center[2],
+        .extent_x = scene->world_extent[0],
+        .extent_y = scene->world_extent[1],
+        .extent_z = scene->world_extent[2],
+        .count = scene->size
+    };
+}
+
+void lx_scene_query_aabb(const lx_scene_t *scene, const lx_aabb_t *bounds, lx_array_t *nodes)
+{
+    LX_ASSERT(scene, "Invalid scene");
+    LX_ASSERT(nodes, "Invalid node array");
+
+    // The BVH identifies nodes by 32 bit index
+    lx_array_t *items = lx_array_create(scene->allocator, sizeof(uint32_t));
+    lx_bvh_query_aabb(scene->bvh, bounds, items);
+
+    lx_array_for(uint32_t, item, items) {
+        lx_scene_node_t node = *item;
+        lx_array_push_back(nodes, &node);
+    }
+
+    lx_array_destroy(items);
+}
+
+bool lx_scene_raycast(const lx_scene_t *scene, const lx_ray_t *ray, float max_distance, lx_scene_node_t *node, float *distance)
+{
+    LX_ASSERT(scene, "Invalid scene");
+
+    uint32_t item;
+    if (!lx_bvh_raycast(scene->bvh, ray, max_distance, &item, distance))
+        return false;
+
+    *node = item;
+    return true;
+}
+
+size_t lx_scene_depth(const lx_scene_t *scene, lx_scene_node_t node)
+{
+    LX_ASSERT(lx_is_some_scene_node(node), "Invalid scene node");
+    return scene->depth[node];
+}
+
+void lx_scene_update_transforms(lx_scene_t *scene, lx_task_factory_t *task_factory)
+{
+    LX_ASSERT(scene, "Invalid scene");
+
+    // Version 0 marks nodes that were never updated
+    scene->version = scene->version == UINT32_MAX ? 1 : scene->version + 1;
+
+    int64_t num_updated_nodes = 0;
+    int64_t total_updated_nodes = 0;
+    for (size_t depth = 0; depth < lx_array_size(scene->levels); ++depth) {
+        scene_level_t *level = lx_array_at(scene->levels, depth);
+
+        // Nothing above changed and nothing in the level is dirty
+        if (!level->num_dirty_nodes && !num_updated_nodes)
+            continue;
+
+        level_update_t update = {
+            .scene = scene,
+            .nodes = lx_array_begin(level->nodes),
+            .version = scene->version,
+            .num_updated_nodes = 0
+        };
+
+        const size_t num_nodes = lx_array_size(level->nodes);
+        if (task_factory && num_nodes > SCENE_PARALLEL_UPDATE_GRAIN_SIZE) {
+            lx_parallel_for(task_factory, 0, num_nodes, SCENE_PARALLEL_UPDATE_GRAIN_SIZE, update_level_nodes, &update);
+        } else {
+            update_level_nodes(0, num_nodes, &update);
+        }
+
+        level->num_dirty_nodes = 0;
+        num_updated_nodes = update.num_updated_nodes;
+        total_updated_nodes += num_updated_nodes;
+    }
+
+    // Moved nodes only need the BVH refitted, until it has degraded too much
+    if (!scene->rebuild_bvh && total_updated_nodes) {
+        lx_bvh_refit(scene->bvh, scene->world_bounds);
+        scene->rebuild_bvh = lx_bvh_refit_cost(scene->bvh) > SCENE_BVH_REBUILD_COST;
+    }
+
+    if (scene->rebuild_bvh) {
+        lx_bvh_build(scene->bvh, scene->world_bounds, scene->size, task_factory);
+        scene->rebuild_bvh = false;
+    }
+}
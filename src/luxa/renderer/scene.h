@@ -3,12 +3,21 @@
 #include <luxa/platform.h>
 #include <luxa/memory/allocator.h>
 #include <luxa/collections/array.h>
+#include <luxa/collections/slot_map.h>
 #include <luxa/math/math.h>
+#include <luxa/renderer/culling.h>
+#include <luxa/threading/task/task.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * Maximum number of nodes in a scene. Address space for all nodes is reserved when the scene is
+ * created, memory is only committed as nodes are added.
+ */
+#define LX_SCENE_MAX_NODES (1024 * 1024)
+
 typedef struct lx_scene lx_scene_t;
 
 typedef uint64_t lx_scene_node_t;
@@ -17,7 +26,10 @@ typedef enum lx_renderable_type {
     LX_RENDERABLE_TYPE_MESH = 0x00000001
 } lx_renderable_type_t;
 
-typedef uint64_t lx_renderable_t;
+/*
+ * Handle to the render data of a scene, stays invalid once the renderable is destroyed.
+ */
+typedef lx_handle_t lx_renderable_t;
 
 typedef struct lx_scene_render_data {
     lx_renderable_type_t type;
@@ -60,18 +72,127 @@ lx_scene_node_t lx_scene_first_child(lx_scene_t *scene, lx_scene_node_t parent);
 
 lx_scene_node_t lx_scene_next_sibling(lx_scene_t *scene, lx_scene_node_t node);
 
+lx_scene_node_t lx_scene_parent(lx_scene_t *scene, lx_scene_node_t node);
+
+/*
+ * Number of live nodes, excluding the root node. Unlike lx_scene_size destroyed nodes aren't counted.
+ */
+size_t lx_scene_num_nodes(const lx_scene_t *scene);
+
+/*
+ * False for the nil node and for destroyed nodes that haven't been reused yet.
+ */
+bool lx_scene_is_alive(const lx_scene_t *scene, lx_scene_node_t node);
+
+/*
+ * Append a node as the last child of parent. Nodes freed by lx_scene_destroy_node are reused before
+ * the scene grows. Returns the nil node when the scene already holds LX_SCENE_MAX_NODES nodes.
+ */
 lx_scene_node_t lx_scene_create_node(lx_scene_t *scene, lx_scene_node_t parent);
 
+/*
+ * Destroy the node and its whole subtree. Renderables attached to the nodes are not destroyed.
+ */
+void lx_scene_destroy_node(lx_scene_t *scene, lx_scene_node_t node);
+
+/*
+ * Move the node and its subtree to the end of the children of parent. The parent can't be part of
+ * the subtree. World transforms of the subtree are recomputed by the next lx_scene_update_transforms.
+ */
+void lx_scene_set_parent(lx_scene_t *scene, lx_scene_node_t node, lx_scene_node_t parent);
+
+/*
+ * Renumber the live nodes breadth first, dropping the holes left by destroyed nodes. Afterwards the
+ * children of a node and the nodes of a depth level are stored next to each other. Nodes change ids,
+ * if node_map isn't NULL it receives the new id of every old node, lx_scene_size entries as of
+ * before the call, destroyed nodes map to the nil node.
+ */
+void lx_scene_compact(lx_scene_t *scene, lx_scene_node_t *node_map);
+
 lx_renderable_t lx_scene_create_renderable(lx_scene_t *scene, lx_renderable_type_t type, lx_any_t render_data);
 
+/*
+ * Release the renderable, nodes it is attached to are no longer rendered. Returns false if the
+ * renderable has already been destroyed.
+ */
+bool lx_scene_destroy_renderable(lx_scene_t *scene, lx_renderable_t renderable);
+
+size_t lx_scene_num_renderables(const lx_scene_t *scene);
+
 void lx_scene_attach_renderable(lx_scene_t *scene, lx_scene_node_t node, lx_renderable_t renderable);
 
 lx_renderable_t lx_scene_renderable(lx_scene_t *scene, lx_scene_node_t node);
 
+/*
+ * Returns NULL if the renderable has been destroyed.
+ */
 lx_scene_render_data_t *lx_scene_render_data(lx_scene_t *scene, lx_renderable_t renderable);
 
+/*
+ * Transform relative to the parent node. Setting it marks the node dirty, the world transforms of
+ * the node and its subtree are recomputed by the next lx_scene_update_transforms.
+ */
+const lx_mat4_t *lx_scene_local_transform(const lx_scene_t *scene, lx_scene_node_t node);
+
+void lx_scene_set_local_transform(lx_scene_t *scene, lx_scene_node_t node, const lx_mat4_t *transform);
+
+/*
+ * Local transform composed with the world transform of the parent, as of the last
+ * lx_scene_update_transforms.
+ */
 const lx_mat4_t *lx_scene_world_transform(const lx_scene_t *scene, lx_scene_node_t node);
 
+/*
+ * Box around the node in its own space, nodes are created without bounds. Like the local transform
+ * setting it marks the node dirty. Nodes without bounds are left out of queries.
+ */
+const lx_aabb_t *lx_scene_local_bounds(const lx_scene_t *scene, lx_scene_node_t node);
+
+void lx_scene_set_local_bounds(lx_scene_t *scene, lx_scene_node_t node, const lx_aabb_t *bounds);
+
+/*
+ * Local bounds moved by the world transform, as of the last lx_scene_update_transforms.
+ */
+const lx_aabb_t *lx_scene_world_bounds(const lx_scene_t *scene, lx_scene_node_t node);
+
+/*
+ * Box around the world bounds of all nodes, as of the last lx_scene_update_transforms.
+ */
+const lx_aabb_t *lx_scene_bounds(const lx_scene_t *scene);
+
+/*
+ * World bounds of every node for lx_frustum_cull, indexed by node and as of the last
+ * lx_scene_update_transforms. Nodes without bounds are always culled. Nodes never move, but the
+ * count only covers the nodes that existed at the time of the call.
+ */
+void lx_scene_cull_bounds(const lx_scene_t *scene, lx_cull_bounds_t *bounds);
+
+/*
+ * Append the nodes whose world bounds intersect the box to nodes, an array of lx_scene_node_t.
+ * Queries use the BVH of the last lx_scene_update_transforms.
+ */
+void lx_scene_query_aabb(const lx_scene_t *scene, const lx_aabb_t *bounds, lx_array_t *nodes);
+
+/*
+ * Find the node whose world bounds the ray enters first within max_distance. Returns false if the
+ * ray misses every node, otherwise node and distance are set.
+ */
+bool lx_scene_raycast(const lx_scene_t *scene, const lx_ray_t *ray, float max_distance, lx_scene_node_t *node, float *distance);
+
+/*
+ * Depth of the node in the hierarchy, the root node has depth 0.
+ */
+size_t lx_scene_depth(const lx_scene_t *scene, lx_scene_node_t node);
+
+/*
+ * Recompute the world transforms and bounds of dirty nodes and their subtrees. Nodes are grouped by
+ * depth and processed one depth level at a time, levels without changes are skipped. Large levels
+ * are split into chunks run in parallel on the task factory, pass NULL to update on the calling
+ * thread only. The BVH is then refitted to the moved nodes, or rebuilt when nodes gained or lost
+ * bounds or refitting has degraded it too much.
+ */
+void lx_scene_update_transforms(lx_scene_t *scene, lx_task_factory_t *task_factory);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,163 @@
+#include <luxa/threading/cpu_topology.h>
+#include <windows.h>
+
+typedef SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX processor_info_t;
+
+#define processor_info_for(info, buffer, size)\
+    for (processor_info_t *info = (processor_info_t *)(buffer);\
+        (char *)info < (char *)(buffer) + (size);\
+        info = (processor_info_t *)((char *)info + info->Size))
+
+static size_t count_processors(const GROUP_AFFINITY *mask)
+{
+	size_t count = 0;
+	for (KAFFINITY bits = mask->Mask; bits; bits &= bits - 1) {
+		++count;
+	}
+
+	return count;
+}
+
+static bool in_group_mask(const GROUP_AFFINITY *mask, const lx_logical_processor_t *processor)
+{
+	return mask->Group == processor->group && (mask->Mask & ((KAFFINITY)1 << processor->number)) != 0;
+}
+
+static void detect_fallback(lx_cpu_topology_t *topology)
+{
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+
+	topology->num_processors = lx_max(system_info.dwNumberOfProcessors, 1);
+	topology->num_cores = topology->num_processors;
+	topology->num_caches = 1;
+	topology->num_numa_nodes = 1;
+	topology->processors = lx_alloc(topology->allocator, sizeof(lx_logical_processor_t) * topology->num_processors);
+
+	for (size_t i = 0; i < topology->num_processors; ++i) {
+		topology->processors[i] = (lx_logical_processor_t) {
+			.group = (uint16_t)(i / 64),
+			.number = (uint8_t)(i % 64),
+			.core = (uint32_t)i,
+			.cache = 0,
+			.numa_node = 0
+		};
+	}
+}
+
+static void assign_cache(lx_cpu_topology_t *topology, const GROUP_AFFINITY *mask, uint32_t cache)
+{
+	for (size_t i = 0; i < topology->num_processors; ++i) {
+		if (in_group_mask(mask, &topology->processors[i]))
+			topology->processors[i].cache = cache;
+	}
+}
+
+static void assign_numa_node(lx_cpu_topology_t *topology, const GROUP_AFFINITY *mask, uint32_t numa_node)
+{
+	for (size_t i = 0; i < topology->num_processors; ++i) {
+		if (in_group_mask(mask, &topology->processors[i]))
+			topology->processors[i].numa_node = numa_node;
+	}
+}
+
+static bool detect(lx_cpu_topology_t *topology)
+{
+	DWORD size = 0;
+	if (GetLogicalProcessorInformationEx(RelationAll, NULL, &size) || GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+		return false;
+
+	char *buffer = lx_alloc(topology->allocator, size);
+	if (!GetLogicalProcessorInformationEx(RelationAll, (processor_info_t *)buffer, &size)) {
+		lx_free(topology->allocator, buffer);
+		return false;
+	}
+
+	// Logical processors are listed per core, the last level cache is the highest level reported
+	size_t num_processors = 0;
+	BYTE last_level_cache = 0;
+	processor_info_for(info, buffer, size) {
+		if (info->Relationship == RelationProcessorCore) {
+			for (WORD i = 0; i < info->Processor.GroupCount; ++i) {
+				num_processors += count_processors(&info->Processor.GroupMask[i]);
+			}
+		} else if (info->Relationship == RelationCache) {
+			last_level_cache = lx_max(last_level_cache, info->Cache.Level);
+		}
+	}
+
+	if (num_processors == 0) {
+		lx_free(topology->allocator, buffer);
+		return false;
+	}
+
+	topology->processors = lx_alloc(topology->allocator, sizeof(lx_logical_processor_t) * num_processors);
+	topology->num_processors = 0;
+
+	processor_info_for(info, buffer, size) {
+		if (info->Relationship == RelationProcessorCore) {
+			for (WORD i = 0; i < info->Processor.GroupCount; ++i) {
+				const GROUP_AFFINITY *mask = &info->Processor.GroupMask[i];
+				for (uint8_t number = 0; number < sizeof(KAFFINITY) * 8; ++number) {
+					if (!(mask->Mask & ((KAFFINITY)1 << number)))
+						continue;
+
+					topology->processors[topology->num_processors++] = (lx_logical_processor_t) {
+						.group = mask->Group,
+						.number = number,
+						.core = (uint32_t)topology->num_cores,
+						.cache = 0,
+						.numa_node = 0
+					};
+				}
+			}
+
+			topology->num_cores++;
+		} else if (info->Relationship == RelationCache && info->Cache.Level == last_level_cache) {
+			topology->num_caches++;
+		} else if (info->Relationship == RelationNumaNode) {
+			topology->num_numa_nodes++;
+		}
+	}
+
+	// Caches and NUMA nodes are matched against the processors once all processors are known
+	uint32_t cache = 0;
+	uint32_t numa_node = 0;
+	processor_info_for(info, buffer, size) {
+		if (info->Relationship == RelationCache && info->Cache.Level == last_level_cache) {
+			assign_cache(topology, &info->Cache.GroupMask, cache++);
+		} else if (info->Relationship == RelationNumaNode) {
+			assign_numa_node(topology, &info->NumaNode.GroupMask, numa_node++);
+		}
+	}
+
+	topology->num_caches = lx_max(topology->num_caches, 1);
+	topology->num_numa_nodes = lx_max(topology->num_numa_nodes, 1);
+
+	lx_free(topology->allocator, buffer);
+	return true;
+}
+
+lx_cpu_topology_t *lx_cpu_topology_create(lx_allocator_t *allocator)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+
+	lx_cpu_topology_t *topology = lx_alloc(allocator, sizeof(lx_cpu_topology_t));
+	*topology = (lx_cpu_topology_t) { .allocator = allocator };
+
+	if (!detect(topology)) {
+		*topology = (lx_cpu_topology_t) { .allocator = allocator };
+		detect_fallback(topology);
+	}
+
+	return topology;
+}
+
+void lx_cpu_topology_destroy(lx_cpu_topology_t *topology)
+{
+	LX_ASSERT(topology, "Invalid topology");
+
+	lx_allocator_t *allocator = topology->allocator;
+	lx_free(allocator, topology->processors);
+	lx_free(allocator, topology);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A logical processor, identified by its processor group and its number within the group. Logical
+ * processors with the same core are SMT siblings. Cache is the last level cache shared with other
+ * cores.
+ */
+typedef struct lx_logical_processor {
+	uint16_t group;
+	uint8_t number;
+	uint32_t core;
+	uint32_t cache;
+	uint32_t numa_node;
+} lx_logical_processor_t;
+
+/*
+ * Logical processors ordered by core, cores, caches and NUMA nodes are numbered from 0.
+ */
+typedef struct lx_cpu_topology {
+	lx_allocator_t *allocator;
+	lx_logical_processor_t *processors;
+	size_t num_processors;
+	size_t num_cores;
+	size_t num_caches;
+	size_t num_numa_nodes;
+} lx_cpu_topology_t;
+
+/*
+ * Detect the processors of the machine. If the system can't be queried every logical processor is
+ * reported as a core of its own, sharing a single cache and NUMA node.
+ */
+lx_cpu_topology_t *lx_cpu_topology_create(lx_allocator_t *allocator);
+
+void lx_cpu_topology_destroy(lx_cpu_topology_t *topology);
+
+/*
+ * How close two logical processors are, 0 for SMT siblings, 1 when sharing cache, 2 when on the
+ * same NUMA node and 3 otherwise.
+ */
+static LX_INLINE uint32_t lx_logical_processor_distance(const lx_logical_processor_t *a, const lx_logical_processor_t *b)
+{
+	if (a->core == b->core)
+		return 0;
+
+	if (a->cache == b->cache)
+		return 1;
+
+	return a->numa_node == b->numa_node ? 2 : 3;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,122 @@
+#include <luxa/threading/task/parallel_for.h>
+#include <luxa/threading/threading.h>
+
+// Chunks per thread when picking the grain size, more chunks balance better but cost more atomics
+#define PARALLEL_FOR_CHUNKS_PER_THREAD 8
+
+// Helper tasks are kept on the stack so they can be destroyed after the join, more are allocated
+#define PARALLEL_FOR_STACK_TASKS 64
+
+typedef struct parallel_for_state {
+	volatile int64_t next_chunk;
+	int64_t num_chunks;
+	size_t begin;
+	size_t end;
+	size_t grain_size;
+	lx_parallel_for_function_t f;
+	lx_any_t argument;
+} parallel_for_state_t;
+
+typedef struct parallel_range_state {
+	lx_range_t range;
+	lx_parallel_range_function_t f;
+	lx_any_t argument;
+} parallel_range_state_t;
+
+static void run_chunks(parallel_for_state_t *state)
+{
+	int64_t chunk;
+	while ((chunk = lx_atomic_add_64(&state->next_chunk, 1) - 1) < state->num_chunks) {
+		const size_t begin = state->begin + (size_t)chunk * state->grain_size;
+		const size_t end = lx_min(begin + state->grain_size, state->end);
+		state->f(begin, end, state->argument);
+	}
+}
+
+static void run_chunks_task(lx_task_factory_t *factory, lx_task_t *task, parallel_for_state_t *state)
+{
+	run_chunks(state);
+}
+
+static void join_task(lx_task_factory_t *factory, lx_task_t *task, lx_any_t argument)
+{
+}
+
+void lx_parallel_for(lx_task_factory_t *factory, size_t begin, size_t end, size_t grain_size, lx_parallel_for_function_t f, lx_any_t argument)
+{
+	LX_ASSERT(factory, "Invalid factory");
+	LX_ASSERT(f, "Invalid function");
+
+	if (begin >= end)
+		return;
+
+	const size_t count = end - begin;
+	const size_t num_threads = lx_task_num_workers(factory);
+
+	if (!grain_size)
+		grain_size = lx_max(count / (num_threads * PARALLEL_FOR_CHUNKS_PER_THREAD), 1);
+
+	parallel_for_state_t state = {
+		.next_chunk = 0,
+		.num_chunks = (int64_t)((count + grain_size - 1) / grain_size),
+		.begin = begin,
+		.end = end,
+		.grain_size = grain_size,
+		.f = f,
+		.argument = argument
+	};
+
+	// Small ranges are not worth waking other workers for
+	if (state.num_chunks == 1) {
+		f(begin, end, argument);
+		return;
+	}
+
+	// Every other thread gets a task that claims chunks, the calling thread claims chunks as well
+	const size_t num_tasks = lx_min(num_threads, (size_t)state.num_chunks) - 1;
+	lx_task_t *stack_tasks[PARALLEL_FOR_STACK_TASKS];
+	lx_task_t **tasks = num_tasks > PARALLEL_FOR_STACK_TASKS ? lx_alloc(lx_allocator_default(), num_tasks * sizeof(lx_task_t *)) : stack_tasks;
+	lx_task_t *join = lx_task_create(factory, join_task, NULL);
+	for (size_t i = 0; i < num_tasks; ++i) {
+		tasks[i] = lx_task_create_child(factory, join, run_chunks_task, &state);
+		lx_task_start(factory, tasks[i]);
+	}
+
+	run_chunks(&state);
+
+	lx_task_start(factory, join);
+	lx_task_wait(factory, join);
+
+	// Children are marked finished before the join finishes, so all of them can be released
+	for (size_t i = 0; i < num_tasks; ++i) {
+		lx_task_destroy(factory, tasks[i]);
+	}
+
+	if (tasks != stack_tasks)
+		lx_free(lx_allocator_default(), tasks);
+
+	lx_task_destroy(factory, join);
+}
+
+static void run_range(size_t begin, size_t end, parallel_range_state_t *state)
+{
+	const size_t step_size = state->range.step_size;
+
+	lx_range_t range = {
+		.begin = (char *)state->range.begin + begin * step_size,
+		.end = (char *)state->range.begin + end * step_size,
+		.step_size = step_size
+	};
+
+	state->f(range, state->argument);
+}
+
+void lx_parallel_range(lx_task_factory_t *factory, lx_range_t range, size_t grain_size, lx_parallel_range_function_t f, lx_any_t argument)
+{
+	LX_ASSERT(range.step_size, "Invalid range");
+
+	parallel_range_state_t state = { .range = range, .f = f, .argument = argument };
+	const size_t count = (size_t)((char *)range.end - (char *)range.begin) / range.step_size;
+
+	lx_parallel_for(factory, 0, count, grain_size, run_range, &state);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/threading/task/task.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*lx_parallel_for_function_t)(size_t begin, size_t end, lx_any_t argument);
+
+typedef void (*lx_parallel_range_function_t)(lx_range_t range, lx_any_t argument);
+
+/*
+ * Call f for chunks of [begin, end) in parallel and return when all chunks are done. Chunks are
+ * claimed dynamically by the workers and the calling thread, so uneven work is balanced
+ * automatically. A grain size of zero picks a chunk size from the number of workers.
+ */
+void lx_parallel_for(lx_task_factory_t *factory, size_t begin, size_t end, size_t grain_size, lx_parallel_for_function_t f, lx_any_t argument);
+
+/*
+ * Same as lx_parallel_for but over the elements of a range, f is called with sub ranges.
+ */
+void lx_parallel_range(lx_task_factory_t *factory, lx_range_t range, size_t grain_size, lx_parallel_range_function_t f, lx_any_t argument);
+
+#ifdef __cplusplus
+}
+#endif
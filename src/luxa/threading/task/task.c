@@ -1,28 +1,137 @@
 #include <luxa/threading/task/task.h>
 #include <luxa/threading/threading.h>
+#include <luxa/threading/work_stealing_deque.h>
+#include <luxa/threading/cpu_topology.h>
+#include <luxa/chrono.h>
+#include <stdio.h>
 #include <luxa/collections/array.h>
 #include <luxa/collections/queue.h>
-#include <luxa/memory/block_allocator.h>
+#include <luxa/memory/pool_allocator.h>
 
+#define TASK_DEQUE_CAPACITY 1024
+
+// Most tasks taken from a victim in one steal, the first is run and the rest are queued locally
+#define TASK_MAX_STEAL_BATCH 32
+
+// Victims are grouped by the distance between the processors of the workers, see lx_logical_processor_distance
+#define TASK_NUM_VICTIM_TIERS 4
+
+// Idle workers spin, then yield and finally go to sleep until new tasks are started
+#define TASK_IDLE_SPIN_ROUNDS 64
+#define TASK_IDLE_YIELD_ROUNDS 16
+
+// Marks the continuation and waiting fiber lists of a finished task
+#define TASK_FINISHED ((lx_any_t)(uintptr_t)1)
+
+#define TASK_DEFAULT_NUM_FIBERS 128
+#define TASK_DEFAULT_FIBER_STACK_SIZE (256 * 1024)
+
+/*
+ * A task is unfinished until its own function and all of its children have run. Continuations and
+ * suspended fibers waiting for the task are kept in lock-free lists that are swapped for
+ * TASK_FINISHED when the task finishes. The finished flag is set last, once it's set nothing
+ * touches the task anymore and it can be reset or destroyed.
+ */
 struct lx_task {
 	lx_task_function_t f;
 	lx_any_t arg;
 	lx_task_t *parent;
-	int32_t unfinishedTasks;
+	volatile int32_t unfinishedTasks;
+	volatile lx_any_t continuations; // lx_task_t
+	lx_task_t *next_continuation;
+	volatile lx_any_t waiting_fibers; // task_fiber_t
+	volatile int32_t finished;
+	lx_task_priority_t priority;
+	bool pinned;
+	const char *name;
 };
 
+typedef struct trace_event {
+    const char *name;
+    int64_t begin;
+    int64_t end;
+} trace_event_t;
+
+typedef struct task_fiber {
+    lx_fiber_t fiber;
+    lx_task_factory_t *factory;
+    struct task_fiber *next; // Free, ready or waiting list
+} task_fiber_t;
+
+/*
+ * A fiber can't be added to a shared list before it has been switched away from, the fiber that
+ * takes over the thread does it instead.
+ */
+typedef enum fiber_action {
+    FIBER_ACTION_NONE,
+    FIBER_ACTION_FREE,
+    FIBER_ACTION_WAIT
+} fiber_action_t;
+
 typedef struct task_worker {
-	lx_allocator_t *task_allocator;
-	lx_queue_t *queue;
-    lx_mutex_t mutex;
+    lx_work_stealing_deque_t *deques[LX_TASK_NUM_PRIORITIES]; // lx_task_t*
     lx_thread_t thread;
+    uint32_t random_state;
+
+    // Other workers ordered by distance, nearest first. Victims within a tier are tried in random order
+    const lx_logical_processor_t *processor;
+    uint64_t affinity_mask;
+    struct task_worker **victims;
+    size_t victim_tier_end[TASK_NUM_VICTIM_TIERS];
+
+    // Only written by the thread owning the worker
+    volatile int64_t num_tasks_executed;
+    volatile int64_t num_steal_attempts;
+    volatile int64_t num_successful_steals;
+    volatile int64_t num_tasks_stolen;
+    volatile int64_t idle_ticks;
+    volatile int64_t idle_begin;
+
+    // Ring of the most recent task events, only allocated when tracing
+    trace_event_t *trace_events;
+    volatile int64_t num_trace_events;
+
+    // Fiber mode only, fibers move between threads so the worker is always read from thread local storage
+    lx_fiber_t thread_fiber;
+    task_fiber_t *current_fiber;
+    fiber_action_t fiber_action;
+    task_fiber_t *action_fiber;
+    lx_task_t *action_task;
 } task_worker_t;
 
 typedef struct factory_state {
     lx_allocator_t *allocator;
-    lx_array_t *workers; // task_worker_t
+    lx_allocator_t *task_allocator;
+    lx_array_t *workers; // task_worker_t*
+    lx_cpu_topology_t *topology;
+    lx_highres_clock_t clock;
+    int64_t start_ticks;
+    size_t trace_capacity;
     lx_thread_local_storage_t local_storage;
     volatile bool process_tasks;
+
+    // Sleeping workers and waiting threads
+    lx_mutex_t sleep_mutex;
+    lx_condition_variable_t wake_condition;
+    volatile int32_t num_queued_tasks;
+    volatile int32_t num_sleeping;
+    volatile int32_t num_waiting;
+
+    // Tasks pinned to the thread that created the factory, not counted as queued tasks
+    task_worker_t *main_worker;
+    lx_mutex_t main_thread_mutex;
+    lx_queue_t *main_thread_tasks; // lx_task_t*
+    volatile int32_t num_main_thread_tasks;
+
+    // Fiber pool, the free and ready lists are guarded by the fiber mutex
+    bool use_fibers;
+    task_fiber_t *fibers;
+    size_t num_fibers;
+    lx_mutex_t fiber_mutex;
+    task_fiber_t *free_fibers;
+    task_fiber_t *ready_fibers;
+    task_fiber_t *last_ready_fiber;
+    volatile int32_t num_ready_fibers;
 } factory_state_t;
 
 typedef struct task_worker_args {
@@ -30,50 +139,446 @@ typedef struct task_worker_args {
     task_worker_t* worker;
 } task_worker_args_t;
 
-lx_task_t *try_dequeue_task(task_worker_t *worker)
+static uint32_t next_random(task_worker_t *worker)
 {
-	lx_task_t *task = NULL;
+	// xorshift32, each worker has its own state so no locking is needed
+	uint32_t x = worker->random_state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	worker->random_state = x;
+	return x;
+}
 
-    lx_mutex_scope(&worker->mutex, {
-        if (!lx_queue_is_empty(worker->queue)) {
-            task = *((lx_task_t **)lx_queue_front(worker->queue));
-            lx_queue_dequeue(worker->queue);
-        }
-    });
+/*
+ * Steal half of the tasks of the given priority from the victim. The oldest task is returned and
+ * the rest are pushed to the local deque.
+ */
+lx_task_t *steal_task(task_worker_t *global_worker, task_worker_t *local_worker, lx_task_priority_t priority)
+{
+	lx_any_t tasks[TASK_MAX_STEAL_BATCH];
 
-	return task;
+	local_worker->num_steal_attempts += 1;
+	size_t num_tasks = lx_work_stealing_deque_steal_half(global_worker->deques[priority], tasks, TASK_MAX_STEAL_BATCH);
+	if (num_tasks == 0)
+		return NULL;
+
+	local_worker->num_successful_steals += 1;
+	local_worker->num_tasks_stolen += (int64_t)num_tasks;
+
+	for (size_t i = 1; i < num_tasks; ++i) {
+		lx_work_stealing_deque_push(local_worker->deques[priority], tasks[i]);
+	}
+
+	return tasks[0];
 }
 
-lx_task_t *steal_task(task_worker_t *global_worker, task_worker_t *local_worker)
+static lx_task_t *next_main_thread_task(factory_state_t *state)
 {
-	return global_worker != local_worker ? try_dequeue_task(global_worker) : NULL;
+	if (!lx_atomic_exchange_32(&state->num_main_thread_tasks, 0, 0))
+		return NULL;
+
+	lx_task_t *task = NULL;
+
+	lx_mutex_lock(&state->main_thread_mutex);
+
+	if (!lx_queue_is_empty(state->main_thread_tasks)) {
+		task = *(lx_task_t **)lx_queue_front(state->main_thread_tasks);
+		lx_queue_dequeue(state->main_thread_tasks);
+		lx_atomic_decrement_32(&state->num_main_thread_tasks);
+	}
+
+	lx_mutex_unlock(&state->main_thread_mutex);
+
+	return task;
 }
 
 lx_task_t *next_task(lx_task_factory_t *factory, task_worker_t *local_worker)
 {
 	factory_state_t *state = (factory_state_t *)factory->state;
-	
-	// Try dequeue from thread local queue
-	lx_task_t *task = try_dequeue_task(local_worker);
-	if (task)
-		return task;
 
-    // Steel work from another worker
-	int i = rand() % lx_array_size(state->workers);
-	task_worker_t *global_worker = lx_array_at(state->workers, (size_t)i);
+	if (local_worker == state->main_worker) {
+		lx_task_t *task = next_main_thread_task(state);
+		if (task)
+			return task;
+	}
+
+	const uint32_t random = next_random(local_worker);
+
+	for (lx_task_priority_t priority = 0; priority < LX_TASK_NUM_PRIORITIES; ++priority) {
+		// Try pop from thread local deque
+		lx_task_t *task = lx_work_stealing_deque_pop(local_worker->deques[priority]);
+		if (task)
+			return task;
+
+		// Steal work from the other workers, nearest first
+		size_t tier_begin = 0;
+		for (size_t tier = 0; tier < TASK_NUM_VICTIM_TIERS; ++tier) {
+			const size_t tier_end = local_worker->victim_tier_end[tier];
+			const size_t tier_size = tier_end - tier_begin;
+
+			for (size_t i = 0; i < tier_size; ++i) {
+				task_worker_t *global_worker = local_worker->victims[tier_begin + (random + i) % tier_size];
+				if (!lx_work_stealing_deque_size(global_worker->deques[priority]))
+					continue;
+
+				task = steal_task(global_worker, local_worker, priority);
+				if (task)
+					return task;
+			}
+
+			tier_begin = tier_end;
+		}
+	}
+
+	return NULL;
+}
+
+static void wake_sleeping(factory_state_t *state, bool all)
+{
+    lx_mutex_lock(&state->sleep_mutex);
+
+    if (all) {
+        lx_condition_variable_notify_all(&state->wake_condition);
+    } else {
+        lx_condition_variable_notify_one(&state->wake_condition);
+    }
+
+    lx_mutex_unlock(&state->sleep_mutex);
+}
+
+static void start_task(lx_task_factory_t *factory, lx_task_t *task);
+
+static void begin_idle(task_worker_t *worker)
+{
+    if (!worker->idle_begin)
+        worker->idle_begin = lx_highres_clock_now();
+}
+
+static void end_idle(task_worker_t *worker)
+{
+    if (worker->idle_begin) {
+        worker->idle_ticks += lx_highres_clock_now() - worker->idle_begin;
+        worker->idle_begin = 0;
+    }
+}
+
+static task_fiber_t *pop_free_fiber(factory_state_t *state)
+{
+    lx_mutex_lock(&state->fiber_mutex);
+
+    task_fiber_t *fiber = state->free_fibers;
+    if (fiber)
+        state->free_fibers = fiber->next;
+
+    lx_mutex_unlock(&state->fiber_mutex);
+
+    return fiber;
+}
+
+static void push_free_fiber(factory_state_t *state, task_fiber_t *fiber)
+{
+    lx_mutex_lock(&state->fiber_mutex);
+
+    fiber->next = state->free_fibers;
+    state->free_fibers = fiber;
+
+    lx_mutex_unlock(&state->fiber_mutex);
+}
+
+/*
+ * Queue a list of suspended fibers to be resumed.
+ */
+static void push_ready_fibers(factory_state_t *state, task_fiber_t *fibers)
+{
+    int32_t count = 1;
+    task_fiber_t *last = fibers;
+    while (last->next) {
+        last = last->next;
+        ++count;
+    }
+
+    lx_mutex_lock(&state->fiber_mutex);
+
+    if (state->last_ready_fiber) {
+        state->last_ready_fiber->next = fibers;
+    } else {
+        state->ready_fibers = fibers;
+    }
+    state->last_ready_fiber = last;
+
+    lx_mutex_unlock(&state->fiber_mutex);
+
+    for (int32_t i = 0; i < count; ++i)
+        lx_atomic_increment_32(&state->num_ready_fibers);
+}
+
+static task_fiber_t *pop_ready_fiber(factory_state_t *state)
+{
+    if (!lx_atomic_exchange_32(&state->num_ready_fibers, 0, 0))
+        return NULL;
+
+    lx_mutex_lock(&state->fiber_mutex);
+
+    task_fiber_t *fiber = state->ready_fibers;
+    if (fiber) {
+        state->ready_fibers = fiber->next;
+        if (!state->ready_fibers)
+            state->last_ready_fiber = NULL;
+        lx_atomic_decrement_32(&state->num_ready_fibers);
+    }
+
+    lx_mutex_unlock(&state->fiber_mutex);
+
+    return fiber;
+}
+
+/*
+ * Run the action left by the fiber that was switched away from, must be called every time a
+ * fiber starts or continues running.
+ */
+static void run_fiber_action(factory_state_t *state, task_fiber_t *self)
+{
+    task_worker_t *worker = lx_thread_local_get_value(state->local_storage);
+    worker->current_fiber = self;
+
+    task_fiber_t *fiber = worker->action_fiber;
+    lx_task_t *task = worker->action_task;
+    fiber_action_t action = worker->fiber_action;
+    worker->fiber_action = FIBER_ACTION_NONE;
+    worker->action_fiber = NULL;
+    worker->action_task = NULL;
 
-	return steal_task(global_worker, local_worker);
+    if (action == FIBER_ACTION_FREE) {
+        push_free_fiber(state, fiber);
+    } else if (action == FIBER_ACTION_WAIT) {
+        lx_any_t head;
+        do {
+            head = task->waiting_fibers;
+            if (head == TASK_FINISHED) {
+                fiber->next = NULL;
+                push_ready_fibers(state, fiber);
+                return;
+            }
+
+            fiber->next = head;
+        } while (lx_atomic_exchange_ptr(&task->waiting_fibers, fiber, head) != head);
+    }
+}
+
+static void switch_fiber(factory_state_t *state, task_fiber_t *self, task_fiber_t *fiber, fiber_action_t action, lx_task_t *task)
+{
+    task_worker_t *worker = lx_thread_local_get_value(state->local_storage);
+    end_idle(worker);
+    worker->fiber_action = action;
+    worker->action_fiber = self;
+    worker->action_task = task;
+
+    lx_fiber_switch(fiber->fiber);
+    run_fiber_action(state, self);
 }
 
-void execute_next_task(lx_task_factory_t *factory, task_worker_t *worker)
+/*
+ * Continue running a suspended fiber whose task has finished, the current fiber goes back to the pool.
+ */
+static bool resume_ready_fiber(factory_state_t *state, task_fiber_t *self)
 {
+    task_fiber_t *fiber = pop_ready_fiber(state);
+    if (!fiber)
+        return false;
+
+    switch_fiber(state, self, fiber, FIBER_ACTION_FREE, NULL);
+    return true;
+}
+
+/*
+ * Suspend the current fiber until the task has finished and let the worker continue on a resumed
+ * fiber or a fiber from the pool. Returns false if there is no fiber to continue on.
+ */
+static bool suspend_fiber(factory_state_t *state, task_fiber_t *self, lx_task_t *task)
+{
+    task_fiber_t *fiber = pop_ready_fiber(state);
+    if (!fiber)
+        fiber = pop_free_fiber(state);
+
+    if (!fiber)
+        return false;
+
+    switch_fiber(state, self, fiber, FIBER_ACTION_WAIT, task);
+    return true;
+}
+
+static void finish_task(lx_task_factory_t *factory, lx_task_t *task);
+
+/*
+ * Record a task that ran from begin until now on the worker of the calling thread. A task that was
+ * suspended on a fiber is recorded on the worker it finished on.
+ */
+static void record_trace_event(factory_state_t *state, lx_task_t *task, int64_t begin)
+{
+    task_worker_t *worker = lx_thread_local_get_value(state->local_storage);
+
+    const int64_t i = worker->num_trace_events;
+    worker->trace_events[i % (int64_t)state->trace_capacity] = (trace_event_t) {
+        .name = task->name,
+        .begin = begin,
+        .end = lx_highres_clock_now()
+    };
+
+    lx_atomic_store_64(&worker->num_trace_events, i + 1);
+}
+
+static void run_task(lx_task_factory_t *factory, task_worker_t *worker, lx_task_t *task)
+{
+    factory_state_t *state = (factory_state_t *)factory->state;
+
+    worker->num_tasks_executed += 1;
+
+    if (state->trace_capacity) {
+        const int64_t begin = lx_highres_clock_now();
+        task->f(factory, task, task->arg);
+        record_trace_event(state, task, begin);
+    } else {
+        task->f(factory, task, task->arg);
+    }
+
+    finish_task(factory, task);
+}
+
+static void finish_task(lx_task_factory_t *factory, lx_task_t *task)
+{
+    factory_state_t *state = (factory_state_t *)factory->state;
+
+    if (lx_atomic_decrement_32(&task->unfinishedTasks) != 0)
+        return;
+
+    // A waiting thread may reset or destroy the task as soon as it's marked finished
+    lx_task_t *parent = task->parent;
+
+    lx_task_t *continuation = lx_atomic_swap_ptr(&task->continuations, TASK_FINISHED);
+    while (continuation) {
+        lx_task_t *next_continuation = continuation->next_continuation;
+        start_task(factory, continuation);
+        continuation = next_continuation;
+    }
+
+    task_fiber_t *fibers = NULL;
+    if (state->use_fibers)
+        fibers = lx_atomic_swap_ptr(&task->waiting_fibers, TASK_FINISHED);
+
+    lx_atomic_exchange_32(&task->finished, 1, 0);
+
+    if (fibers)
+        push_ready_fibers(state, fibers);
+
+    if (parent)
+        finish_task(factory, parent);
+
+    // Threads waiting for a task sleep on the same condition as idle workers, and only worker
+    // threads can resume fibers so everyone is woken up
+    if (fibers || lx_atomic_exchange_32(&state->num_waiting, 0, 0))
+        wake_sleeping(state, true);
+}
+
+bool execute_next_task(lx_task_factory_t *factory, task_worker_t *worker)
+{
+    factory_state_t *state = (factory_state_t *)factory->state;
+
 	lx_task_t *task = next_task(factory, worker);
     if (!task) {
-        return;
+        return false;
     }
     
-    task->f(factory, task, task->arg);
-	lx_atomic_decrement_32(&task->unfinishedTasks);
+    if (!task->pinned)
+        lx_atomic_decrement_32(&state->num_queued_tasks);
+
+    end_idle(worker);
+    run_task(factory, worker, task);
+
+    return true;
+}
+
+/*
+ * Spin and then yield while idle, returns true once it's time to go to sleep.
+ */
+static bool idle_backoff(uint32_t *idle_rounds)
+{
+    const uint32_t rounds = (*idle_rounds)++;
+
+    if (rounds < TASK_IDLE_SPIN_ROUNDS) {
+        lx_thread_pause();
+        return false;
+    }
+
+    if (rounds < TASK_IDLE_SPIN_ROUNDS + TASK_IDLE_YIELD_ROUNDS) {
+        lx_thread_yield();
+        return false;
+    }
+
+    *idle_rounds = 0;
+    return true;
+}
+
+/*
+ * Sleep until a task is started, a suspended fiber can be resumed or, when waiting for a task,
+ * until the task is finished. The counters are updated with full barriers before the conditions
+ * are checked, which together with the notifications being sent under the mutex means no wake up
+ * is lost.
+ */
+static void park_thread(factory_state_t *state, task_worker_t *worker, lx_task_t *waiting_task)
+{
+    const bool resumes_fibers = worker->current_fiber != NULL;
+    const bool is_main_thread = worker == state->main_worker;
+
+    volatile int32_t *num_sleeping = waiting_task ? &state->num_waiting : &state->num_sleeping;
+
+    lx_mutex_lock(&state->sleep_mutex);
+    lx_atomic_increment_32(num_sleeping);
+
+    while (state->process_tasks && !lx_atomic_exchange_32(&state->num_queued_tasks, 0, 0)) {
+        if (waiting_task && lx_atomic_exchange_32(&waiting_task->finished, 0, 0))
+            break;
+
+        if (resumes_fibers && lx_atomic_exchange_32(&state->num_ready_fibers, 0, 0))
+            break;
+
+        if (is_main_thread && lx_atomic_exchange_32(&state->num_main_thread_tasks, 0, 0))
+            break;
+
+        lx_condition_variable_wait(&state->wake_condition, &state->sleep_mutex);
+    }
+
+    lx_atomic_decrement_32(num_sleeping);
+    lx_mutex_unlock(&state->sleep_mutex);
+}
+
+/*
+ * Worker loop of the fiber pool. Finished waits are resumed before new tasks are picked up, the
+ * fiber switches back to the thread when the factory is destroyed.
+ */
+static void fiber_main(task_fiber_t *self)
+{
+    lx_task_factory_t *factory = self->factory;
+    factory_state_t *state = (factory_state_t *)factory->state;
+
+    run_fiber_action(state, self);
+
+    uint32_t idle_rounds = 0;
+    while (state->process_tasks) {
+        task_worker_t *worker = lx_thread_local_get_value(state->local_storage);
+        if (resume_ready_fiber(state, self) || execute_next_task(factory, worker)) {
+            idle_rounds = 0;
+            continue;
+        }
+
+        begin_idle(worker);
+        if (idle_backoff(&idle_rounds))
+            park_thread(state, worker, NULL);
+    }
+
+    task_worker_t *worker = lx_thread_local_get_value(state->local_storage);
+    worker->current_fiber = NULL;
+    lx_fiber_switch(worker->thread_fiber);
 }
 
 unsigned long do_work(task_worker_args_t *args)
@@ -84,9 +589,28 @@ unsigned long do_work(task_worker_args_t *args)
     lx_free(state->allocator, args);
 
     lx_thread_local_set_value(state->local_storage, worker);
+
+    if (state->use_fibers) {
+        task_fiber_t *fiber = pop_free_fiber(state);
+        LX_ASSERT(fiber, "Fiber pool is smaller than the number of threads");
+
+        worker->thread_fiber = lx_fiber_convert_thread(NULL);
+        lx_fiber_switch(fiber->fiber);
+        lx_fiber_convert_to_thread();
+
+        return 0;
+    }
     
+    uint32_t idle_rounds = 0;
     while (state->process_tasks) {
-		execute_next_task(factory, worker);
+		if (execute_next_task(factory, worker)) {
+            idle_rounds = 0;
+            continue;
+        }
+
+        begin_idle(worker);
+        if (idle_backoff(&idle_rounds))
+            park_thread(state, worker, NULL);
 	}
     
     return 0;
@@ -98,41 +622,209 @@ task_worker_t *create_task_worker(lx_task_factory_t *task_factory)
     task_worker_t * worker = lx_alloc(state->allocator, sizeof(task_worker_t));
     *worker = (task_worker_t) { 0 };
 
-	worker->task_allocator = lx_block_allocator_create(state->allocator, sizeof(lx_task_t), 1024);
-	worker->queue = lx_queue_create(state->allocator, sizeof(lx_task_t*));
-    lx_mutex_create(&worker->mutex);
+	for (size_t i = 0; i < LX_TASK_NUM_PRIORITIES; ++i) {
+		worker->deques[i] = lx_work_stealing_deque_create(state->allocator, TASK_DEQUE_CAPACITY);
+	}
+
+	if (state->trace_capacity)
+		worker->trace_events = lx_alloc(state->allocator, sizeof(trace_event_t) * state->trace_capacity);
 
 	return worker;
 }
 
 void destroy_task_worker(lx_allocator_t *allocator, task_worker_t *worker)
 {
-	lx_block_allocator_destroy(worker->task_allocator);
-	lx_queue_destroy(worker->queue);
-    lx_mutex_destroy(&worker->mutex);
-    lx_thread_destroy(&worker->thread);
+	for (size_t i = 0; i < LX_TASK_NUM_PRIORITIES; ++i) {
+		lx_work_stealing_deque_destroy(worker->deques[i]);
+	}
+    if (worker->thread.handle)
+        lx_thread_destroy(&worker->thread);
+    if (worker->victims)
+        lx_free(allocator, worker->victims);
+    if (worker->trace_events)
+        lx_free(allocator, worker->trace_events);
+    lx_free(allocator, worker);
 }
 
-factory_state_t *create_factory_state(lx_task_factory_t *task_factory, lx_allocator_t *allocator, size_t num_threads)
+static void create_fibers(lx_task_factory_t *task_factory, const lx_task_factory_options_t *options, size_t num_threads)
 {
+    factory_state_t *state = (factory_state_t *)task_factory->state;
+
+    size_t stack_size = options->fiber_stack_size ? options->fiber_stack_size : TASK_DEFAULT_FIBER_STACK_SIZE;
+    state->num_fibers = options->num_fibers ? options->num_fibers : TASK_DEFAULT_NUM_FIBERS;
+    LX_ASSERT(state->num_fibers > num_threads, "Every thread needs a fiber and waits need at least one more");
+
+    state->fibers = lx_alloc(state->allocator, sizeof(task_fiber_t) * state->num_fibers);
+    for (size_t i = 0; i < state->num_fibers; ++i) {
+        task_fiber_t *fiber = &state->fibers[i];
+        fiber->factory = task_factory;
+        fiber->fiber = lx_fiber_create(stack_size, (lx_fiber_start_t)fiber_main, fiber);
+        fiber->next = state->free_fibers;
+        state->free_fibers = fiber;
+    }
+}
+
+typedef struct processor_slot {
+    const lx_logical_processor_t *processor;
+    uint32_t sibling;
+} processor_slot_t;
+
+/*
+ * Spread over cores before SMT siblings, keeping cores that share cache and NUMA node next to each other.
+ */
+static int compare_processor_slots(const void *a, const void *b)
+{
+    const processor_slot_t *x = a;
+    const processor_slot_t *y = b;
+
+    if (x->sibling != y->sibling)
+        return x->sibling < y->sibling ? -1 : 1;
+
+    if (x->processor->numa_node != y->processor->numa_node)
+        return x->processor->numa_node < y->processor->numa_node ? -1 : 1;
+
+    if (x->processor->cache != y->processor->cache)
+        return x->processor->cache < y->processor->cache ? -1 : 1;
+
+    return x->processor->core < y->processor->core ? -1 : (x->processor->core > y->processor->core ? 1 : 0);
+}
+
+/*
+ * Assign a logical processor to every worker thread. The first slot is left to the calling thread,
+ * which is never pinned by the factory.
+ */
+static void assign_processors(factory_state_t *state, lx_task_thread_affinity_t affinity, size_t num_threads)
+{
+    const lx_cpu_topology_t *topology = state->topology;
+    processor_slot_t *slots = lx_alloc(state->allocator, sizeof(processor_slot_t) * topology->num_processors);
+    size_t num_slots = 0;
+
+    // Processors are listed per core
+    uint32_t sibling = 0;
+    for (size_t i = 0; i < topology->num_processors; ++i) {
+        const lx_logical_processor_t *processor = &topology->processors[i];
+        sibling = (i > 0 && processor->core == topology->processors[i - 1].core) ? sibling + 1 : 0;
+
+        if (affinity == LX_TASK_THREAD_AFFINITY_CORE && sibling > 0)
+            continue;
+
+        slots[num_slots++] = (processor_slot_t) { processor, sibling };
+    }
+
+    qsort(slots, num_slots, sizeof(processor_slot_t), compare_processor_slots);
+
+    for (size_t i = 0; i < num_threads; ++i) {
+        task_worker_t *worker = *(task_worker_t **)lx_array_at(state->workers, i);
+        worker->processor = slots[(i + 1) % num_slots].processor;
+        worker->affinity_mask = 0;
+
+        for (size_t j = 0; j < topology->num_processors; ++j) {
+            const lx_logical_processor_t *processor = &topology->processors[j];
+            bool same_core = processor->core == worker->processor->core && processor->group == worker->processor->group;
+            bool included = affinity == LX_TASK_THREAD_AFFINITY_CORE ? same_core : processor == worker->processor;
+
+            if (included)
+                worker->affinity_mask |= (uint64_t)1 << processor->number;
+        }
+    }
+
+    lx_free(state->allocator, slots);
+}
+
+static uint32_t worker_distance(const task_worker_t *a, const task_worker_t *b)
+{
+    if (!a->processor || !b->processor)
+        return TASK_NUM_VICTIM_TIERS - 1;
+
+    return lx_logical_processor_distance(a->processor, b->processor);
+}
+
+static void build_victims(factory_state_t *state, task_worker_t *worker)
+{
+    const size_t num_workers = lx_array_size(state->workers);
+    worker->victims = lx_alloc(state->allocator, sizeof(task_worker_t *) * lx_max(num_workers - 1, 1));
+
+    size_t num_victims = 0;
+    for (size_t tier = 0; tier < TASK_NUM_VICTIM_TIERS; ++tier) {
+        for (size_t i = 0; i < num_workers; ++i) {
+            task_worker_t *victim = *(task_worker_t **)lx_array_at(state->workers, i);
+            if (victim != worker && worker_distance(worker, victim) == tier)
+                worker->victims[num_victims++] = victim;
+        }
+
+        worker->victim_tier_end[tier] = num_victims;
+    }
+}
+
+factory_state_t *create_factory_state(lx_task_factory_t *task_factory, lx_allocator_t *allocator, const lx_task_factory_options_t *options)
+{
+    size_t num_threads = options->num_threads;
+    lx_cpu_topology_t *topology = NULL;
+
+    if (options->thread_affinity != LX_TASK_THREAD_AFFINITY_NONE || num_threads == LX_TASK_NUM_THREADS_AUTO)
+        topology = lx_cpu_topology_create(allocator);
+
+    // One thread per core, the calling thread takes the first
+    if (num_threads == LX_TASK_NUM_THREADS_AUTO)
+        num_threads = topology->num_cores - 1;
+
     factory_state_t *state = lx_alloc(allocator, sizeof(factory_state_t));
     *state = (factory_state_t) {
         .allocator = allocator,
-        .workers = lx_array_create(allocator, sizeof(task_worker_t)),
+        .task_allocator = lx_pool_allocator_create(allocator),
+        .workers = lx_array_create(allocator, sizeof(task_worker_t *)),
+        .topology = topology,
         .local_storage = lx_thread_local_create_storage(),
-		.process_tasks = true
+		.process_tasks = true,
+        .num_queued_tasks = 0,
+        .num_sleeping = 0,
+        .num_waiting = 0,
+        .main_thread_tasks = lx_queue_create(allocator, sizeof(lx_task_t *)),
+        .num_main_thread_tasks = 0,
+        .use_fibers = options->use_fibers,
+        .start_ticks = lx_highres_clock_now(),
+        .trace_capacity = options->trace_capacity
     };
 
+    lx_highres_clock_create(&state->clock);
+
+    lx_mutex_create(&state->sleep_mutex);
+    lx_condition_variable_create(&state->wake_condition);
+    lx_mutex_create(&state->main_thread_mutex);
+    lx_mutex_create(&state->fiber_mutex);
+
 	task_factory->state = (lx_task_factory_state_t *)state;
 
-    for (size_t i = 0; i < num_threads; ++i) {
+    if (state->use_fibers)
+        create_fibers(task_factory, options, num_threads);
+
+    // Create all workers, including one for the calling thread, before any thread starts stealing
+    for (size_t i = 0; i <= num_threads; ++i) {
         task_worker_t *worker = create_task_worker(task_factory);
-		lx_array_push_back(state->workers, worker);
+        worker->random_state = (uint32_t)(i + 1) * 2654435761u;
+		lx_array_push_back(state->workers, &worker);
+    }
+
+	state->main_worker = *(task_worker_t **)lx_array_at(state->workers, num_threads);
+	lx_thread_local_set_value(state->local_storage, state->main_worker);
+
+    if (options->thread_affinity != LX_TASK_THREAD_AFFINITY_NONE)
+        assign_processors(state, options->thread_affinity, num_threads);
+
+    for (size_t i = 0; i <= num_threads; ++i) {
+        build_victims(state, *(task_worker_t **)lx_array_at(state->workers, i));
+    }
+
+    for (size_t i = 0; i < num_threads; ++i) {
+		task_worker_t *worker = *(task_worker_t **)lx_array_at(state->workers, i);
 
 		task_worker_args_t *args = lx_alloc(state->allocator, sizeof(task_worker_args_t));
 		*args = (task_worker_args_t) { task_factory, worker };
 
 		lx_thread_create(&worker->thread, do_work, args);
+
+		if (worker->processor)
+			lx_thread_set_affinity(&worker->thread, worker->processor->group, worker->affinity_mask);
     }
 
 	return state;
@@ -144,10 +836,33 @@ static lx_task_t *create_task(lx_task_factory_t *factory, lx_task_function_t f,
     LX_ASSERT(f, "Invalid task function");
 
 	factory_state_t *s = (factory_state_t *)factory->state;
-	task_worker_t *worker = lx_thread_local_get_value(s->local_storage);
 	
-	lx_task_t *task = lx_alloc(worker->task_allocator, sizeof(lx_task_t));
-	*task = (lx_task_t) { .f = f, .arg = arg, .parent = NULL, .unfinishedTasks = 1 };
+	lx_task_t *task = lx_alloc(s->task_allocator, sizeof(lx_task_t));
+	*task = (lx_task_t) {
+		.f = f,
+		.arg = arg,
+		.parent = NULL,
+		.unfinishedTasks = 1,
+		.continuations = NULL,
+		.next_continuation = NULL,
+		.waiting_fibers = NULL,
+		.finished = 0,
+		.priority = LX_TASK_PRIORITY_NORMAL,
+		.pinned = false,
+		.name = NULL
+	};
+
+	return task;
+}
+
+static lx_task_t *create_child_task(lx_task_factory_t *factory, lx_task_t *parent, lx_task_function_t f, lx_any_t arg)
+{
+	LX_ASSERT(parent, "Invalid parent task");
+
+	lx_task_t *task = create_task(factory, f, arg);
+	task->parent = parent;
+	task->priority = parent->priority;
+	lx_atomic_increment_32(&parent->unfinishedTasks);
 
 	return task;
 }
@@ -159,75 +874,347 @@ static void start_task(lx_task_factory_t *factory, lx_task_t *task)
 
 	factory_state_t *s = (factory_state_t *)factory->state;
 	task_worker_t *worker = lx_thread_local_get_value(s->local_storage);
+	LX_ASSERT(worker, "Tasks can only be started from worker threads");
+
+	if (task->pinned) {
+		lx_mutex_lock(&s->main_thread_mutex);
+		lx_queue_enqueue(s->main_thread_tasks, &task);
+		lx_atomic_increment_32(&s->num_main_thread_tasks);
+		lx_mutex_unlock(&s->main_thread_mutex);
+
+		// The main thread only sleeps while waiting for a task
+		if (lx_atomic_exchange_32(&s->num_waiting, 0, 0))
+			wake_sleeping(s, true);
+
+		return;
+	}
 	
-	lx_mutex_lock(&worker->mutex);
-	lx_queue_enqueue(worker->queue, &task);
-	lx_mutex_unlock(&worker->mutex);
+	lx_atomic_increment_32(&s->num_queued_tasks);
+	lx_work_stealing_deque_push(worker->deques[task->priority], task);
+
+	if (lx_atomic_exchange_32(&s->num_sleeping, 0, 0) || lx_atomic_exchange_32(&s->num_waiting, 0, 0))
+		wake_sleeping(s, false);
 }
 
-static lx_task_t *continue_with(lx_task_factory_t *factory, lx_task_t *parent, lx_task_function_t f, lx_any_t arg)
+static lx_task_t *continue_with(lx_task_factory_t *factory, lx_task_t *antecedent, lx_task_function_t f, lx_any_t arg)
 {
 	LX_ASSERT(factory, "Invalid factory");
-	LX_ASSERT(parent, "Invalid parent task");
+	LX_ASSERT(antecedent, "Invalid antecedent task");
 	LX_ASSERT(f, "Invalid task function");
 
-	lx_task_t *child = create_task(factory, f, arg);
-	child->parent = parent;
+	lx_task_t *continuation = create_task(factory, f, arg);
+	continuation->priority = antecedent->priority;
+
+	// The continuation is part of the same parent as the antecedent, unless the parent has already
+	// finished and can't take another child
+	lx_task_t *parent = antecedent->parent;
+	if (parent) {
+		int32_t unfinished;
+		while ((unfinished = lx_atomic_exchange_32(&parent->unfinishedTasks, 0, 0)) != 0) {
+			if (lx_atomic_exchange_32(&parent->unfinishedTasks, unfinished + 1, unfinished) == unfinished) {
+				continuation->parent = parent;
+				break;
+			}
+		}
+	}
+
+	lx_any_t head;
+	do {
+		head = antecedent->continuations;
+		if (head == TASK_FINISHED) {
+			start_task(factory, continuation);
+			return continuation;
+		}
 
-	return child;
+		continuation->next_continuation = head;
+	} while (lx_atomic_exchange_ptr(&antecedent->continuations, continuation, head) != head);
+
+	return continuation;
 }
 
 static void wait(lx_task_factory_t *factory, lx_task_t *task)
+{
+	factory_state_t *s = (factory_state_t *)factory->state;
+
+	uint32_t idle_rounds = 0;
+	while (!lx_atomic_exchange_32(&task->finished, 0, 0)) {
+		// A fiber may continue on another thread after being suspended
+		task_worker_t *worker = lx_thread_local_get_value(s->local_storage);
+
+		if (worker->current_fiber && suspend_fiber(s, worker->current_fiber, task)) {
+			idle_rounds = 0;
+		} else if (execute_next_task(factory, worker)) {
+			idle_rounds = 0;
+		} else {
+			begin_idle(worker);
+			if (idle_backoff(&idle_rounds))
+				park_thread(s, worker, task);
+		}
+	}
+
+	end_idle(lx_thread_local_get_value(s->local_storage));
+}
+
+static void reset_task(lx_task_factory_t *factory, lx_task_t *task, lx_task_t *parent)
+{
+	LX_ASSERT(factory, "Invalid factory");
+	LX_ASSERT(task, "Invalid task");
+	LX_ASSERT(lx_atomic_exchange_32(&task->finished, 0, 0), "Task is not finished");
+
+	task->parent = parent;
+	task->unfinishedTasks = 1;
+	task->continuations = NULL;
+	task->next_continuation = NULL;
+	task->waiting_fibers = NULL;
+	task->finished = 0;
+
+	if (parent)
+		lx_atomic_increment_32(&parent->unfinishedTasks);
+}
+
+static void destroy_task(lx_task_factory_t *factory, lx_task_t *task)
+{
+	LX_ASSERT(factory, "Invalid factory");
+	LX_ASSERT(task, "Invalid task");
+	LX_ASSERT(lx_atomic_exchange_32(&task->finished, 0, 0), "Task is not finished");
+
+	factory_state_t *s = (factory_state_t *)factory->state;
+	lx_free(s->task_allocator, task);
+}
+
+static size_t num_workers(lx_task_factory_t *factory)
+{
+	factory_state_t *s = (factory_state_t *)factory->state;
+	return lx_array_size(s->workers);
+}
+
+static void add_worker_stats(factory_state_t *s, task_worker_t *worker, lx_task_factory_stats_t *stats)
+{
+	stats->num_tasks_executed += (uint64_t)lx_atomic_load_64(&worker->num_tasks_executed);
+	stats->num_steal_attempts += (uint64_t)lx_atomic_load_64(&worker->num_steal_attempts);
+	stats->num_successful_steals += (uint64_t)lx_atomic_load_64(&worker->num_successful_steals);
+	stats->num_tasks_stolen += (uint64_t)lx_atomic_load_64(&worker->num_tasks_stolen);
+	// Include the time a worker has been idle so far
+	int64_t idle_ticks = lx_atomic_load_64(&worker->idle_ticks);
+	int64_t idle_begin = lx_atomic_load_64(&worker->idle_begin);
+	if (idle_begin)
+		idle_ticks += lx_highres_clock_now() - idle_begin;
+
+	stats->idle_milliseconds += lx_highres_clock_milliseconds(&s->clock, idle_ticks);
+
+	for (size_t i = 0; i < LX_TASK_NUM_PRIORITIES; ++i) {
+		stats->num_queued_tasks[i] += lx_work_stealing_deque_size(worker->deques[i]);
+	}
+}
+
+static void get_stats(lx_task_factory_t *factory, lx_task_factory_stats_t *stats)
+{
+	LX_ASSERT(stats, "Invalid stats");
+
+	factory_state_t *s = (factory_state_t *)factory->state;
+	*stats = (lx_task_factory_stats_t) { 0 };
+
+	for (size_t i = 0; i < lx_array_size(s->workers); ++i) {
+		add_worker_stats(s, *(task_worker_t **)lx_array_at(s->workers, i), stats);
+	}
+}
+
+static void get_worker_stats(lx_task_factory_t *factory, size_t worker_index, lx_task_factory_stats_t *stats)
+{
+	LX_ASSERT(stats, "Invalid stats");
+
+	factory_state_t *s = (factory_state_t *)factory->state;
+	LX_ASSERT(worker_index < lx_array_size(s->workers), "Invalid worker");
+
+	*stats = (lx_task_factory_stats_t) { 0 };
+	add_worker_stats(s, *(task_worker_t **)lx_array_at(s->workers, worker_index), stats);
+}
+
+static void set_task_name(lx_task_factory_t *factory, lx_task_t *task, const char *name)
+{
+	LX_ASSERT(task, "Invalid task");
+
+	task->name = name;
+}
+
+static void set_task_priority(lx_task_factory_t *factory, lx_task_t *task, lx_task_priority_t priority)
+{
+	LX_ASSERT(task, "Invalid task");
+	LX_ASSERT(priority < LX_TASK_NUM_PRIORITIES, "Invalid task priority");
+
+	task->priority = priority;
+}
+
+static void pin_task_to_main_thread(lx_task_factory_t *factory, lx_task_t *task)
+{
+	LX_ASSERT(task, "Invalid task");
+
+	task->pinned = true;
+}
+
+static size_t run_main_thread_tasks(lx_task_factory_t *factory)
 {
 	factory_state_t *s = (factory_state_t *)factory->state;
 	task_worker_t *worker = lx_thread_local_get_value(s->local_storage);
-	
-	while (lx_atomic_exchange_32(&task->unfinishedTasks, 0, 0) != 0) {
-        execute_next_task(factory, worker);
+	LX_ASSERT(worker == s->main_worker, "Main thread tasks can only be run on the main thread");
+
+	size_t num_tasks = 0;
+	lx_task_t *task;
+	while ((task = next_main_thread_task(s)) != NULL) {
+		run_task(factory, worker, task);
+		++num_tasks;
 	}
+
+	return num_tasks;
 }
 
-lx_task_factory_t *lx_task_factory_default(lx_allocator_t *allocator, size_t num_threads)
+lx_task_factory_t *lx_task_factory_create(lx_allocator_t *allocator, const lx_task_factory_options_t *options)
 {
-    static lx_task_factory_t default_factory = {
-        .state = NULL,
-        .create_task = create_task,
-        .start_task = start_task,
+	LX_ASSERT(allocator, "Invalid allocator");
+	LX_ASSERT(options, "Invalid options");
+
+	lx_task_factory_t *factory = lx_alloc(allocator, sizeof(lx_task_factory_t));
+	*factory = (lx_task_factory_t) {
+		.state = NULL,
+		.create_task = create_task,
+		.create_child_task = create_child_task,
+		.start_task = start_task,
 		.continue_with = continue_with,
-        .wait = wait
-    };
+		.wait = wait,
+		.reset_task = reset_task,
+		.destroy_task = destroy_task,
+		.num_workers = num_workers,
+		.set_task_priority = set_task_priority,
+		.pin_task_to_main_thread = pin_task_to_main_thread,
+		.run_main_thread_tasks = run_main_thread_tasks,
+		.get_stats = get_stats,
+		.get_worker_stats = get_worker_stats,
+		.set_task_name = set_task_name
+	};
 
-    if (!default_factory.state) {
-        factory_state_t *state = create_factory_state(&default_factory, allocator, num_threads);
+	create_factory_state(factory, allocator, options);
 
-		// Create worker for calling thread
-		task_worker_t *worker = create_task_worker(&default_factory);
-		lx_array_push_back(state->workers, worker);
-		lx_thread_local_set_value(state->local_storage, worker);
-    }
-    
-    return &default_factory;
+	return factory;
 }
 
-void lx_task_factory_destroy_default(lx_task_factory_t *factory)
+void lx_task_factory_destroy(lx_task_factory_t *factory)
 {
 	LX_ASSERT(factory, "Invalid task factory");
 
 	factory_state_t *state = (factory_state_t *)factory->state;
-	factory->state = NULL;
-
-	if (!state)
-		return;
+	lx_allocator_t *allocator = state->allocator;
 
 	state->process_tasks = false;
-	lx_array_for(task_worker_t, *worker_ptr, state->workers) {
-		task_worker_t *worker = *worker_ptr;
-		lx_thread_join(&worker->thread);
-		destroy_task_worker(state->allocator, worker);
+	wake_sleeping(state, true);
+
+	for (size_t i = 0; i < lx_array_size(state->workers); ++i) {
+		task_worker_t *worker = *(task_worker_t **)lx_array_at(state->workers, i);
+		if (worker->thread.handle)
+			lx_thread_join(&worker->thread);
+		destroy_task_worker(allocator, worker);
 	}
 
+	for (size_t i = 0; i < state->num_fibers; ++i) {
+		lx_fiber_destroy(state->fibers[i].fiber);
+	}
+
+	if (state->fibers)
+		lx_free(allocator, state->fibers);
+
 	lx_array_destroy(state->workers);
+	if (state->topology)
+		lx_cpu_topology_destroy(state->topology);
+	lx_queue_destroy(state->main_thread_tasks);
+	lx_pool_allocator_destroy(state->task_allocator);
 	lx_thread_local_destroy_storage(state->local_storage);
+	lx_condition_variable_destroy(&state->wake_condition);
+	lx_mutex_destroy(&state->sleep_mutex);
+	lx_mutex_destroy(&state->main_thread_mutex);
+	lx_mutex_destroy(&state->fiber_mutex);
+
+	lx_free(allocator, state);
+	lx_free(allocator, factory);
+}
+
+// Task names are user strings, quotes, backslashes and control characters must be escaped in JSON
+static void write_json_string(FILE *file, const char *string)
+{
+	fputc('"', file);
+	for (const char *c = string; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', file);
+			fputc(*c, file);
+		} else if ((unsigned char)*c < 0x20) {
+			fprintf(file, "\\u%04x", (unsigned)*c);
+		} else {
+			fputc(*c, file);
+		}
+	}
+	fputc('"', file);
+}
+
+lx_result_t lx_task_factory_write_trace(lx_task_factory_t *factory, const char *path)
+{
+	LX_ASSERT(factory, "Invalid task factory");
+	LX_ASSERT(path, "Invalid path");
+
+	factory_state_t *state = (factory_state_t *)factory->state;
+	if (!state->trace_capacity)
+		return LX_ERROR;
+
+	FILE *file;
+	if (fopen_s(&file, path, "w") != 0)
+		return LX_ERROR;
+
+	fprintf(file, "{\"traceEvents\":[");
+
+	bool first_event = true;
+	for (size_t i = 0; i < lx_array_size(state->workers); ++i) {
+		task_worker_t *worker = *(task_worker_t **)lx_array_at(state->workers, i);
+
+		fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%zu,\"args\":{\"name\":\"%s %zu\"}}",
+			first_event ? "" : ",", i, worker == state->main_worker ? "Main thread" : "Worker", i);
+		first_event = false;
+
+		// Only the most recent events are left in the ring
+		const int64_t num_events = lx_atomic_load_64(&worker->num_trace_events);
+		const int64_t first = lx_max(num_events - (int64_t)state->trace_capacity, 0);
+
+		for (int64_t j = first; j < num_events; ++j) {
+			const trace_event_t *event = &worker->trace_events[j % (int64_t)state->trace_capacity];
+			const double begin = lx_highres_clock_microseconds(&state->clock, event->begin - state->start_ticks);
+			const double duration = lx_highres_clock_microseconds(&state->clock, event->end - event->begin);
+
+			fprintf(file, ",\n{\"name\":");
+			write_json_string(file, event->name ? event->name : "task");
+			fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}", i, begin, duration);
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+
+	bool failed = ferror(file) != 0;
+	fclose(file);
+
+	return failed ? LX_ERROR : LX_SUCCESS;
+}
+
+static lx_task_factory_t *default_factory = NULL;
+
+lx_task_factory_t *lx_task_factory_default(lx_allocator_t *allocator, size_t num_threads)
+{
+    if (!default_factory) {
+        lx_task_factory_options_t options = { .num_threads = num_threads };
+        default_factory = lx_task_factory_create(allocator, &options);
+    }
+    
+    return default_factory;
+}
+
+void lx_task_factory_destroy_default(lx_task_factory_t *factory)
+{
+	LX_ASSERT(factory == default_factory, "Not the default task factory");
 
-	*state = (factory_state_t) { 0 };
+	lx_task_factory_destroy(factory);
+	default_factory = NULL;
 }
@@ -15,17 +15,63 @@ typedef void (*lx_task_function_t)(lx_task_factory_t *task_factory, lx_task_t *t
 
 typedef struct lx_task_factory_state lx_task_factory_state_t;
 
+/*
+ * Workers always take the most urgent task they can find, tasks of lower priority are only run
+ * when there is no task of higher priority queued on the worker or the worker it steals from.
+ */
+typedef enum lx_task_priority {
+	LX_TASK_PRIORITY_HIGH,
+	LX_TASK_PRIORITY_NORMAL,
+	LX_TASK_PRIORITY_BACKGROUND,
+	LX_TASK_NUM_PRIORITIES
+} lx_task_priority_t;
+
+/*
+ * Scheduler counters since the factory was created, for a single worker or summed over all
+ * workers. Only an estimate while tasks are running. A successful steal can take several tasks at
+ * once. Idle time is time spent looking for work, including while waiting for a task, and queued
+ * tasks is the current depth of the worker deques per priority.
+ */
+typedef struct lx_task_factory_stats {
+	uint64_t num_tasks_executed;
+	uint64_t num_steal_attempts;
+	uint64_t num_successful_steals;
+	uint64_t num_tasks_stolen;
+	double idle_milliseconds;
+	size_t num_queued_tasks[LX_TASK_NUM_PRIORITIES];
+} lx_task_factory_stats_t;
+
 typedef struct lx_task_factory {
 	lx_task_factory_state_t *state;
 	
 	lx_task_t *(*create_task)(lx_task_factory_t *self, lx_task_function_t task_func, lx_any_t task_argument);
 
+	lx_task_t *(*create_child_task)(lx_task_factory_t *self, lx_task_t *parent_task, lx_task_function_t task_func, lx_any_t task_argument);
+
 	void (*start_task)(lx_task_factory_t *self, lx_task_t *task);
 
-	lx_task_t *(*continue_with)(lx_task_factory_t *self, lx_task_t *parent_task, lx_task_function_t task_func, lx_any_t task_argument);
+	lx_task_t *(*continue_with)(lx_task_factory_t *self, lx_task_t *antecedent_task, lx_task_function_t task_func, lx_any_t task_argument);
 
 	void (*wait)(lx_task_factory_t *self, lx_task_t *task);
 
+	void (*reset_task)(lx_task_factory_t *self, lx_task_t *task, lx_task_t *parent_task);
+
+	void (*destroy_task)(lx_task_factory_t *self, lx_task_t *task);
+
+	size_t (*num_workers)(lx_task_factory_t *self);
+
+	void (*set_task_priority)(lx_task_factory_t *self, lx_task_t *task, lx_task_priority_t priority);
+
+	void (*pin_task_to_main_thread)(lx_task_factory_t *self, lx_task_t *task);
+
+	size_t (*run_main_thread_tasks)(lx_task_factory_t *self);
+
+	void (*get_stats)(lx_task_factory_t *self, lx_task_factory_stats_t *stats);
+
+	void (*get_worker_stats)(lx_task_factory_t *self, size_t worker_index, lx_task_factory_stats_t *stats);
+
+	void (*set_task_name)(lx_task_factory_t *self, lx_task_t *task, const char *name);
+
 } lx_task_factory_t;
 
 static LX_INLINE lx_task_t *lx_task_create(lx_task_factory_t *factory, lx_task_function_t task_func, lx_any_t task_argument)
@@ -33,6 +79,16 @@ static LX_INLINE lx_task_t *lx_task_create(lx_task_factory_t *factory, lx_task_f
 	return factory->create_task(factory, task_func, task_argument);
 }
 
+/*
+ * Create a task that must finish before its parent is considered finished. Waiting for the parent
+ * waits for the whole subtree. The parent must not have finished when the child is created. The
+ * child gets the priority of the parent.
+ */
+static LX_INLINE lx_task_t *lx_task_create_child(lx_task_factory_t *factory, lx_task_t *parent_task, lx_task_function_t task_func, lx_any_t task_argument)
+{
+	return factory->create_child_task(factory, parent_task, task_func, task_argument);
+}
+
 static LX_INLINE void lx_task_start(lx_task_factory_t *factory, lx_task_t *task)
 {
 	factory->start_task(factory, task);
@@ -45,9 +101,14 @@ static LX_INLINE lx_task_t *lx_task_run(lx_task_factory_t *factory, lx_task_func
 	return task;
 }
 
-static LX_INLINE lx_task_t *lx_task_continue_with(lx_task_factory_t *factory, lx_task_t *parent_task, lx_task_function_t task_func, lx_any_t task_argument)
+/*
+ * Create a task that is started automatically once the antecedent task and all of its children
+ * have finished, or right away if the antecedent has already finished. The continuation becomes a
+ * child of the antecedent's parent and gets the priority of the antecedent.
+ */
+static LX_INLINE lx_task_t *lx_task_continue_with(lx_task_factory_t *factory, lx_task_t *antecedent_task, lx_task_function_t task_func, lx_any_t task_argument)
 {
-	return factory->continue_with(factory, parent_task, task_func, task_argument);
+	return factory->continue_with(factory, antecedent_task, task_func, task_argument);
 }
 
 static LX_INLINE void lx_task_wait(lx_task_factory_t *factory, lx_task_t *task)
@@ -55,6 +116,125 @@ static LX_INLINE void lx_task_wait(lx_task_factory_t *factory, lx_task_t *task)
 	factory->wait(factory, task);
 }
 
+/*
+ * Make a finished task ready to be started again, optionally as a child of a new parent. Lets
+ * tasks that run over and over, like the nodes of a task graph, be allocated once.
+ */
+static LX_INLINE void lx_task_reset(lx_task_factory_t *factory, lx_task_t *task, lx_task_t *parent_task)
+{
+	factory->reset_task(factory, task, parent_task);
+}
+
+/*
+ * Release a finished task. Tasks that are never destroyed are released with the factory.
+ */
+static LX_INLINE void lx_task_destroy(lx_task_factory_t *factory, lx_task_t *task)
+{
+	factory->destroy_task(factory, task);
+}
+
+/*
+ * Number of threads executing tasks, including the thread that created the factory.
+ */
+static LX_INLINE size_t lx_task_num_workers(lx_task_factory_t *factory)
+{
+	return factory->num_workers(factory);
+}
+
+/*
+ * Worker threads can be pinned to a physical core, free to move between its SMT siblings, or to a
+ * single logical processor. Workers are spread over cores before SMT siblings are used.
+ */
+typedef enum lx_task_thread_affinity {
+	LX_TASK_THREAD_AFFINITY_NONE,
+	LX_TASK_THREAD_AFFINITY_CORE,
+	LX_TASK_THREAD_AFFINITY_PROCESSOR
+} lx_task_thread_affinity_t;
+
+// Create one worker thread per physical core, minus one for the calling thread
+#define LX_TASK_NUM_THREADS_AUTO ((size_t)-1)
+
+/*
+ * A trace capacity above 0 makes every worker record the begin and end time of the last
+ * trace_capacity tasks it ran, see lx_task_factory_write_trace.
+ *
+ * With use_fibers the worker threads run tasks on a pool of fibers. A task that waits for an
+ * unfinished task suspends its fiber and the worker picks up other work on a fresh fiber, the
+ * waiting task is resumed later, possibly on another worker thread. The thread that creates the
+ * factory is not a fiber and keeps executing other tasks while it waits. When the pool is empty
+ * waits fall back to the same behavior. Zero fiber count and stack size use the defaults.
+ */
+typedef struct lx_task_factory_options {
+	size_t num_threads;
+	bool use_fibers;
+	size_t num_fibers;
+	size_t fiber_stack_size;
+	lx_task_thread_affinity_t thread_affinity;
+	size_t trace_capacity;
+} lx_task_factory_options_t;
+
+/*
+ * Tasks are created with normal priority, the priority must be set before the task is started.
+ */
+static LX_INLINE void lx_task_set_priority(lx_task_factory_t *factory, lx_task_t *task, lx_task_priority_t priority)
+{
+	factory->set_task_priority(factory, task, priority);
+}
+
+/*
+ * Only run the task on the main thread, the thread that created the factory. Must be called before
+ * the task is started. Pinned tasks run while the main thread waits for a task or when it calls
+ * lx_task_run_main_thread_tasks, ahead of any other task.
+ */
+static LX_INLINE void lx_task_pin_to_main_thread(lx_task_factory_t *factory, lx_task_t *task)
+{
+	factory->pin_task_to_main_thread(factory, task);
+}
+
+/*
+ * Run all tasks pinned to the main thread that are queued, returns the number of tasks run. Must
+ * be called from the main thread.
+ */
+static LX_INLINE size_t lx_task_run_main_thread_tasks(lx_task_factory_t *factory)
+{
+	return factory->run_main_thread_tasks(factory);
+}
+
+static LX_INLINE void lx_task_factory_get_stats(lx_task_factory_t *factory, lx_task_factory_stats_t *stats)
+{
+	factory->get_stats(factory, stats);
+}
+
+/*
+ * Counters of a single worker, the thread that created the factory is the last worker.
+ */
+static LX_INLINE void lx_task_factory_get_worker_stats(lx_task_factory_t *factory, size_t worker_index, lx_task_factory_stats_t *stats)
+{
+	factory->get_worker_stats(factory, worker_index, stats);
+}
+
+/*
+ * Name the task in traces, the name must outlive the factory.
+ */
+static LX_INLINE void lx_task_set_name(lx_task_factory_t *factory, lx_task_t *task, const char *name)
+{
+	factory->set_task_name(factory, task, name);
+}
+
+lx_task_factory_t *lx_task_factory_create(lx_allocator_t *allocator, const lx_task_factory_options_t *options);
+
+/*
+ * Stop and join all worker threads, all started tasks must have finished.
+ */
+void lx_task_factory_destroy(lx_task_factory_t *factory);
+
+/*
+ * Write the recorded task events as Chrome trace event JSON, viewable in chrome://tracing or
+ * Perfetto. Must not be called while tasks are running. Returns LX_ERROR if tracing is disabled or
+ * the file can't be written.
+ */
+lx_result_t lx_task_factory_write_trace(lx_task_factory_t *factory, const char *path);
+
 lx_task_factory_t *lx_task_factory_default(lx_allocator_t *allocator, size_t num_threads);
 
 void lx_task_factory_destroy_default(lx_task_factory_t *factory);
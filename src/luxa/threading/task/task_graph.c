@@ -0,0 +1,232 @@
+#include <luxa/threading/task/task_graph.h>
+#include <luxa/threading/threading.h>
+#include <luxa/collections/array.h>
+
+typedef struct graph_node {
+	lx_task_graph_t *graph;
+	lx_task_function_t f;
+	lx_any_t argument;
+	lx_task_t *task;
+	volatile int32_t num_pending;
+	int32_t num_predecessors;
+	uint32_t first_successor;
+	uint32_t num_successors;
+} graph_node_t;
+
+typedef struct graph_edge {
+	lx_task_graph_node_t from;
+	lx_task_graph_node_t to;
+} graph_edge_t;
+
+struct lx_task_graph {
+	lx_allocator_t *allocator;
+	lx_array_t *nodes; // graph_node_t
+	lx_array_t *edges; // graph_edge_t
+	bool is_compiled;
+
+	// Compiled schedule, successors of all nodes stored back to back
+	lx_array_t *successors; // lx_task_graph_node_t
+	lx_array_t *initial_nodes; // lx_task_graph_node_t
+
+	lx_task_factory_t *factory;
+	lx_task_t *root_task;
+};
+
+static inline graph_node_t *graph_node(lx_task_graph_t *graph, lx_task_graph_node_t node)
+{
+	return lx_array_at(graph->nodes, node);
+}
+
+static void root_task(lx_task_factory_t *factory, lx_task_t *task, lx_any_t argument)
+{
+}
+
+static void node_task(lx_task_factory_t *factory, lx_task_t *task, graph_node_t *node)
+{
+	lx_task_graph_t *graph = node->graph;
+
+	node->f(factory, task, node->argument);
+
+	lx_task_graph_node_t *successors = lx_array_begin(graph->successors);
+	for (uint32_t i = 0; i < node->num_successors; ++i) {
+		graph_node_t *successor = graph_node(graph, successors[node->first_successor + i]);
+		if (lx_atomic_decrement_32(&successor->num_pending) == 0)
+			lx_task_start(factory, successor->task);
+	}
+}
+
+static void destroy_tasks(lx_task_graph_t *graph)
+{
+	if (!graph->factory)
+		return;
+
+	lx_array_for(graph_node_t, node, graph->nodes) {
+		if (node->task)
+			lx_task_destroy(graph->factory, node->task);
+		node->task = NULL;
+	}
+
+	lx_task_destroy(graph->factory, graph->root_task);
+	graph->root_task = NULL;
+	graph->factory = NULL;
+}
+
+lx_task_graph_t *lx_task_graph_create(lx_allocator_t *allocator)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+
+	lx_task_graph_t *graph = lx_alloc(allocator, sizeof(lx_task_graph_t));
+	*graph = (lx_task_graph_t) {
+		.allocator = allocator,
+		.nodes = lx_array_create(allocator, sizeof(graph_node_t)),
+		.edges = lx_array_create(allocator, sizeof(graph_edge_t)),
+		.is_compiled = false,
+		.successors = lx_array_create(allocator, sizeof(lx_task_graph_node_t)),
+		.initial_nodes = lx_array_create(allocator, sizeof(lx_task_graph_node_t)),
+		.factory = NULL,
+		.root_task = NULL
+	};
+
+	return graph;
+}
+
+void lx_task_graph_destroy(lx_task_graph_t *graph)
+{
+	LX_ASSERT(graph, "Invalid task graph");
+
+	destroy_tasks(graph);
+
+	lx_array_destroy(graph->nodes);
+	lx_array_destroy(graph->edges);
+	lx_array_destroy(graph->successors);
+	lx_array_destroy(graph->initial_nodes);
+
+	lx_allocator_t *allocator = graph->allocator;
+	*graph = (lx_task_graph_t) { 0 };
+	lx_free(allocator, graph);
+}
+
+lx_task_graph_node_t lx_task_graph_add_node(lx_task_graph_t *graph, lx_task_function_t f, lx_any_t argument)
+{
+	LX_ASSERT(graph, "Invalid task graph");
+	LX_ASSERT(f, "Invalid task function");
+
+	// Node tasks point into the node array, which may move
+	destroy_tasks(graph);
+
+	graph_node_t node = { .graph = graph, .f = f, .argument = argument };
+	lx_array_push_back(graph->nodes, &node);
+	graph->is_compiled = false;
+
+	return (lx_task_graph_node_t)(lx_array_size(graph->nodes) - 1);
+}
+
+void lx_task_graph_add_edge(lx_task_graph_t *graph, lx_task_graph_node_t from, lx_task_graph_node_t to)
+{
+	LX_ASSERT(graph, "Invalid task graph");
+	LX_ASSERT(from < lx_array_size(graph->nodes) && to < lx_array_size(graph->nodes), "Invalid node");
+
+	graph_edge_t edge = { .from = from, .to = to };
+	lx_array_push_back(graph->edges, &edge);
+	graph->is_compiled = false;
+}
+
+lx_result_t lx_task_graph_compile(lx_task_graph_t *graph)
+{
+	LX_ASSERT(graph, "Invalid task graph");
+
+	const size_t num_nodes = lx_array_size(graph->nodes);
+	const size_t num_edges = lx_array_size(graph->edges);
+
+	lx_array_for(graph_node_t, node, graph->nodes) {
+		node->num_predecessors = 0;
+		node->first_successor = 0;
+		node->num_successors = 0;
+	}
+
+	// Count successors and predecessors, then lay out the successors of each node back to back
+	lx_array_for(graph_edge_t, edge, graph->edges) {
+		graph_node(graph, edge->from)->num_successors++;
+		graph_node(graph, edge->to)->num_predecessors++;
+	}
+
+	uint32_t first_successor = 0;
+	lx_array_for(graph_node_t, node, graph->nodes) {
+		node->first_successor = first_successor;
+		first_successor += node->num_successors;
+		node->num_successors = 0;
+	}
+
+	lx_array_resize(graph->successors, num_edges);
+
+	lx_task_graph_node_t *successors = lx_array_begin(graph->successors);
+	lx_array_for(graph_edge_t, edge, graph->edges) {
+		graph_node_t *from = graph_node(graph, edge->from);
+		successors[from->first_successor + from->num_successors++] = edge->to;
+	}
+
+	// Kahn's algorithm, any node that is never reached is part of a cycle
+	lx_array_clear(graph->initial_nodes);
+	for (lx_task_graph_node_t i = 0; i < num_nodes; ++i) {
+		graph_node_t *node = graph_node(graph, i);
+		node->num_pending = node->num_predecessors;
+		if (!node->num_predecessors)
+			lx_array_push_back(graph->initial_nodes, &i);
+	}
+
+	lx_array_t *ready = lx_array_create(graph->allocator, sizeof(lx_task_graph_node_t));
+	lx_array_copy(ready, lx_array_begin(graph->initial_nodes), lx_array_size(graph->initial_nodes));
+
+	size_t num_visited = 0;
+	while (!lx_array_is_empty(ready)) {
+		lx_task_graph_node_t n = *(lx_task_graph_node_t *)lx_array_pop_back(ready);
+		graph_node_t *node = graph_node(graph, n);
+		++num_visited;
+
+		for (uint32_t i = 0; i < node->num_successors; ++i) {
+			lx_task_graph_node_t s = successors[node->first_successor + i];
+			if (--graph_node(graph, s)->num_pending == 0)
+				lx_array_push_back(ready, &s);
+		}
+	}
+
+	lx_array_destroy(ready);
+
+	graph->is_compiled = num_visited == num_nodes;
+	return graph->is_compiled ? LX_SUCCESS : LX_ERROR;
+}
+
+void lx_task_graph_run(lx_task_graph_t *graph, lx_task_factory_t *factory)
+{
+	LX_ASSERT(graph, "Invalid task graph");
+	LX_ASSERT(factory, "Invalid task factory");
+	LX_ASSERT(graph->is_compiled, "Task graph is not compiled");
+
+	if (graph->factory != factory)
+		destroy_tasks(graph);
+
+	// Tasks are created on the first run and reset on every run after that
+	if (!graph->factory) {
+		graph->factory = factory;
+		graph->root_task = lx_task_create(factory, root_task, NULL);
+		lx_array_for(graph_node_t, node, graph->nodes) {
+			node->task = lx_task_create_child(factory, graph->root_task, node_task, node);
+		}
+	} else {
+		lx_task_reset(factory, graph->root_task, NULL);
+		lx_array_for(graph_node_t, node, graph->nodes) {
+			lx_task_reset(factory, node->task, graph->root_task);
+		}
+	}
+
+	lx_array_for(graph_node_t, node, graph->nodes) {
+		node->num_pending = node->num_predecessors;
+	}
+
+	lx_array_for(lx_task_graph_node_t, n, graph->initial_nodes) {
+		lx_task_start(factory, graph_node(graph, *n)->task);
+	}
+
+	lx_task_start(factory, graph->root_task);
+	lx_task_wait(factory, graph->root_task);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+#include <luxa/threading/task/task.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lx_task_graph lx_task_graph_t;
+
+typedef uint32_t lx_task_graph_node_t;
+
+/*
+ * Creates an empty task graph. Nodes and edges are declared once, the graph is compiled and can
+ * then be run any number of times, e.g. once per frame, without allocating.
+ */
+lx_task_graph_t *lx_task_graph_create(lx_allocator_t *allocator);
+
+/*
+ * Destroy task graph, the graph must not be running.
+ */
+void lx_task_graph_destroy(lx_task_graph_t *graph);
+
+/*
+ * Add a node that runs f with the given argument. Children started from f are not waited for
+ * before the successors of the node run, but they are waited for by lx_task_graph_run.
+ */
+lx_task_graph_node_t lx_task_graph_add_node(lx_task_graph_t *graph, lx_task_function_t f, lx_any_t argument);
+
+/*
+ * Add an edge so that node to runs after node from has run.
+ */
+void lx_task_graph_add_edge(lx_task_graph_t *graph, lx_task_graph_node_t from, lx_task_graph_node_t to);
+
+/*
+ * Build the schedule for the graph. Must be called after nodes or edges are added and before the
+ * graph is run. Returns LX_ERROR if the graph contains a cycle.
+ */
+lx_result_t lx_task_graph_compile(lx_task_graph_t *graph);
+
+/*
+ * Run all nodes of a compiled graph on the task factory and wait for them to finish.
+ */
+void lx_task_graph_run(lx_task_graph_t *graph, lx_task_factory_t *factory);
+
+#ifdef __cplusplus
+}
+#endif
@@ -36,6 +36,86 @@ void lx_mutex_unlock(lx_mutex_t *mutex)
 	LeaveCriticalSection(&mutex->critical_section);
 }
 
+void lx_rw_lock_create(lx_rw_lock_t *lock)
+{
+	LX_ASSERT(lock, "Invalid lock");
+
+	*lock = (lx_rw_lock_t) { 0 };
+	InitializeSRWLock(&lock->srw_lock);
+}
+
+void lx_rw_lock_destroy(lx_rw_lock_t *lock)
+{
+	LX_ASSERT(lock, "Invalid lock");
+
+	// Slim reader writer locks don't hold any resources
+}
+
+void lx_rw_lock_lock_shared(lx_rw_lock_t *lock)
+{
+	LX_ASSERT(lock, "Invalid lock");
+
+	AcquireSRWLockShared(&lock->srw_lock);
+}
+
+void lx_rw_lock_unlock_shared(lx_rw_lock_t *lock)
+{
+	LX_ASSERT(lock, "Invalid lock");
+
+	ReleaseSRWLockShared(&lock->srw_lock);
+}
+
+void lx_rw_lock_lock_exclusive(lx_rw_lock_t *lock)
+{
+	LX_ASSERT(lock, "Invalid lock");
+
+	AcquireSRWLockExclusive(&lock->srw_lock);
+}
+
+void lx_rw_lock_unlock_exclusive(lx_rw_lock_t *lock)
+{
+	LX_ASSERT(lock, "Invalid lock");
+
+	ReleaseSRWLockExclusive(&lock->srw_lock);
+}
+
+void lx_condition_variable_create(lx_condition_variable_t *condition_variable)
+{
+	LX_ASSERT(condition_variable, "Invalid condition variable");
+
+	*condition_variable = (lx_condition_variable_t) { 0 };
+	InitializeConditionVariable(&condition_variable->condition_variable);
+}
+
+void lx_condition_variable_destroy(lx_condition_variable_t *condition_variable)
+{
+	LX_ASSERT(condition_variable, "Invalid condition variable");
+
+	// Windows condition variables don't hold any resources
+}
+
+void lx_condition_variable_wait(lx_condition_variable_t *condition_variable, lx_mutex_t *mutex)
+{
+	LX_ASSERT(condition_variable, "Invalid condition variable");
+	LX_ASSERT(mutex, "Invalid mutex");
+
+	SleepConditionVariableCS(&condition_variable->condition_variable, &mutex->critical_section, INFINITE);
+}
+
+void lx_condition_variable_notify_one(lx_condition_variable_t *condition_variable)
+{
+	LX_ASSERT(condition_variable, "Invalid condition variable");
+
+	WakeConditionVariable(&condition_variable->condition_variable);
+}
+
+void lx_condition_variable_notify_all(lx_condition_variable_t *condition_variable)
+{
+	LX_ASSERT(condition_variable, "Invalid condition variable");
+
+	WakeAllConditionVariable(&condition_variable->condition_variable);
+}
+
 void lx_thread_create(lx_thread_t *thread, lx_thread_start_t thread_start, lx_any_t arg)
 {
     LX_ASSERT(thread, "Invalid thread");
@@ -57,6 +137,66 @@ bool lx_thread_join(lx_thread_t *thread)
 	return WaitForSingleObject(thread->handle, INFINITE) == WAIT_OBJECT_0;
 }
 
+bool lx_thread_set_affinity(lx_thread_t *thread, uint16_t group, uint64_t mask)
+{
+	LX_ASSERT(thread, "Invalid thread");
+	LX_ASSERT(mask, "Invalid affinity mask");
+
+	GROUP_AFFINITY affinity = { 0 };
+	affinity.Mask = (KAFFINITY)mask;
+	affinity.Group = group;
+
+	return SetThreadGroupAffinity(thread->handle, &affinity, NULL) != 0;
+}
+
+void lx_thread_sleep(uint32_t milliseconds)
+{
+	Sleep(milliseconds);
+}
+
+void lx_thread_yield()
+{
+	SwitchToThread();
+}
+
+void lx_thread_pause()
+{
+	YieldProcessor();
+}
+
+lx_fiber_t lx_fiber_convert_thread(lx_any_t arg)
+{
+	lx_fiber_t fiber = ConvertThreadToFiber(arg);
+	LX_ASSERT(fiber, "Failed to convert thread to fiber");
+	return fiber;
+}
+
+void lx_fiber_convert_to_thread()
+{
+	ConvertFiberToThread();
+}
+
+lx_fiber_t lx_fiber_create(size_t stack_size, lx_fiber_start_t fiber_start, lx_any_t arg)
+{
+	LX_ASSERT(fiber_start, "Invalid fiber start routine");
+
+	lx_fiber_t fiber = CreateFiber(stack_size, (LPFIBER_START_ROUTINE)fiber_start, arg);
+	LX_ASSERT(fiber, "Failed to create fiber");
+	return fiber;
+}
+
+void lx_fiber_destroy(lx_fiber_t fiber)
+{
+	LX_ASSERT(fiber, "Invalid fiber");
+	DeleteFiber(fiber);
+}
+
+void lx_fiber_switch(lx_fiber_t fiber)
+{
+	LX_ASSERT(fiber, "Invalid fiber");
+	SwitchToFiber(fiber);
+}
+
 lx_thread_local_storage_t lx_thread_local_create_storage()
 {
     unsigned long storage = TlsAlloc();
@@ -81,17 +221,59 @@ lx_any_t lx_thread_local_get_value(lx_thread_local_storage_t storage)
     return TlsGetValue(storage);
 }
 
-void lx_atomic_increment_32(volatile int32_t *value)
+int32_t lx_atomic_increment_32(volatile int32_t *value)
 {
-	InterlockedIncrement((long *)value);
+	return (int32_t)InterlockedIncrement((long *)value);
 }
 
-void lx_atomic_decrement_32(volatile int32_t *value)
+int32_t lx_atomic_decrement_32(volatile int32_t *value)
 {
-	InterlockedDecrement((long *)value);
+	return (int32_t)InterlockedDecrement((long *)value);
 }
 
 int32_t lx_atomic_exchange_32(volatile int32_t *dst, int32_t exchange, int32_t comparand)
 {
 	return (int32_t)InterlockedCompareExchange((long *)dst, exchange, comparand);
 }
+
+int64_t lx_atomic_add_64(volatile int64_t *value, int64_t amount)
+{
+	return InterlockedExchangeAdd64((volatile long long *)value, amount) + amount;
+}
+
+int64_t lx_atomic_exchange_64(volatile int64_t *dst, int64_t exchange, int64_t comparand)
+{
+	return InterlockedCompareExchange64((volatile long long *)dst, exchange, comparand);
+}
+
+int64_t lx_atomic_swap_64(volatile int64_t *dst, int64_t value)
+{
+	return InterlockedExchange64((volatile long long *)dst, value);
+}
+
+int64_t lx_atomic_load_64(const volatile int64_t *value)
+{
+	// Aligned 64-bit volatile reads are atomic with acquire semantics on x64
+	return *value;
+}
+
+void lx_atomic_store_64(volatile int64_t *dst, int64_t value)
+{
+	// Aligned 64-bit volatile writes are atomic with release semantics on x64
+	*dst = value;
+}
+
+void lx_memory_barrier()
+{
+	MemoryBarrier();
+}
+
+lx_any_t lx_atomic_exchange_ptr(volatile lx_any_t *dst, lx_any_t exchange, lx_any_t comparand)
+{
+	return InterlockedCompareExchangePointer(dst, exchange, comparand);
+}
+
+lx_any_t lx_atomic_swap_ptr(volatile lx_any_t *dst, lx_any_t value)
+{
+	return InterlockedExchangePointer(dst, value);
+}
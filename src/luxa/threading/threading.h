@@ -27,6 +27,44 @@ void lx_mutex_unlock(lx_mutex_t *mutex);
     lx_mutex_unlock(mutex);\
     } while(0)
 
+/*
+ * Reader writer lock, any number of threads can hold it shared or a single thread exclusively. Not
+ * recursive, a thread must not lock it again while holding it.
+ */
+typedef struct lx_rw_lock {
+    SRWLOCK srw_lock;
+} lx_rw_lock_t;
+
+void lx_rw_lock_create(lx_rw_lock_t *lock);
+
+void lx_rw_lock_destroy(lx_rw_lock_t *lock);
+
+void lx_rw_lock_lock_shared(lx_rw_lock_t *lock);
+
+void lx_rw_lock_unlock_shared(lx_rw_lock_t *lock);
+
+void lx_rw_lock_lock_exclusive(lx_rw_lock_t *lock);
+
+void lx_rw_lock_unlock_exclusive(lx_rw_lock_t *lock);
+
+typedef struct lx_condition_variable {
+    CONDITION_VARIABLE condition_variable;
+} lx_condition_variable_t;
+
+void lx_condition_variable_create(lx_condition_variable_t *condition_variable);
+
+void lx_condition_variable_destroy(lx_condition_variable_t *condition_variable);
+
+/*
+ * Atomically release the mutex and sleep until notified, the mutex is locked again on return.
+ * Spurious wake ups can happen, always check the condition in a loop.
+ */
+void lx_condition_variable_wait(lx_condition_variable_t *condition_variable, lx_mutex_t *mutex);
+
+void lx_condition_variable_notify_one(lx_condition_variable_t *condition_variable);
+
+void lx_condition_variable_notify_all(lx_condition_variable_t *condition_variable);
+
 typedef struct lx_thread {
     lx_any_t handle;
     uint64_t id;
@@ -40,6 +78,49 @@ void lx_thread_destroy(lx_thread_t *thread);
 
 bool lx_thread_join(lx_thread_t *thread);
 
+/*
+ * Restrict the thread to the logical processors of the mask within a processor group. Returns
+ * false if the affinity could not be set.
+ */
+bool lx_thread_set_affinity(lx_thread_t *thread, uint16_t group, uint64_t mask);
+
+void lx_thread_sleep(uint32_t milliseconds);
+
+/*
+ * Give up the rest of the time slice to another thread that is ready to run.
+ */
+void lx_thread_yield();
+
+/*
+ * Hint to the processor that the calling thread is spin waiting.
+ */
+void lx_thread_pause();
+
+typedef lx_any_t lx_fiber_t;
+
+typedef void (*lx_fiber_start_t)(lx_any_t arg);
+
+/*
+ * Turn the calling thread into a fiber so it can switch to other fibers. The thread must be
+ * converted back before it exits.
+ */
+lx_fiber_t lx_fiber_convert_thread(lx_any_t arg);
+
+void lx_fiber_convert_to_thread();
+
+/*
+ * Create a fiber that starts running fiber_start the first time it's switched to. The start
+ * routine must never return, switch to another fiber instead. A stack size of 0 uses the default.
+ */
+lx_fiber_t lx_fiber_create(size_t stack_size, lx_fiber_start_t fiber_start, lx_any_t arg);
+
+void lx_fiber_destroy(lx_fiber_t fiber);
+
+/*
+ * Save the state of the current fiber and continue running the given fiber on the calling thread.
+ */
+void lx_fiber_switch(lx_fiber_t fiber);
+
 typedef unsigned long lx_thread_local_storage_t;
 
 lx_thread_local_storage_t lx_thread_local_create_storage();
@@ -50,12 +131,31 @@ void lx_thread_local_set_value(lx_thread_local_storage_t storage, lx_any_t value
 
 lx_any_t lx_thread_local_get_value(lx_thread_local_storage_t storage);
 
-void lx_atomic_increment_32(volatile int32_t *value);
+int32_t lx_atomic_increment_32(volatile int32_t *value);
 
-void lx_atomic_decrement_32(volatile int32_t *value);
+int32_t lx_atomic_decrement_32(volatile int32_t *value);
 
 int32_t lx_atomic_exchange_32(volatile int32_t *dst, int32_t exchange, int32_t comparand);
 
+int64_t lx_atomic_add_64(volatile int64_t *value, int64_t amount);
+
+int64_t lx_atomic_exchange_64(volatile int64_t *dst, int64_t exchange, int64_t comparand);
+
+int64_t lx_atomic_swap_64(volatile int64_t *dst, int64_t value);
+
+int64_t lx_atomic_load_64(const volatile int64_t *value);
+
+void lx_atomic_store_64(volatile int64_t *dst, int64_t value);
+
+lx_any_t lx_atomic_exchange_ptr(volatile lx_any_t *dst, lx_any_t exchange, lx_any_t comparand);
+
+lx_any_t lx_atomic_swap_ptr(volatile lx_any_t *dst, lx_any_t value);
+
+/*
+ * Full memory barrier, no loads or stores are reordered across it.
+ */
+void lx_memory_barrier();
+
 #ifdef __cplusplus
 }
 #endif
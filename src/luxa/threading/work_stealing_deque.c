@@ -0,0 +1,185 @@
+#include <luxa/threading/work_stealing_deque.h>
+#include <luxa/threading/threading.h>
+
+typedef struct deque_buffer {
+	int64_t capacity;
+	lx_any_t *items;
+	struct deque_buffer *previous_buffer;
+} deque_buffer_t;
+
+/*
+ * Top is written by thieves and bottom by the owner, keep them on separate cache lines.
+ */
+struct lx_work_stealing_deque {
+	volatile int64_t top;
+	char top_padding[LX_CACHE_LINE_SIZE - sizeof(int64_t)];
+	volatile int64_t bottom;
+	char bottom_padding[LX_CACHE_LINE_SIZE - sizeof(int64_t)];
+	volatile lx_any_t buffer; // deque_buffer_t
+	lx_allocator_t *allocator;
+};
+
+static deque_buffer_t *allocate_buffer(lx_allocator_t *allocator, int64_t capacity)
+{
+	deque_buffer_t *buffer = lx_alloc(allocator, sizeof(deque_buffer_t) + (size_t)capacity * sizeof(lx_any_t));
+	*buffer = (deque_buffer_t) {
+		.capacity = capacity,
+		.items = (lx_any_t *)(buffer + 1),
+		.previous_buffer = NULL
+	};
+
+	return buffer;
+}
+
+static inline lx_any_t buffer_get(deque_buffer_t *buffer, int64_t index)
+{
+	return buffer->items[index & (buffer->capacity - 1)];
+}
+
+static inline void buffer_put(deque_buffer_t *buffer, int64_t index, lx_any_t item)
+{
+	buffer->items[index & (buffer->capacity - 1)] = item;
+}
+
+static deque_buffer_t *grow_buffer(lx_work_stealing_deque_t *deque, deque_buffer_t *buffer, int64_t top, int64_t bottom)
+{
+	deque_buffer_t *new_buffer = allocate_buffer(deque->allocator, buffer->capacity * 2);
+	for (int64_t i = top; i < bottom; ++i) {
+		buffer_put(new_buffer, i, buffer_get(buffer, i));
+	}
+
+	// Thieves may still read from the old buffer, it is released when the deque is destroyed
+	new_buffer->previous_buffer = buffer;
+	lx_atomic_swap_ptr(&deque->buffer, new_buffer);
+
+	return new_buffer;
+}
+
+lx_work_stealing_deque_t *lx_work_stealing_deque_create(lx_allocator_t *allocator, size_t capacity)
+{
+	LX_ASSERT(allocator, "Invalid allocator");
+	LX_ASSERT(lx_is_power_of_two(capacity), "Capacity must be a power of two");
+
+	lx_work_stealing_deque_t *deque = lx_alloc_aligned(allocator, sizeof(lx_work_stealing_deque_t), LX_CACHE_LINE_SIZE);
+	*deque = (lx_work_stealing_deque_t) {
+		.top = 0,
+		.bottom = 0,
+		.buffer = allocate_buffer(allocator, (int64_t)capacity),
+		.allocator = allocator
+	};
+
+	return deque;
+}
+
+void lx_work_stealing_deque_destroy(lx_work_stealing_deque_t *deque)
+{
+	LX_ASSERT(deque, "Invalid deque");
+
+	lx_allocator_t *allocator = deque->allocator;
+
+	deque_buffer_t *buffer = deque->buffer;
+	while (buffer) {
+		deque_buffer_t *previous_buffer = buffer->previous_buffer;
+		lx_free(allocator, buffer);
+		buffer = previous_buffer;
+	}
+
+	lx_free(allocator, deque);
+}
+
+void lx_work_stealing_deque_push(lx_work_stealing_deque_t *deque, lx_any_t item)
+{
+	LX_ASSERT(deque, "Invalid deque");
+
+	const int64_t bottom = lx_atomic_load_64(&deque->bottom);
+	const int64_t top = lx_atomic_load_64(&deque->top);
+	deque_buffer_t *buffer = deque->buffer;
+
+	if (bottom - top >= buffer->capacity)
+		buffer = grow_buffer(deque, buffer, top, bottom);
+
+	buffer_put(buffer, bottom, item);
+
+	// Publish the item before the new bottom
+	lx_atomic_store_64(&deque->bottom, bottom + 1);
+}
+
+lx_any_t lx_work_stealing_deque_pop(lx_work_stealing_deque_t *deque)
+{
+	LX_ASSERT(deque, "Invalid deque");
+
+	const int64_t bottom = lx_atomic_load_64(&deque->bottom) - 1;
+	deque_buffer_t *buffer = deque->buffer;
+
+	// The new bottom must be visible to thieves before top is read
+	lx_atomic_swap_64(&deque->bottom, bottom);
+	int64_t top = lx_atomic_load_64(&deque->top);
+
+	if (top > bottom) {
+		lx_atomic_store_64(&deque->bottom, bottom + 1);
+		return NULL;
+	}
+
+	lx_any_t item = buffer_get(buffer, bottom);
+	if (top == bottom) {
+		// Last item, race thieves for it
+		if (lx_atomic_exchange_64(&deque->top, top + 1, top) != top)
+			item = NULL;
+
+		lx_atomic_store_64(&deque->bottom, bottom + 1);
+	}
+
+	return item;
+}
+
+lx_any_t lx_work_stealing_deque_steal(lx_work_stealing_deque_t *deque)
+{
+	LX_ASSERT(deque, "Invalid deque");
+
+	const int64_t top = lx_atomic_load_64(&deque->top);
+	lx_memory_barrier();
+	const int64_t bottom = lx_atomic_load_64(&deque->bottom);
+
+	if (top >= bottom)
+		return NULL;
+
+	deque_buffer_t *buffer = deque->buffer;
+	lx_any_t item = buffer_get(buffer, top);
+
+	if (lx_atomic_exchange_64(&deque->top, top + 1, top) != top)
+		return NULL;
+
+	return item;
+}
+
+size_t lx_work_stealing_deque_steal_half(lx_work_stealing_deque_t *deque, lx_any_t *items, size_t max_items)
+{
+	LX_ASSERT(deque, "Invalid deque");
+	LX_ASSERT(items || max_items == 0, "Invalid items");
+
+	// Taking several items with a single compare and swap on top could race with the owner popping
+	// items without one, so each item is claimed separately
+	const size_t size = lx_work_stealing_deque_size(deque);
+	const size_t num_items = lx_min((size + 1) / 2, max_items);
+
+	size_t num_stolen = 0;
+	while (num_stolen < num_items) {
+		lx_any_t item = lx_work_stealing_deque_steal(deque);
+		if (!item)
+			break;
+
+		items[num_stolen++] = item;
+	}
+
+	return num_stolen;
+}
+
+size_t lx_work_stealing_deque_size(lx_work_stealing_deque_t *deque)
+{
+	LX_ASSERT(deque, "Invalid deque");
+
+	const int64_t bottom = lx_atomic_load_64(&deque->bottom);
+	const int64_t top = lx_atomic_load_64(&deque->top);
+
+	return bottom > top ? (size_t)(bottom - top) : 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <luxa/platform.h>
+#include <luxa/memory/allocator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lx_work_stealing_deque lx_work_stealing_deque_t;
+
+/*
+ * Creates a lock-free Chase-Lev work stealing deque of pointers. The owning thread pushes and pops
+ * at the bottom in LIFO order while any other thread can steal from the top in FIFO order. The
+ * deque grows when full, capacity must be a power of two.
+ */
+lx_work_stealing_deque_t *lx_work_stealing_deque_create(lx_allocator_t *allocator, size_t capacity);
+
+/*
+ * Destroy deque. No other thread can access the deque while it is destroyed.
+ */
+void lx_work_stealing_deque_destroy(lx_work_stealing_deque_t *deque);
+
+/*
+ * Push an item to the bottom of the deque, must only be called by the owning thread.
+ */
+void lx_work_stealing_deque_push(lx_work_stealing_deque_t *deque, lx_any_t item);
+
+/*
+ * Pop the most recently pushed item, must only be called by the owning thread. Returns NULL if the
+ * deque is empty.
+ */
+lx_any_t lx_work_stealing_deque_pop(lx_work_stealing_deque_t *deque);
+
+/*
+ * Steal the least recently pushed item, can be called from any thread. Returns NULL if the deque
+ * is empty or if another thread won the race for the item.
+ */
+lx_any_t lx_work_stealing_deque_steal(lx_work_stealing_deque_t *deque);
+
+/*
+ * Steal up to half of the items, rounded up, but never more than max_items, can be called from
+ * any thread. Items are stolen one at a time in FIFO order and stealing stops at the first lost
+ * race. Returns the number of items written to items.
+ */
+size_t lx_work_stealing_deque_steal_half(lx_work_stealing_deque_t *deque, lx_any_t *items, size_t max_items);
+
+/*
+ * Number of items in the deque. Only an estimate while other threads access the deque.
+ */
+size_t lx_work_stealing_deque_size(lx_work_stealing_deque_t *deque);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+#include <test/luxa/collections/concurrent_map_tests.h>
+#include <luxa/collections/concurrent_map.h>
+#include <luxa/threading/threading.h>
+#include <luxa/test.h>
+
+#define CONCURRENT_MAP_TEST_THREADS 4
+#define CONCURRENT_MAP_TEST_KEYS 2000
+
+typedef struct concurrent_map_test_arg {
+	lx_concurrent_map_t *map;
+	uint64_t first_key;
+	volatile int32_t *num_winners;
+} concurrent_map_test_arg_t;
+
+static unsigned long insert_keys(concurrent_map_test_arg_t *arg)
+{
+	for (uint64_t key = arg->first_key; key < arg->first_key + CONCURRENT_MAP_TEST_KEYS; ++key) {
+		const uint64_t value = key * 2;
+		lx_concurrent_map_insert(arg->map, key, (lx_any_t)&value);
+
+		uint64_t read_value = 0;
+		lx_concurrent_map_try_get_value(arg->map, key, &read_value);
+	}
+
+	const uint64_t value = arg->first_key;
+	if (lx_concurrent_map_try_insert(arg->map, lx_id64("shared"), (lx_any_t)&value)) {
+		lx_atomic_increment_32(arg->num_winners);
+	}
+
+	return 0;
+}
+
+void concurrent_map_insert_get_and_remove_succeeds()
+{
+	// Arrange
+	lx_concurrent_map_t *map = lx_concurrent_map_create(lx_allocator_default(), sizeof(uint32_t), 0);
+	const uint32_t mesh = 7;
+	const uint32_t shader = 9;
+
+	// Act
+	lx_concurrent_map_insert(map, lx_id64("mesh"), (lx_any_t)&mesh);
+	lx_concurrent_map_insert(map, lx_id64("shader"), (lx_any_t)&shader);
+	const bool removed = lx_concurrent_map_remove(map, lx_id64("mesh"));
+
+	// Assert
+	uint32_t value = 0;
+	LX_TRUE(removed);
+	LX_TRUE((!lx_concurrent_map_try_get_value(map, lx_id64("mesh"), &value)));
+	LX_TRUE(lx_concurrent_map_try_get_value(map, lx_id64("shader"), &value));
+	LX_EQUALS(value, 9);
+	LX_EQUALS(lx_concurrent_map_size(map), 1);
+
+	lx_concurrent_map_destroy(map);
+}
+
+void concurrent_map_inserts_from_many_threads()
+{
+	// Arrange
+	lx_concurrent_map_t *map = lx_concurrent_map_create(lx_allocator_default(), sizeof(uint64_t), 8);
+	volatile int32_t num_winners = 0;
+	lx_thread_t threads[CONCURRENT_MAP_TEST_THREADS];
+	concurrent_map_test_arg_t args[CONCURRENT_MAP_TEST_THREADS];
+
+	// Act
+	for (uint64_t i = 0; i < CONCURRENT_MAP_TEST_THREADS; ++i) {
+		args[i] = (concurrent_map_test_arg_t) { map, 1 + i * CONCURRENT_MAP_TEST_KEYS, &num_winners };
+		lx_thread_create(&threads[i], insert_keys, &args[i]);
+	}
+
+	for (uint64_t i = 0; i < CONCURRENT_MAP_TEST_THREADS; ++i) {
+		lx_thread_join(&threads[i]);
+		lx_thread_destroy(&threads[i]);
+	}
+
+	// Assert
+	LX_EQUALS(num_winners, 1);
+	LX_EQUALS(lx_concurrent_map_size(map), CONCURRENT_MAP_TEST_THREADS * CONCURRENT_MAP_TEST_KEYS + 1);
+
+	size_t num_missing = 0;
+	for (uint64_t key = 1; key <= CONCURRENT_MAP_TEST_THREADS * CONCURRENT_MAP_TEST_KEYS; ++key) {
+		uint64_t value = 0;
+		if (!lx_concurrent_map_try_get_value(map, key, &value) || value != key * 2)
+			num_missing++;
+	}
+
+	LX_EQUALS(num_missing, 0);
+	lx_concurrent_map_destroy(map);
+}
+
+void setup_concurrent_map_test_fixture()
+{
+	LX_TEST_FIXTURE_BEGIN("ConcurrentMap");
+		LX_ADD_TEST(concurrent_map_insert_get_and_remove_succeeds);
+		LX_ADD_TEST(concurrent_map_inserts_from_many_threads);
+	LX_TEST_FIXTURE_END();
+}
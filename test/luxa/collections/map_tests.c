@@ -9,7 +9,7 @@ void create_returns_new_hash_map()
 	lx_allocator_t *allocator = lx_allocator_default();
 
 	// Act
-	lx_map_t *map = lx_map_create(allocator, sizeof(int), lx_string_hash64);
+	lx_map_t *map = lx_map_create(allocator, sizeof(int), &(lx_map_options_t) { .hash = lx_string_hash64 });
 
 	// Assert
 	LX_ASSERT(map, "Invalid map");
@@ -20,7 +20,7 @@ void insert_and_at_returns_correct_values()
 {
 	// Arrange
 	lx_allocator_t *allocator = lx_allocator_default();
-	lx_map_t *map = lx_map_create(allocator, sizeof(int), lx_string_hash64);
+	lx_map_t *map = lx_map_create(allocator, sizeof(int), &(lx_map_options_t) { .hash = lx_string_hash64 });
 
 	// Act & Assert
 	int a = 41;
@@ -41,7 +41,7 @@ void insert_and_at_returns_correct_values()
 void get_value_succeeds()
 {
 	// Arrange
-	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(int), lx_string_hash64);
+	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(int), &(lx_map_options_t) { .hash = lx_string_hash64 });
 	int s = 41;
 	lx_map_insert(map, "C99", &s);
 
@@ -52,12 +52,13 @@ void get_value_succeeds()
 	// Assert
 	LX_EQUALS(*value, 41);
 	LX_TRUE(exists);
+	lx_map_destroy(map);
 }
 
 void rehash_succeeds()
 {
 	// Arrange
-	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(int), lx_string_hash64);
+	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(int), &(lx_map_options_t) { .hash = lx_string_hash64 });
 	const uint32_t count = 32;
 
 	// Act
@@ -76,6 +77,192 @@ void rehash_succeeds()
 		LX_ASSERT(exists, "Key does not exists");
 		LX_ASSERT(*value == i, "Value does not match");
 	}
+
+	lx_map_destroy(map);
+}
+
+static size_t colliding_hash(const lx_any_t key)
+{
+	return 42;
+}
+
+void colliding_keys_are_kept_apart()
+{
+	// Arrange
+	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(uint32_t), &(lx_map_options_t) { .hash = colliding_hash });
+	const uint32_t count = 40;
+	char key[128];
+
+	// Act
+	for (uint32_t i = 0; i < count; ++i) {
+		sprintf_s(key, 128, "entry_%d", i);
+		lx_map_insert(map, key, &i);
+	}
+
+	// Assert
+	LX_EQUALS(lx_map_size(map), count);
+	for (uint32_t i = 0; i < count; ++i) {
+		sprintf_s(key, 128, "entry_%d", i);
+		uint32_t *value = lx_map_at(map, key, NULL);
+		LX_NOT_NULL(value);
+		LX_EQUALS(*value, i);
+	}
+
+	uint32_t *missing = lx_map_at(map, "missing", NULL);
+	LX_NULL(missing);
+	lx_map_destroy(map);
+}
+
+void removed_keys_do_not_hide_other_keys()
+{
+	// Arrange
+	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(uint32_t), &(lx_map_options_t) { .hash = colliding_hash });
+	const uint32_t count = 40;
+	char key[128];
+
+	for (uint32_t i = 0; i < count; ++i) {
+		sprintf_s(key, 128, "entry_%d", i);
+		lx_map_insert(map, key, &i);
+	}
+
+	// Act
+	for (uint32_t i = 0; i < count; i += 2) {
+		sprintf_s(key, 128, "entry_%d", i);
+		LX_TRUE(lx_map_remove(map, key));
+	}
+
+	// Assert
+	LX_EQUALS(lx_map_size(map), count / 2);
+	for (uint32_t i = 0; i < count; ++i) {
+		sprintf_s(key, 128, "entry_%d", i);
+		uint32_t *value = lx_map_at(map, key, NULL);
+		if (i % 2) {
+			LX_TRUE((value != NULL && *value == i));
+		} else {
+			LX_NULL(value);
+		}
+	}
+
+	sprintf_s(key, 128, "entry_%d", 0);
+	LX_TRUE((!lx_map_remove(map, key)));
+	lx_map_destroy(map);
+}
+
+void integer_keys_respect_load_factor()
+{
+	// Arrange
+	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(uint64_t), &(lx_map_options_t) {
+		.key_size = sizeof(uint64_t),
+		.max_load_factor = 0.5
+	});
+	const uint64_t count = 1000;
+	size_t num_overloaded = 0;
+
+	// Act
+	for (uint64_t i = 0; i < count; ++i) {
+		const uint64_t value = i * 3;
+		lx_map_insert(map, &i, &value);
+		if (lx_map_size(map) > lx_map_capacity(map) / 2)
+			++num_overloaded;
+	}
+
+	for (uint64_t i = 0; i < count; i += 4) {
+		const uint64_t value = i;
+		lx_map_insert(map, &i, &value);
+	}
+
+	// Assert
+	LX_EQUALS(num_overloaded, 0);
+	LX_EQUALS(lx_map_capacity(map), 2048); // Smallest power of two with room for count items at half load
+	LX_EQUALS(lx_map_size(map), count);
+	for (uint64_t i = 0; i < count; ++i) {
+		uint64_t *value = lx_map_at(map, &i, NULL);
+		LX_TRUE((value != NULL && *value == (i % 4 ? i * 3 : i)));
+	}
+
+	lx_map_destroy(map);
+}
+
+void iterator_visits_every_item_once()
+{
+	// Arrange
+	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(uint64_t), &(lx_map_options_t) { .key_size = sizeof(uint64_t) });
+	const uint64_t count = 100;
+
+	for (uint64_t i = 0; i < count; ++i) {
+		lx_map_insert(map, &i, &i);
+	}
+
+	for (uint64_t i = 0; i < count; i += 3) {
+		lx_map_remove(map, &i);
+	}
+
+	// Act
+	uint32_t visits[100] = { 0 };
+	size_t num_visits = 0;
+	lx_map_for(it, map) {
+		const uint64_t key = *(uint64_t *)it.key;
+		LX_EQUALS(*(uint64_t *)it.item, key);
+		visits[key]++;
+		num_visits++;
+	}
+
+	// Assert
+	LX_EQUALS(num_visits, lx_map_size(map));
+	for (uint64_t i = 0; i < count; ++i) {
+		LX_EQUALS(visits[i], (i % 3 ? 1 : 0));
+	}
+
+	lx_map_destroy(map);
+}
+
+void reserve_keeps_items_in_place()
+{
+	// Arrange
+	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(uint64_t), &(lx_map_options_t) { .key_size = sizeof(uint64_t) });
+	const uint64_t count = 1000;
+	const uint64_t first = 0;
+	lx_map_insert(map, &first, &first);
+
+	// Act
+	lx_map_reserve(map, count);
+	uint64_t *first_item = lx_map_at(map, &first, NULL);
+
+	for (uint64_t i = 1; i < count; ++i) {
+		lx_map_insert(map, &i, &i);
+	}
+
+	// Assert
+	LX_TRUE((first_item == lx_map_at(map, &first, NULL)));
+	LX_EQUALS(lx_map_size(map), count);
+	lx_map_destroy(map);
+}
+
+void insert_many_inserts_every_item()
+{
+	// Arrange
+	lx_map_t *map = lx_map_create(lx_allocator_default(), sizeof(uint32_t), &(lx_map_options_t) { 0 });
+	char names[64][16];
+	lx_any_t keys[64];
+	uint32_t items[64];
+
+	for (uint32_t i = 0; i < 64; ++i) {
+		sprintf_s(names[i], 16, "shader_%d", i);
+		keys[i] = names[i];
+		items[i] = i;
+	}
+
+	// Act
+	lx_map_insert_many(map, keys, items, 64);
+
+	// Assert
+	LX_EQUALS(lx_map_size(map), 64);
+	for (uint32_t i = 0; i < 64; ++i) {
+		uint32_t *value = lx_map_at(map, names[i], NULL);
+		LX_TRUE((value != NULL && *value == i));
+	}
+
+	lx_map_destroy(map);
 }
 
 void setup_map_test_fixture()
@@ -85,5 +272,11 @@ void setup_map_test_fixture()
 		LX_ADD_TEST(insert_and_at_returns_correct_values);
 		LX_ADD_TEST(get_value_succeeds);
 		LX_ADD_TEST(rehash_succeeds);
+		LX_ADD_TEST(colliding_keys_are_kept_apart);
+		LX_ADD_TEST(removed_keys_do_not_hide_other_keys);
+		LX_ADD_TEST(integer_keys_respect_load_factor);
+		LX_ADD_TEST(iterator_visits_every_item_once);
+		LX_ADD_TEST(reserve_keeps_items_in_place);
+		LX_ADD_TEST(insert_many_inserts_every_item);
 		LX_TEST_FIXTURE_END();
 }
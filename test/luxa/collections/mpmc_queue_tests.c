@@ -0,0 +1,106 @@
+#include <test/luxa/collections/mpmc_queue_tests.h>
+#include <luxa/collections/mpmc_queue.h>
+#include <luxa/threading/threading.h>
+#include <luxa/test.h>
+
+#define MPMC_QUEUE_TEST_THREADS 4
+#define MPMC_QUEUE_TEST_ITEMS 20000
+
+typedef struct mpmc_queue_test_arg {
+	lx_mpmc_queue_t *queue;
+	volatile int64_t *num_popped;
+	volatile int64_t *sum;
+} mpmc_queue_test_arg_t;
+
+void mpmc_queue_push_until_full_and_pop_in_order()
+{
+	// Arrange
+	lx_mpmc_queue_t *queue = lx_mpmc_queue_create(lx_allocator_default(), sizeof(uint16_t), 16);
+
+	// Act
+	uint16_t num_pushed = 0;
+	while (lx_mpmc_queue_push(queue, &num_pushed)) {
+		num_pushed++;
+	}
+
+	// Assert
+	LX_EQUALS(num_pushed, 16);
+	LX_EQUALS(lx_mpmc_queue_size(queue), 16);
+
+	for (uint16_t i = 0; i < num_pushed; ++i) {
+		uint16_t item = 0;
+		LX_TRUE(lx_mpmc_queue_pop(queue, &item));
+		LX_EQUALS(item, i);
+	}
+
+	uint16_t item = 0;
+	LX_TRUE((!lx_mpmc_queue_pop(queue, &item)));
+	lx_mpmc_queue_destroy(queue);
+}
+
+static unsigned long mpmc_produce(mpmc_queue_test_arg_t *arg)
+{
+	for (int64_t i = 1; i <= MPMC_QUEUE_TEST_ITEMS; ++i) {
+		while (!lx_mpmc_queue_push(arg->queue, &i)) {
+			lx_thread_yield();
+		}
+	}
+
+	return 0;
+}
+
+static unsigned long mpmc_consume(mpmc_queue_test_arg_t *arg)
+{
+	const int64_t num_items = (int64_t)MPMC_QUEUE_TEST_THREADS * MPMC_QUEUE_TEST_ITEMS;
+	while (lx_atomic_load_64(arg->num_popped) < num_items) {
+		int64_t item = 0;
+		if (!lx_mpmc_queue_pop(arg->queue, &item)) {
+			lx_thread_yield();
+			continue;
+		}
+
+		lx_atomic_add_64(arg->sum, item);
+		lx_atomic_add_64(arg->num_popped, 1);
+	}
+
+	return 0;
+}
+
+void mpmc_queue_hands_every_item_to_one_consumer()
+{
+	// Arrange
+	lx_mpmc_queue_t *queue = lx_mpmc_queue_create(lx_allocator_default(), sizeof(int64_t), 128);
+	volatile int64_t num_popped = 0;
+	volatile int64_t sum = 0;
+	mpmc_queue_test_arg_t arg = { queue, &num_popped, &sum };
+	lx_thread_t producers[MPMC_QUEUE_TEST_THREADS];
+	lx_thread_t consumers[MPMC_QUEUE_TEST_THREADS];
+
+	// Act
+	for (size_t i = 0; i < MPMC_QUEUE_TEST_THREADS; ++i) {
+		lx_thread_create(&producers[i], mpmc_produce, &arg);
+		lx_thread_create(&consumers[i], mpmc_consume, &arg);
+	}
+
+	for (size_t i = 0; i < MPMC_QUEUE_TEST_THREADS; ++i) {
+		lx_thread_join(&producers[i]);
+		lx_thread_join(&consumers[i]);
+		lx_thread_destroy(&producers[i]);
+		lx_thread_destroy(&consumers[i]);
+	}
+
+	// Assert
+	const int64_t expected_sum = (int64_t)MPMC_QUEUE_TEST_THREADS * MPMC_QUEUE_TEST_ITEMS * (MPMC_QUEUE_TEST_ITEMS + 1) / 2;
+	LX_TRUE((num_popped == (int64_t)MPMC_QUEUE_TEST_THREADS * MPMC_QUEUE_TEST_ITEMS));
+	LX_TRUE((sum == expected_sum));
+	LX_EQUALS(lx_mpmc_queue_size(queue), 0);
+	lx_mpmc_queue_destroy(queue);
+}
+
+void setup_mpmc_queue_test_fixture()
+{
+	LX_TEST_FIXTURE_BEGIN("MpmcQueue");
+		LX_ADD_TEST(mpmc_queue_push_until_full_and_pop_in_order);
+		LX_ADD_TEST(mpmc_queue_hands_every_item_to_one_consumer);
+	LX_TEST_FIXTURE_END();
+}
@@ -45,10 +45,57 @@ void enqueue_dequeue_element_succeeds()
     LX_NULL(lx_queue_front(queue));
 }
 
+void grow_wrapped_queue_keeps_order()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_queue_t *queue = lx_queue_create(allocator, sizeof(int));
+    int next_value = 0;
+    int expected = 0;
+
+    // Move the head halfway through the buffer and fill it so the tail wraps around
+    for (; next_value < 10; ++next_value) {
+        lx_queue_enqueue(queue, &next_value);
+    }
+
+    for (; expected < 6; ++expected) {
+        lx_queue_dequeue(queue);
+    }
+
+    while (lx_queue_size(queue) < queue->capacity) {
+        lx_queue_enqueue(queue, &next_value);
+        ++next_value;
+    }
+
+    // Act
+    LX_TRUE((queue->tail < queue->head));
+    lx_queue_reserve(queue, queue->capacity * 3);
+    for (size_t i = 0; i < 64; ++i) {
+        lx_queue_enqueue(queue, &next_value);
+        ++next_value;
+    }
+
+    // Assert
+    size_t num_out_of_order = 0;
+    while (!lx_queue_is_empty(queue)) {
+        if (*(int *)lx_queue_front(queue) != expected)
+            ++num_out_of_order;
+
+        ++expected;
+        lx_queue_dequeue(queue);
+    }
+
+    LX_EQUALS(num_out_of_order, 0);
+    LX_EQUALS(expected, next_value);
+
+    lx_queue_destroy(queue);
+}
+
 void setup_queue_test_fixture()
 {
     LX_TEST_FIXTURE_BEGIN("Queue");
         LX_ADD_TEST(create_returns_new_queue);
         LX_ADD_TEST(enqueue_dequeue_element_succeeds);
+        LX_ADD_TEST(grow_wrapped_queue_keeps_order);
     LX_TEST_FIXTURE_END();
 }
@@ -0,0 +1,91 @@
+#include <test/luxa/collections/slot_map_tests.h>
+#include <luxa/collections/slot_map.h>
+#include <luxa/test.h>
+
+void slot_map_insert_and_at_succeeds()
+{
+	// Arrange
+	lx_slot_map_t *map = lx_slot_map_create(lx_allocator_default(), sizeof(int));
+	int a = 41;
+	int b = 42;
+
+	// Act
+	lx_handle_t handle_a = lx_slot_map_insert(map, &a);
+	lx_handle_t handle_b = lx_slot_map_insert(map, &b);
+
+	// Assert
+	LX_TRUE((handle_a != lx_nil_handle() && handle_b != lx_nil_handle()));
+	LX_EQUALS(*(int *)lx_slot_map_at(map, handle_a), 41);
+	LX_EQUALS(*(int *)lx_slot_map_at(map, handle_b), 42);
+	LX_EQUALS(lx_slot_map_size(map), 2);
+
+	lx_slot_map_destroy(map);
+}
+
+void slot_map_detects_stale_handles()
+{
+	// Arrange
+	lx_slot_map_t *map = lx_slot_map_create(lx_allocator_default(), sizeof(int));
+	int a = 41;
+	int b = 42;
+	lx_handle_t handle_a = lx_slot_map_insert(map, &a);
+
+	// Act
+	bool removed = lx_slot_map_remove(map, handle_a);
+	lx_handle_t handle_b = lx_slot_map_insert(map, &b);
+
+	// Assert
+	LX_TRUE(removed);
+	LX_EQUALS(lx_handle_slot(handle_b), lx_handle_slot(handle_a));
+	LX_TRUE((handle_b != handle_a));
+	LX_NULL(lx_slot_map_at(map, handle_a));
+	LX_TRUE((!lx_slot_map_remove(map, handle_a)));
+	LX_EQUALS(*(int *)lx_slot_map_at(map, handle_b), 42);
+
+	lx_slot_map_destroy(map);
+}
+
+void slot_map_keeps_items_packed()
+{
+	// Arrange
+	lx_slot_map_t *map = lx_slot_map_create(lx_allocator_default(), sizeof(int));
+	lx_handle_t handles[100];
+	for (int i = 0; i < 100; ++i) {
+		handles[i] = lx_slot_map_insert(map, &i);
+	}
+
+	// Act
+	for (int i = 0; i < 100; i += 2) {
+		lx_slot_map_remove(map, handles[i]);
+	}
+
+	// Assert
+	LX_EQUALS(lx_slot_map_size(map), 50);
+
+	int sum = 0;
+	lx_slot_map_for(int, item, map) {
+		LX_TRUE((*item % 2 == 1));
+		sum += *item;
+	}
+	LX_EQUALS(sum, 2500);
+
+	for (size_t i = 0; i < lx_slot_map_size(map); ++i) {
+		lx_handle_t handle = lx_slot_map_handle_at(map, i);
+		LX_TRUE((lx_slot_map_at(map, handle) == (int *)lx_slot_map_begin(map) + i));
+	}
+
+	for (int i = 1; i < 100; i += 2) {
+		LX_EQUALS(*(int *)lx_slot_map_at(map, handles[i]), i);
+	}
+
+	lx_slot_map_destroy(map);
+}
+
+void setup_slot_map_test_fixture()
+{
+	LX_TEST_FIXTURE_BEGIN("SlotMap");
+		LX_ADD_TEST(slot_map_insert_and_at_succeeds);
+		LX_ADD_TEST(slot_map_detects_stale_handles);
+		LX_ADD_TEST(slot_map_keeps_items_packed);
+	LX_TEST_FIXTURE_END();
+}
@@ -0,0 +1,80 @@
+#include <test/luxa/collections/spsc_queue_tests.h>
+#include <luxa/collections/spsc_queue.h>
+#include <luxa/threading/threading.h>
+#include <luxa/test.h>
+
+#define SPSC_QUEUE_TEST_ITEMS 100000
+
+void spsc_queue_push_until_full_and_pop_in_order()
+{
+	// Arrange
+	lx_spsc_queue_t *queue = lx_spsc_queue_create(lx_allocator_default(), sizeof(uint32_t), 8);
+
+	// Act
+	uint32_t num_pushed = 0;
+	while (lx_spsc_queue_push(queue, &num_pushed)) {
+		num_pushed++;
+	}
+
+	// Assert
+	LX_EQUALS(num_pushed, 8);
+	LX_EQUALS(lx_spsc_queue_size(queue), 8);
+
+	for (uint32_t i = 0; i < num_pushed; ++i) {
+		uint32_t item = 0;
+		LX_TRUE(lx_spsc_queue_pop(queue, &item));
+		LX_EQUALS(item, i);
+	}
+
+	uint32_t item = 0;
+	LX_TRUE((!lx_spsc_queue_pop(queue, &item)));
+	lx_spsc_queue_destroy(queue);
+}
+
+static unsigned long spsc_produce(lx_spsc_queue_t *queue)
+{
+	for (uint64_t i = 1; i <= SPSC_QUEUE_TEST_ITEMS; ++i) {
+		while (!lx_spsc_queue_push(queue, &i)) {
+			lx_thread_yield();
+		}
+	}
+
+	return 0;
+}
+
+void spsc_queue_hands_items_between_threads_in_order()
+{
+	// Arrange
+	lx_spsc_queue_t *queue = lx_spsc_queue_create(lx_allocator_default(), sizeof(uint64_t), 64);
+	lx_thread_t producer;
+
+	// Act
+	lx_thread_create(&producer, spsc_produce, queue);
+
+	uint64_t num_out_of_order = 0;
+	for (uint64_t expected = 1; expected <= SPSC_QUEUE_TEST_ITEMS; ++expected) {
+		uint64_t item = 0;
+		while (!lx_spsc_queue_pop(queue, &item)) {
+			lx_thread_yield();
+		}
+
+		if (item != expected)
+			num_out_of_order++;
+	}
+
+	lx_thread_join(&producer);
+	lx_thread_destroy(&producer);
+
+	// Assert
+	LX_EQUALS(num_out_of_order, 0);
+	LX_EQUALS(lx_spsc_queue_size(queue), 0);
+	lx_spsc_queue_destroy(queue);
+}
+
+void setup_spsc_queue_test_fixture()
+{
+	LX_TEST_FIXTURE_BEGIN("SpscQueue");
+		LX_ADD_TEST(spsc_queue_push_until_full_and_pop_in_order);
+		LX_ADD_TEST(spsc_queue_hands_items_between_threads_in_order);
+	LX_TEST_FIXTURE_END();
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void setup_spsc_queue_test_fixture();
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
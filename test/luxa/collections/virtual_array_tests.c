@@ -0,0 +1,115 @@
+#include <test/luxa/collections/virtual_array_tests.h>
+#include <luxa/test.h>
+#include <luxa/collections/virtual_array.h>
+
+void create_virtual_array_reserves_without_committing()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+
+	// Act
+	lx_virtual_array_t *numbers = lx_virtual_array_create(allocator, sizeof(int), 1024 * 1024);
+
+	// Assert
+	LX_NOT_NULL(numbers);
+	LX_NOT_NULL(numbers->buffer);
+	LX_EQUALS(lx_virtual_array_size(numbers), 0u);
+	LX_EQUALS(lx_virtual_array_capacity(numbers), 0u);
+	LX_TRUE((lx_virtual_array_max_size(numbers) >= 1024 * 1024));
+
+	lx_virtual_array_destroy(numbers);
+}
+
+void push_back_keeps_element_addresses()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_virtual_array_t *numbers = lx_virtual_array_create(allocator, sizeof(int), 1024 * 1024);
+	int value = 0;
+	int *first = lx_virtual_array_push_back(numbers, &value);
+
+	// Act
+	for (value = 1; value < 100000; ++value) {
+		lx_virtual_array_push_back(numbers, &value);
+	}
+
+	// Assert
+	LX_TRUE((first == lx_virtual_array_at(numbers, 0)));
+	LX_EQUALS(lx_virtual_array_size(numbers), 100000u);
+	for (int i = 0; i < 100000; ++i) {
+		LX_EQUALS(*(int *)lx_virtual_array_at(numbers, i), i);
+	}
+
+	lx_virtual_array_destroy(numbers);
+}
+
+void resize_zero_initializes_elements()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_virtual_array_t *numbers = lx_virtual_array_create(allocator, sizeof(int), 1024);
+	int value = 42;
+	lx_virtual_array_push_back(numbers, &value);
+	lx_virtual_array_clear(numbers);
+
+	// Act
+	lx_virtual_array_resize(numbers, 16);
+
+	// Assert
+	LX_EQUALS(lx_virtual_array_size(numbers), 16u);
+	for (int i = 0; i < 16; ++i) {
+		LX_EQUALS(*(int *)lx_virtual_array_at(numbers, i), 0);
+	}
+
+	lx_virtual_array_destroy(numbers);
+}
+
+void shrink_to_fit_decommits_unused_pages()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_virtual_array_t *numbers = lx_virtual_array_create(allocator, sizeof(int), 1024 * 1024);
+	lx_virtual_array_resize(numbers, 100000);
+
+	// Act
+	lx_virtual_array_resize(numbers, 1);
+	lx_virtual_array_shrink_to_fit(numbers);
+
+	// Assert
+	LX_EQUALS(numbers->committed_bytes, lx_virtual_memory_page_size());
+
+	lx_virtual_array_destroy(numbers);
+}
+
+void resize_beyond_max_size_fails()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_virtual_array_t *numbers = lx_virtual_array_create(allocator, sizeof(int), 1024);
+	const size_t max_size = lx_virtual_array_max_size(numbers);
+	int value = 1;
+
+	// Act
+	lx_result_t resize_to_max = lx_virtual_array_resize(numbers, max_size);
+	lx_result_t resize_beyond_max = lx_virtual_array_resize(numbers, max_size + 1);
+	int *pushed = lx_virtual_array_push_back(numbers, &value);
+
+	// Assert
+	LX_EQUALS(resize_to_max, LX_SUCCESS);
+	LX_EQUALS(resize_beyond_max, LX_ERROR);
+	LX_TRUE((pushed == NULL));
+	LX_EQUALS(lx_virtual_array_size(numbers), max_size);
+
+	lx_virtual_array_destroy(numbers);
+}
+
+void setup_virtual_array_test_fixture()
+{
+	LX_TEST_FIXTURE_BEGIN("VirtualArray")
+		LX_ADD_TEST(create_virtual_array_reserves_without_committing);
+		LX_ADD_TEST(push_back_keeps_element_addresses);
+		LX_ADD_TEST(resize_zero_initializes_elements);
+		LX_ADD_TEST(shrink_to_fit_decommits_unused_pages);
+		LX_ADD_TEST(resize_beyond_max_size_fails);
+	LX_TEST_FIXTURE_END()
+}
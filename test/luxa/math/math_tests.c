@@ -36,10 +36,196 @@ void matrix_look_at()
 	lx_mat4_mul(&t, &r, &v);
 }
 
+void aabb_transform_bounds_rotated_box()
+{
+	lx_aabb_t box = { { -1.0f, -2.0f, -3.0f }, { 1.0f, 2.0f, 3.0f } };
+	lx_mat4_t rotation, translation, m;
+	lx_mat4_set_rotation_z(LX_PI_OVER_2, &rotation);
+	lx_mat4_translation(10.0f, 0.0f, 0.0f, &translation);
+	lx_mat4_mul(&rotation, &translation, &m);
+
+	lx_aabb_t result;
+	lx_aabb_transform(&box, &m, &result);
+	LX_TRUE(lx_vec3_near_equal(&result.min, &(lx_vec3_t) { 8.0f, -1.0f, -3.0f }));
+	LX_TRUE(lx_vec3_near_equal(&result.max, &(lx_vec3_t) { 12.0f, 1.0f, 3.0f }));
+
+	lx_aabb_t empty;
+	lx_aabb_empty(&empty);
+	lx_aabb_transform(&empty, &m, &result);
+	LX_TRUE(lx_aabb_is_empty(&result));
+}
+
+void aabb_intersect_ray_returns_entry_distance()
+{
+	lx_aabb_t box = { { 4.0f, -1.0f, -1.0f }, { 6.0f, 1.0f, 1.0f } };
+	lx_ray_t ray = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } };
+	lx_vec3_t inv_direction = { 1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z };
+
+	float distance = -1.0f;
+	LX_TRUE(lx_aabb_intersect_ray(&box, &ray, &inv_direction, FLT_MAX, &distance));
+	LX_TRUE(lx_near_equalf(distance, 4.0f));
+	LX_TRUE((!lx_aabb_intersect_ray(&box, &ray, &inv_direction, 3.0f, &distance)));
+
+	ray.direction = (lx_vec3_t) { -1.0f, 0.0f, 0.0f };
+	inv_direction.x = -1.0f;
+	LX_TRUE((!lx_aabb_intersect_ray(&box, &ray, &inv_direction, FLT_MAX, &distance)));
+}
+
+static bool mat4_near_equal(const lx_mat4_t *a, const lx_mat4_t *b)
+{
+	for (size_t i = 0; i < 16; ++i) {
+		if (fabsf(a->m[i] - b->m[i]) > 1e-4f)
+			return false;
+	}
+	return true;
+}
+
+static void mat4_mul_reference(const lx_mat4_t *a, const lx_mat4_t *b, lx_mat4_t *out)
+{
+	for (size_t r = 0; r < 4; ++r) {
+		for (size_t c = 0; c < 4; ++c) {
+			float sum = 0.0f;
+			for (size_t k = 0; k < 4; ++k)
+				sum += a->m[r * 4 + k] * b->m[k * 4 + c];
+			out->m[r * 4 + c] = sum;
+		}
+	}
+}
+
+static void make_test_matrices(lx_mat4_t *a, lx_mat4_t *b)
+{
+	for (size_t i = 0; i < 16; ++i) {
+		a->m[i] = (float)(i + 1) * 0.5f - 3.0f;
+		b->m[i] = (float)((i * 7) % 16) * 0.25f - 1.0f;
+	}
+	a->m11 += 10.0f;
+	a->m22 += 10.0f;
+	a->m33 += 10.0f;
+	a->m44 += 10.0f;
+}
+
+void mat4_mul_matches_reference_and_allows_aliasing()
+{
+	// Arrange
+	lx_mat4_t a, b, expected;
+	make_test_matrices(&a, &b);
+	mat4_mul_reference(&a, &b, &expected);
+
+	// Act
+	lx_mat4_t result;
+	lx_mat4_mul(&a, &b, &result);
+	lx_mat4_t aliased = a;
+	lx_mat4_mul(&aliased, &b, &aliased);
+
+	// Assert
+	LX_TRUE(mat4_near_equal(&result, &expected));
+	LX_TRUE(mat4_near_equal(&aliased, &expected));
+}
+
+void mat4_transpose_add_and_sub()
+{
+	// Arrange
+	lx_mat4_t a, b;
+	make_test_matrices(&a, &b);
+
+	// Act
+	lx_mat4_t transposed, sum, difference;
+	lx_mat4_transpose(&a, &transposed);
+	lx_mat4_add(&a, &b, &sum);
+	lx_mat4_sub(&a, &b, &difference);
+
+	// Assert
+	for (size_t r = 0; r < 4; ++r) {
+		for (size_t c = 0; c < 4; ++c) {
+			LX_TRUE((transposed.m[c * 4 + r] == a.m[r * 4 + c]));
+			LX_TRUE(lx_near_equalf(sum.m[r * 4 + c], (a.m[r * 4 + c] + b.m[r * 4 + c])));
+			LX_TRUE(lx_near_equalf(difference.m[r * 4 + c], (a.m[r * 4 + c] - b.m[r * 4 + c])));
+		}
+	}
+}
+
+void mat4_inv_times_matrix_is_identity()
+{
+	// Arrange
+	lx_mat4_t a, b, identity;
+	make_test_matrices(&a, &b);
+	lx_mat4_identity(&identity);
+
+	lx_mat4_t rotation, translation, transform;
+	lx_mat4_set_rotation_z(0.3f, &rotation);
+	lx_mat4_translation(1.0f, -2.0f, 3.0f, &translation);
+	lx_mat4_mul(&rotation, &translation, &transform);
+
+	// Act
+	lx_mat4_t inverse, transform_inverse, result;
+	bool inverted = lx_mat4_inv(&a, &inverse);
+	bool transform_inverted = lx_mat4_inv(&transform, &transform_inverse);
+
+	lx_mat4_t singular;
+	lx_mat4_zero(&singular);
+	bool singular_inverted = lx_mat4_inv(&singular, &result);
+
+	// Assert
+	LX_TRUE(inverted);
+	lx_mat4_mul(&a, &inverse, &result);
+	LX_TRUE(mat4_near_equal(&result, &identity));
+
+	LX_TRUE(transform_inverted);
+	lx_mat4_mul(&transform_inverse, &transform, &result);
+	LX_TRUE(mat4_near_equal(&result, &identity));
+
+	LX_TRUE(!singular_inverted);
+}
+
+void transform_batch_matches_single_transforms()
+{
+	// Arrange
+	lx_mat4_t a, b;
+	make_test_matrices(&a, &b);
+
+	lx_vec3_t points[5];
+	lx_vec4_t vectors[5];
+	for (size_t i = 0; i < 5; ++i) {
+		points[i] = (lx_vec3_t) { (float)i, 1.0f - (float)i, 0.5f * (float)i };
+		vectors[i] = (lx_vec4_t) { (float)i, 2.0f, -(float)i, 1.0f };
+	}
+
+	// Act
+	lx_vec3_t transformed_points[5];
+	lx_vec4_t transformed_vectors[5];
+	lx_vec3_transform_4x4_batch(points, 5, &a, transformed_points);
+	lx_vec4_transform_batch(vectors, 5, &a, transformed_vectors);
+
+	// Assert
+	for (size_t i = 0; i < 5; ++i) {
+		lx_vec3_t expected_point;
+		lx_vec3_transform_4x4(&points[i], &a, &expected_point);
+		LX_TRUE(lx_vec3_near_equal(&transformed_points[i], &expected_point));
+
+		lx_vec4_t expected_vector;
+		lx_vec4_transform(&vectors[i], &a, &expected_vector);
+		LX_TRUE(lx_near_equalf(transformed_vectors[i].x, expected_vector.x));
+		LX_TRUE(lx_near_equalf(transformed_vectors[i].y, expected_vector.y));
+		LX_TRUE(lx_near_equalf(transformed_vectors[i].z, expected_vector.z));
+		LX_TRUE(lx_near_equalf(transformed_vectors[i].w, expected_vector.w));
+	}
+
+	lx_vec4_t v = { 1.0f, 2.0f, 3.0f, 1.0f }, expected;
+	lx_vec4_transform(&v, &a, &expected);
+	LX_TRUE((fabsf(expected.x - (a.m11 + 2.0f * a.m21 + 3.0f * a.m31 + a.m41)) < 1e-4f));
+	LX_TRUE((fabsf(expected.w - (a.m14 + 2.0f * a.m24 + 3.0f * a.m34 + a.m44)) < 1e-4f));
+}
+
 void setup_math_test_fixture()
 {
 	LX_TEST_FIXTURE_BEGIN("Math")
 		LX_ADD_TEST(vec3_tests);
 		LX_ADD_TEST(matrix_look_at);
+		LX_ADD_TEST(aabb_transform_bounds_rotated_box);
+		LX_ADD_TEST(aabb_intersect_ray_returns_entry_distance);
+		LX_ADD_TEST(mat4_mul_matches_reference_and_allows_aliasing);
+		LX_ADD_TEST(mat4_transpose_add_and_sub);
+		LX_ADD_TEST(mat4_inv_times_matrix_is_identity);
+		LX_ADD_TEST(transform_batch_matches_single_transforms);
 	LX_TEST_FIXTURE_END()
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <test/luxa/memory/arena_allocator_tests.h>
+#include <luxa/memory/arena_allocator.h>
+#include <luxa/test.h>
+
+void create_destroy_arena_allocator_succeeds()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+
+	// Act & Assert
+	lx_allocator_t *arena_allocator = lx_arena_allocator_create(allocator, 1024);
+	LX_NOT_NULL(arena_allocator);
+	lx_arena_allocator_destroy(arena_allocator);
+}
+
+void alloc_beyond_block_size_succeeds()
+{
+	// Arrange
+	lx_allocator_t *arena_allocator = lx_arena_allocator_create(lx_allocator_default(), 64);
+	int *values[32];
+
+	// Act
+	for (int i = 0; i < 32; ++i) {
+		values[i] = lx_alloc(arena_allocator, sizeof(int) * 8);
+		*values[i] = i;
+	}
+
+	int *large = lx_alloc(arena_allocator, 4096);
+	memset(large, 0, 4096);
+
+	// Assert
+	for (int i = 0; i < 32; ++i) {
+		LX_EQUALS(*values[i], i);
+		LX_EQUALS(((uintptr_t)values[i]) % 16, 0);
+	}
+
+	lx_arena_allocator_destroy(arena_allocator);
+}
+
+void realloc_last_allocation_grows_in_place()
+{
+	// Arrange
+	lx_allocator_t *arena_allocator = lx_arena_allocator_create(lx_allocator_default(), 1024);
+	int *first = lx_alloc(arena_allocator, sizeof(int));
+	*first = 42;
+
+	// Act
+	int *grown = lx_realloc(arena_allocator, first, sizeof(int) * 4);
+	int *other = lx_alloc(arena_allocator, sizeof(int));
+	int *moved = lx_realloc(arena_allocator, grown, sizeof(int) * 8);
+
+	// Assert
+	LX_TRUE((first == grown));
+	LX_TRUE((moved != grown));
+	LX_TRUE((moved != other));
+	LX_EQUALS(*moved, 42);
+
+	lx_arena_allocator_destroy(arena_allocator);
+}
+
+void rewind_and_reset_reuses_memory()
+{
+	// Arrange
+	lx_allocator_t *arena_allocator = lx_arena_allocator_create(lx_allocator_default(), 128);
+	void *first = lx_alloc(arena_allocator, 16);
+
+	// Act
+	lx_arena_marker_t marker = lx_arena_allocator_mark(arena_allocator);
+	void *second = lx_alloc(arena_allocator, 16);
+	for (int i = 0; i < 16; ++i) {
+		lx_alloc(arena_allocator, 64);
+	}
+
+	lx_arena_allocator_rewind(arena_allocator, marker);
+	void *second_after_rewind = lx_alloc(arena_allocator, 16);
+
+	lx_arena_allocator_reset(arena_allocator);
+	void *first_after_reset = lx_alloc(arena_allocator, 16);
+
+	// Assert
+	LX_TRUE((second == second_after_rewind));
+	LX_TRUE((first == first_after_reset));
+
+	lx_arena_allocator_destroy(arena_allocator);
+}
+
+void arena_alloc_aligned_succeeds()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_allocator_t *arena_allocator = lx_arena_allocator_create(allocator, 1024);
+
+	// Act
+	lx_alloc(arena_allocator, 8);
+	void *a = lx_alloc_aligned(arena_allocator, 100, 64);
+	lx_alloc(arena_allocator, 8);
+	void *b = lx_alloc_aligned(arena_allocator, 2048, 256);
+	void *c = lx_realloc_aligned(arena_allocator, b, 4096, 256);
+
+	// Assert
+	LX_EQUALS((uintptr_t)a % 64, 0);
+	LX_EQUALS((uintptr_t)b % 256, 0);
+	LX_EQUALS((uintptr_t)c % 256, 0);
+
+	lx_arena_allocator_destroy(arena_allocator);
+}
+
+void setup_arena_allocator_test_fixture()
+{
+	LX_TEST_FIXTURE_BEGIN("ArenaAllocator")
+		LX_ADD_TEST(create_destroy_arena_allocator_succeeds);
+		LX_ADD_TEST(alloc_beyond_block_size_succeeds);
+		LX_ADD_TEST(realloc_last_allocation_grows_in_place);
+		LX_ADD_TEST(rewind_and_reset_reuses_memory);
+		LX_ADD_TEST(arena_alloc_aligned_succeeds);
+	LX_TEST_FIXTURE_END()
+}
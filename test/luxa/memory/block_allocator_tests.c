@@ -27,10 +27,26 @@ void alloc_blocks_succeeds()
 	lx_block_allocator_destroy(block_allocator);
 }
 
+void alloc_aligned_blocks_succeeds()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_allocator_t *block_allocator = lx_block_allocator_create(allocator, 64, 4);
+
+	// Act & Assert
+	for (size_t i = 0; i < 16; ++i) {
+		void *p = lx_alloc_aligned(block_allocator, 64, 64);
+		LX_EQUALS((uintptr_t)p % 64, 0);
+	}
+
+	lx_block_allocator_destroy(block_allocator);
+}
+
 void setup_block_allocator_test_fixture()
 {
 	LX_TEST_FIXTURE_BEGIN("BlockAllocator")
 		LX_ADD_TEST(create_destroy_block_allocator_succeeds);
 		LX_ADD_TEST(alloc_blocks_succeeds);
+		LX_ADD_TEST(alloc_aligned_blocks_succeeds);
 	LX_TEST_FIXTURE_END()
 }
\ No newline at end of file
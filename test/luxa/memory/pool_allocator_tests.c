@@ -0,0 +1,188 @@
+#include <test/luxa/memory/pool_allocator_tests.h>
+#include <luxa/memory/pool_allocator.h>
+#include <luxa/memory/tracking_allocator.h>
+#include <luxa/threading/threading.h>
+#include <luxa/test.h>
+
+typedef struct free_args {
+	lx_allocator_t *allocator;
+	void *chunks[64];
+} free_args_t;
+
+static unsigned long free_chunks(free_args_t *args)
+{
+	for (size_t i = 0; i < 64; ++i) {
+		lx_free(args->allocator, args->chunks[i]);
+	}
+	return 0;
+}
+
+void create_destroy_pool_allocator_succeeds()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+
+	// Act & Assert
+	lx_allocator_t *pool_allocator = lx_pool_allocator_create(allocator);
+	LX_NOT_NULL(pool_allocator);
+	lx_pool_allocator_destroy(pool_allocator);
+}
+
+void alloc_size_classes_succeeds()
+{
+	// Arrange
+	lx_allocator_t *pool_allocator = lx_pool_allocator_create(lx_allocator_default());
+	const size_t sizes[] = { 1, 8, 16, 24, 100, 512, 1000, 4096, 5000, 100000 };
+	const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+	char *values[sizeof(sizes) / sizeof(sizes[0])];
+
+	// Act
+	for (size_t i = 0; i < num_sizes; ++i) {
+		values[i] = lx_alloc(pool_allocator, sizes[i]);
+		memset(values[i], (int)i, sizes[i]);
+	}
+
+	// Assert
+	for (size_t i = 0; i < num_sizes; ++i) {
+		LX_EQUALS(values[i][0], i);
+		LX_EQUALS(values[i][sizes[i] - 1], i);
+		LX_EQUALS(((uintptr_t)values[i]) % 16, 0);
+		lx_free(pool_allocator, values[i]);
+	}
+
+	lx_pool_allocator_destroy(pool_allocator);
+}
+
+void realloc_keeps_contents()
+{
+	// Arrange
+	lx_allocator_t *pool_allocator = lx_pool_allocator_create(lx_allocator_default());
+	int *values = lx_alloc(pool_allocator, sizeof(int) * 4);
+	for (int i = 0; i < 4; ++i) {
+		values[i] = i;
+	}
+
+	// Act
+	int *same = lx_realloc(pool_allocator, values, sizeof(int) * 3);
+	int *grown = lx_realloc(pool_allocator, same, sizeof(int) * 4096);
+
+	// Assert
+	LX_TRUE((same == values));
+	for (int i = 0; i < 3; ++i) {
+		LX_EQUALS(grown[i], i);
+	}
+
+	lx_free(pool_allocator, grown);
+	lx_pool_allocator_destroy(pool_allocator);
+}
+
+void free_from_other_thread_returns_chunks()
+{
+	// Arrange
+	lx_allocator_t *pool_allocator = lx_pool_allocator_create(lx_allocator_default());
+	free_args_t args = { .allocator = pool_allocator };
+	for (size_t i = 0; i < 64; ++i) {
+		args.chunks[i] = lx_alloc(pool_allocator, 32);
+	}
+
+	// Act
+	lx_thread_t thread;
+	lx_thread_create(&thread, free_chunks, &args);
+	lx_thread_join(&thread);
+	lx_thread_destroy(&thread);
+
+	void *chunk = lx_alloc(pool_allocator, 32);
+
+	// Assert
+	bool reused = false;
+	for (size_t i = 0; i < 64; ++i) {
+		reused |= chunk == args.chunks[i];
+	}
+	LX_TRUE(reused);
+
+	lx_pool_allocator_destroy(pool_allocator);
+}
+
+void pool_alloc_aligned_succeeds()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_allocator_t *pool_allocator = lx_pool_allocator_create(allocator);
+	const size_t alignments[] = { 16, 32, 64, 128, 4096, 8192 };
+
+	// Act & Assert
+	for (size_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); ++i) {
+		void *p = lx_alloc_aligned(pool_allocator, 24, alignments[i]);
+		LX_EQUALS((uintptr_t)p % alignments[i], 0);
+
+		p = lx_realloc_aligned(pool_allocator, p, 48, alignments[i]);
+		LX_EQUALS((uintptr_t)p % alignments[i], 0);
+		lx_free(pool_allocator, p);
+	}
+
+	lx_pool_allocator_destroy(pool_allocator);
+}
+
+void large_alloc_takes_little_more_than_its_size()
+{
+	// Arrange
+	lx_allocator_t *tracking_allocator = lx_tracking_allocator_create(lx_allocator_default(), 0);
+	lx_allocator_t *pool_allocator = lx_pool_allocator_create(tracking_allocator);
+	lx_allocation_stats_t before, after, freed;
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &before);
+
+	// Act
+	char *p = lx_alloc(pool_allocator, 5000);
+	memset(p, 0x7f, 5000);
+	p = lx_realloc(pool_allocator, p, 6000);
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &after);
+	const char last = p[4999];
+	lx_free(pool_allocator, p);
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &freed);
+
+	// Assert
+	LX_EQUALS(last, 0x7f);
+	LX_TRUE((after.live_bytes - before.live_bytes < 6000 + 256));
+	LX_EQUALS(freed.live_bytes, before.live_bytes);
+
+	lx_pool_allocator_destroy(pool_allocator);
+	lx_tracking_allocator_destroy(tracking_allocator);
+}
+
+void free_after_chunk_ending_in_block_header_returns_chunk()
+{
+	// Arrange
+	lx_allocator_t *pool_allocator = lx_pool_allocator_create(lx_allocator_default());
+	uintptr_t *first = lx_alloc(pool_allocator, 64);
+	char *second = lx_alloc(pool_allocator, 64);
+	LX_TRUE(((char *)first + 64 == second));
+
+	// The tail of the first chunk looks like the header the pool once put in front of large blocks
+	first[5] = (uintptr_t)0xdeadbeef;
+	first[6] = 1024 * 1024;
+	first[7] = (uintptr_t)second ^ (uintptr_t)0x9e3779b97f4a7c15ull;
+
+	// Act
+	lx_free(pool_allocator, second);
+	char *reused = lx_alloc(pool_allocator, 64);
+
+	// Assert
+	LX_TRUE((reused == second));
+
+	lx_free(pool_allocator, reused);
+	lx_free(pool_allocator, first);
+	lx_pool_allocator_destroy(pool_allocator);
+}
+
+void setup_pool_allocator_test_fixture()
+{
+	LX_TEST_FIXTURE_BEGIN("PoolAllocator")
+		LX_ADD_TEST(create_destroy_pool_allocator_succeeds);
+		LX_ADD_TEST(alloc_size_classes_succeeds);
+		LX_ADD_TEST(realloc_keeps_contents);
+		LX_ADD_TEST(free_from_other_thread_returns_chunks);
+		LX_ADD_TEST(pool_alloc_aligned_succeeds);
+		LX_ADD_TEST(large_alloc_takes_little_more_than_its_size);
+		LX_ADD_TEST(free_after_chunk_ending_in_block_header_returns_chunk);
+	LX_TEST_FIXTURE_END()
+}
@@ -0,0 +1,235 @@
+#include <test/luxa/memory/tracking_allocator_tests.h>
+#include <luxa/memory/tracking_allocator.h>
+#include <luxa/threading/threading.h>
+#include <luxa/log.h>
+#include <luxa/test.h>
+
+#define NUM_ALLOCATING_THREADS 4
+#define NUM_THREAD_ALLOCATIONS 1000
+
+typedef struct allocating_thread_args {
+	lx_allocator_t *allocator;
+	void *allocations[NUM_THREAD_ALLOCATIONS];
+} allocating_thread_args_t;
+
+static void allocate_and_free_half(lx_any_t arg)
+{
+	allocating_thread_args_t *args = arg;
+
+	for (size_t i = 0; i < NUM_THREAD_ALLOCATIONS; ++i) {
+		args->allocations[i] = lx_alloc(args->allocator, 256);
+	}
+
+	// Keep every other allocation alive so the thread leaves live bytes behind in its counters
+	for (size_t i = 0; i < NUM_THREAD_ALLOCATIONS; i += 2) {
+		lx_free(args->allocator, args->allocations[i]);
+	}
+}
+
+void tracking_allocator_records_live_and_peak_bytes()
+{
+	// Arrange
+	lx_allocator_t *tracking_allocator = lx_tracking_allocator_create(lx_allocator_default(), 0);
+	lx_allocation_stats_t stats;
+
+	// Act
+	void *a = lx_alloc(tracking_allocator, 100);
+	void *b = lx_alloc(tracking_allocator, 28);
+	lx_free(tracking_allocator, a);
+	b = lx_realloc(tracking_allocator, b, 64);
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &stats);
+
+	// Assert
+	LX_EQUALS(stats.live_bytes, 64);
+	LX_EQUALS(stats.peak_bytes, 128);
+	LX_EQUALS(stats.live_allocations, 1);
+	LX_EQUALS(stats.num_allocations, 3);
+	LX_EQUALS(stats.num_frees, 2);
+	LX_EQUALS(stats.histogram[6], 2);
+	LX_EQUALS(stats.histogram[4], 1);
+
+	lx_free(tracking_allocator, b);
+	lx_tracking_allocator_destroy(tracking_allocator);
+}
+
+void tracking_allocator_accounts_tags()
+{
+	// Arrange
+	lx_allocator_t *tracking_allocator = lx_tracking_allocator_create(lx_allocator_default(), 0);
+	lx_allocator_t *scene_allocator = lx_tracking_allocator_tag(tracking_allocator, "Scene");
+	lx_allocator_t *mesh_allocator = lx_tracking_allocator_tag(tracking_allocator, "Mesh");
+	lx_allocation_stats_t scene_stats, mesh_stats, total_stats;
+
+	// Act
+	void *a = lx_alloc(scene_allocator, 16);
+	void *b = lx_alloc(mesh_allocator, 32);
+	void *c = lx_alloc(mesh_allocator, 32);
+	lx_free(tracking_allocator, c);
+
+	lx_tracking_allocator_stats(tracking_allocator, "Scene", &scene_stats);
+	lx_tracking_allocator_stats(tracking_allocator, "Mesh", &mesh_stats);
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &total_stats);
+
+	// Assert
+	LX_TRUE((scene_allocator == lx_tracking_allocator_tag(tracking_allocator, "Scene")));
+	LX_EQUALS(scene_stats.live_bytes, 16);
+	LX_EQUALS(mesh_stats.live_bytes, 32);
+	LX_EQUALS(mesh_stats.peak_bytes, 64);
+	LX_EQUALS(total_stats.live_bytes, 48);
+
+	lx_free(scene_allocator, a);
+	lx_free(mesh_allocator, b);
+	lx_tracking_allocator_destroy(tracking_allocator);
+}
+
+void tracking_allocator_reports_leaks()
+{
+	// Arrange
+	lx_initialize_log(lx_allocator_default(), LX_LOG_LEVEL_OFF);
+	lx_allocator_t *tracking_allocator = lx_tracking_allocator_create(lx_allocator_default(), 1);
+	void *a = lx_alloc(tracking_allocator, 16);
+	void *b = lx_alloc(lx_tracking_allocator_tag(tracking_allocator, "Leaky"), 16);
+
+	// Act
+	lx_free(tracking_allocator, a);
+	size_t num_leaks = lx_tracking_allocator_report_leaks(tracking_allocator);
+
+	// Assert
+	LX_EQUALS(num_leaks, 1);
+
+	lx_free(tracking_allocator, b);
+	LX_EQUALS(lx_tracking_allocator_report_leaks(tracking_allocator), 0);
+
+	lx_tracking_allocator_destroy(tracking_allocator);
+	lx_shutdown_log();
+}
+
+void tracking_allocator_tag_beyond_max_tags_is_untagged()
+{
+	// Arrange
+	lx_initialize_log(lx_allocator_default(), LX_LOG_LEVEL_OFF);
+	lx_allocator_t *tracking_allocator = lx_tracking_allocator_create(lx_allocator_default(), 0);
+	lx_allocation_stats_t total_stats, overflow_stats;
+
+	// The untagged allocator takes the first tag
+	char name[16];
+	for (uint32_t i = 1; i < LX_TRACKING_MAX_TAGS; ++i) {
+		sprintf_s(name, sizeof(name), "Tag %u", i);
+		lx_tracking_allocator_tag(tracking_allocator, name);
+	}
+
+	// Act
+	lx_allocator_t *overflow_allocator = lx_tracking_allocator_tag(tracking_allocator, "Overflow");
+	void *p = lx_alloc(overflow_allocator, 32);
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &total_stats);
+	lx_tracking_allocator_stats(tracking_allocator, "Overflow", &overflow_stats);
+
+	// Assert
+	LX_TRUE((overflow_allocator == tracking_allocator));
+	LX_EQUALS(total_stats.live_bytes, 32);
+	LX_EQUALS(overflow_stats.live_bytes, 0);
+
+	lx_free(overflow_allocator, p);
+	lx_tracking_allocator_destroy(tracking_allocator);
+	lx_shutdown_log();
+}
+
+void tracking_allocator_accounts_call_sites()
+{
+	// Arrange
+	lx_allocator_t *tracking_allocator = lx_tracking_allocator_create(lx_allocator_default(), 0);
+	// On one line so the allocator and the name expand to the same call site
+	lx_allocator_t *first_site = lx_tracking_allocator_call_site(tracking_allocator); const char *first_site_name = LX_TRACKING_CALL_SITE;
+	lx_allocator_t *second_site = lx_tracking_allocator_call_site(tracking_allocator);
+	lx_allocation_stats_t first_stats;
+
+	// Act
+	void *a = lx_alloc(first_site, 16);
+	void *b = lx_alloc(second_site, 64);
+	lx_tracking_allocator_stats(tracking_allocator, first_site_name, &first_stats);
+
+	// Assert
+	LX_TRUE((first_site != second_site));
+	LX_EQUALS(first_stats.live_bytes, 16);
+	LX_EQUALS(first_stats.num_allocations, 1);
+
+	lx_free(first_site, a);
+	lx_free(second_site, b);
+	lx_tracking_allocator_destroy(tracking_allocator);
+}
+
+void tracking_allocator_alloc_aligned_succeeds()
+{
+	// Arrange
+	lx_allocator_t *tracking_allocator = lx_tracking_allocator_create(lx_allocator_default(), 1);
+	lx_allocation_stats_t stats;
+
+	// Act
+	char *p = lx_alloc_aligned(tracking_allocator, 32, 64);
+	memset(p, 1, 32);
+	p = lx_realloc_aligned(tracking_allocator, p, 256, 64);
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &stats);
+
+	// Assert
+	LX_EQUALS((uintptr_t)p % 64, 0);
+	LX_EQUALS(p[31], 1);
+	LX_EQUALS(stats.live_bytes, 256);
+
+	lx_free(tracking_allocator, p);
+	lx_tracking_allocator_destroy(tracking_allocator);
+}
+
+void tracking_allocator_sums_counters_of_all_threads()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_allocator_t *tracking_allocator = lx_tracking_allocator_create(allocator, 0);
+	allocating_thread_args_t *args = lx_alloc(allocator, sizeof(allocating_thread_args_t) * NUM_ALLOCATING_THREADS);
+	lx_thread_t threads[NUM_ALLOCATING_THREADS];
+	lx_allocation_stats_t stats;
+
+	// Act
+	for (size_t i = 0; i < NUM_ALLOCATING_THREADS; ++i) {
+		args[i].allocator = tracking_allocator;
+		lx_thread_create(&threads[i], allocate_and_free_half, &args[i]);
+	}
+
+	for (size_t i = 0; i < NUM_ALLOCATING_THREADS; ++i) {
+		lx_thread_join(&threads[i]);
+		lx_thread_destroy(&threads[i]);
+	}
+
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &stats);
+
+	// Assert
+	LX_EQUALS(stats.num_allocations, NUM_ALLOCATING_THREADS * NUM_THREAD_ALLOCATIONS);
+	LX_EQUALS(stats.num_frees, NUM_ALLOCATING_THREADS * NUM_THREAD_ALLOCATIONS / 2);
+	LX_EQUALS(stats.live_allocations, NUM_ALLOCATING_THREADS * NUM_THREAD_ALLOCATIONS / 2);
+	LX_EQUALS(stats.live_bytes, NUM_ALLOCATING_THREADS * NUM_THREAD_ALLOCATIONS / 2 * 256);
+	LX_TRUE((stats.peak_bytes >= stats.live_bytes));
+
+	for (size_t i = 0; i < NUM_ALLOCATING_THREADS; ++i) {
+		for (size_t j = 1; j < NUM_THREAD_ALLOCATIONS; j += 2) {
+			lx_free(tracking_allocator, args[i].allocations[j]);
+		}
+	}
+
+	lx_tracking_allocator_stats(tracking_allocator, NULL, &stats);
+	LX_EQUALS(stats.live_bytes, 0);
+
+	lx_free(allocator, args);
+	lx_tracking_allocator_destroy(tracking_allocator);
+}
+
+void setup_tracking_allocator_test_fixture()
+{
+	LX_TEST_FIXTURE_BEGIN("TrackingAllocator")
+		LX_ADD_TEST(tracking_allocator_records_live_and_peak_bytes);
+		LX_ADD_TEST(tracking_allocator_accounts_tags);
+		LX_ADD_TEST(tracking_allocator_reports_leaks);
+		LX_ADD_TEST(tracking_allocator_accounts_call_sites);
+		LX_ADD_TEST(tracking_allocator_tag_beyond_max_tags_is_untagged);
+		LX_ADD_TEST(tracking_allocator_alloc_aligned_succeeds);
+		LX_ADD_TEST(tracking_allocator_sums_counters_of_all_threads);
+	LX_TEST_FIXTURE_END()
+}
@@ -0,0 +1,210 @@
+#include <test/luxa/renderer/bvh_tests.h>
+#include <luxa/test.h>
+#include <luxa/renderer/bvh.h>
+#include <luxa/threading/task/task.h>
+
+#define NUM_BOXES 20000
+#define NUM_QUERIES 100
+
+static float random_float(uint32_t *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return (float)(*seed >> 8) / 16777216.0f;
+}
+
+// Small boxes scattered in a 100 unit cube, every seventh box is empty
+static lx_aabb_t *create_boxes(lx_allocator_t *allocator, uint32_t seed)
+{
+    lx_aabb_t *boxes = lx_alloc(allocator, sizeof(lx_aabb_t) * NUM_BOXES);
+    for (size_t i = 0; i < NUM_BOXES; ++i) {
+        if (i % 7 == 0) {
+            lx_aabb_empty(&boxes[i]);
+            continue;
+        }
+
+        boxes[i].min = (lx_vec3_t) { random_float(&seed) * 100.0f, random_float(&seed) * 100.0f, random_float(&seed) * 100.0f };
+        boxes[i].max = (lx_vec3_t) { boxes[i].min.x + random_float(&seed), boxes[i].min.y + random_float(&seed), boxes[i].min.z + random_float(&seed) };
+    }
+
+    return boxes;
+}
+
+static size_t count_intersecting_boxes(const lx_aabb_t *boxes, const lx_aabb_t *bounds)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < NUM_BOXES; ++i) {
+        count += !lx_aabb_is_empty(&boxes[i]) && lx_aabb_intersects(&boxes[i], bounds);
+    }
+
+    return count;
+}
+
+static size_t count_wrong_queries(const lx_bvh_t *bvh, const lx_aabb_t *boxes, uint32_t seed)
+{
+    lx_array_t *items = lx_array_create(lx_allocator_default(), sizeof(uint32_t));
+    size_t num_wrong = 0;
+
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        lx_aabb_t bounds;
+        bounds.min = (lx_vec3_t) { random_float(&seed) * 100.0f, random_float(&seed) * 100.0f, random_float(&seed) * 100.0f };
+        bounds.max = (lx_vec3_t) { bounds.min.x + 5.0f, bounds.min.y + 5.0f, bounds.min.z + 5.0f };
+
+        lx_array_clear(items);
+        lx_bvh_query_aabb(bvh, &bounds, items);
+
+        bool wrong = lx_array_size(items) != count_intersecting_boxes(boxes, &bounds);
+        lx_array_for(uint32_t, item, items) {
+            wrong |= !lx_aabb_intersects(&boxes[*item], &bounds);
+        }
+
+        num_wrong += wrong;
+    }
+
+    lx_array_destroy(items);
+    return num_wrong;
+}
+
+void build_leaves_out_empty_boxes()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_aabb_t *boxes = create_boxes(allocator, 1);
+    lx_bvh_t *bvh = lx_bvh_create(allocator);
+
+    // Act
+    lx_bvh_build(bvh, boxes, NUM_BOXES, NULL);
+
+    // Assert
+    LX_EQUALS(lx_bvh_num_items(bvh), NUM_BOXES - (NUM_BOXES + 6) / 7);
+    LX_TRUE(lx_near_equalf(lx_bvh_refit_cost(bvh), 1.0f));
+
+    lx_bvh_destroy(bvh);
+    lx_free(allocator, boxes);
+}
+
+void query_aabb_matches_linear_scan()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_aabb_t *boxes = create_boxes(allocator, 2);
+    lx_bvh_t *bvh = lx_bvh_create(allocator);
+
+    // Act
+    lx_bvh_build(bvh, boxes, NUM_BOXES, NULL);
+
+    // Assert
+    LX_EQUALS(count_wrong_queries(bvh, boxes, 3), 0);
+
+    lx_bvh_destroy(bvh);
+    lx_free(allocator, boxes);
+}
+
+void parallel_build_matches_linear_scan()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+    lx_aabb_t *boxes = create_boxes(allocator, 4);
+    lx_bvh_t *bvh = lx_bvh_create(allocator);
+
+    // Act
+    lx_bvh_build(bvh, boxes, NUM_BOXES, task_factory);
+
+    // Assert
+    LX_EQUALS(lx_bvh_num_items(bvh), NUM_BOXES - (NUM_BOXES + 6) / 7);
+    LX_EQUALS(count_wrong_queries(bvh, boxes, 5), 0);
+
+    lx_bvh_destroy(bvh);
+    lx_free(allocator, boxes);
+}
+
+void parallel_build_of_lopsided_splits_matches_linear_scan()
+{
+    // Arrange, boxes spaced exponentially along x so every split only peels off the far end
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+    lx_aabb_t *boxes = lx_alloc(allocator, sizeof(lx_aabb_t) * NUM_BOXES);
+    for (size_t i = 0; i < NUM_BOXES; ++i) {
+        const float x = expf((float)i * 0.0035f) - 1.0f;
+        boxes[i].min = (lx_vec3_t) { x, 50.0f, 50.0f };
+        boxes[i].max = (lx_vec3_t) { x + 0.5f, 50.5f, 50.5f };
+    }
+
+    lx_bvh_t *bvh = lx_bvh_create(allocator);
+
+    // Act
+    lx_bvh_build(bvh, boxes, NUM_BOXES, task_factory);
+
+    // Assert
+    LX_EQUALS(lx_bvh_num_items(bvh), NUM_BOXES);
+    LX_EQUALS(count_wrong_queries(bvh, boxes, 6), 0);
+
+    lx_bvh_destroy(bvh);
+    lx_free(allocator, boxes);
+}
+
+void raycast_returns_nearest_item()
+{
+    // Arrange
+    lx_aabb_t boxes[] = {
+        { { 10.0f, -1.0f, -1.0f }, { 11.0f, 1.0f, 1.0f } },
+        { { 4.0f, -1.0f, -1.0f }, { 5.0f, 1.0f, 1.0f } },
+        { { 4.0f, 5.0f, -1.0f }, { 5.0f, 6.0f, 1.0f } },
+        { { -5.0f, -1.0f, -1.0f }, { -4.0f, 1.0f, 1.0f } }
+    };
+    lx_bvh_t *bvh = lx_bvh_create(lx_allocator_default());
+    lx_bvh_build(bvh, boxes, sizeof(boxes) / sizeof(boxes[0]), NULL);
+    lx_ray_t ray = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } };
+
+    // Act
+    uint32_t item = 0;
+    float distance = 0.0f;
+    bool hit = lx_bvh_raycast(bvh, &ray, FLT_MAX, &item, &distance);
+
+    // Assert
+    LX_TRUE(hit);
+    LX_EQUALS(item, 1);
+    LX_TRUE(lx_near_equalf(distance, 4.0f));
+    LX_TRUE((!lx_bvh_raycast(bvh, &ray, 3.0f, &item, &distance)));
+
+    lx_bvh_destroy(bvh);
+}
+
+void refit_follows_moved_items()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_aabb_t *boxes = create_boxes(allocator, 6);
+    lx_bvh_t *bvh = lx_bvh_create(allocator);
+    lx_bvh_build(bvh, boxes, NUM_BOXES, NULL);
+
+    // Spread the boxes out along x, nodes that were apart start to overlap
+    uint32_t seed = 7;
+    for (size_t i = 0; i < NUM_BOXES; ++i) {
+        const float offset = random_float(&seed) * 50.0f;
+        boxes[i].min.x += offset;
+        boxes[i].max.x += offset;
+    }
+
+    // Act
+    lx_bvh_refit(bvh, boxes);
+
+    // Assert
+    LX_EQUALS(count_wrong_queries(bvh, boxes, 8), 0);
+    LX_TRUE((lx_bvh_refit_cost(bvh) > 1.0f));
+
+    lx_bvh_destroy(bvh);
+    lx_free(allocator, boxes);
+}
+
+void setup_bvh_test_fixture()
+{
+    LX_TEST_FIXTURE_BEGIN("BVH")
+        LX_ADD_TEST(build_leaves_out_empty_boxes);
+        LX_ADD_TEST(query_aabb_matches_linear_scan);
+        LX_ADD_TEST(parallel_build_matches_linear_scan);
+        LX_ADD_TEST(parallel_build_of_lopsided_splits_matches_linear_scan);
+        LX_ADD_TEST(raycast_returns_nearest_item);
+        LX_ADD_TEST(refit_follows_moved_items);
+    LX_TEST_FIXTURE_END()
+}
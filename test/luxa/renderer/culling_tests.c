@@ -0,0 +1,156 @@
+#include <test/luxa/renderer/culling_tests.h>
+#include <luxa/test.h>
+#include <luxa/renderer/culling.h>
+#include <luxa/renderer/scene.h>
+
+#define NUM_BOXES 1003
+
+static float random_float(uint32_t *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return (float)(*seed >> 8) / 16777216.0f;
+}
+
+// Camera at the origin looking down +z with a 90 degree field of view
+static void create_frustum(lx_frustum_t *frustum)
+{
+    lx_mat4_t view, projection, view_projection;
+    lx_vec3_t direction = { 0.0f, 0.0f, 1.0f }, position = { 0.0f, 0.0f, 0.0f }, up = { 0.0f, 1.0f, 0.0f };
+    lx_mat4_look_to(&direction, &position, &up, &view);
+    lx_mat4_perspective_fov(0.1f, 100.0f, LX_PI_OVER_2, 1.0f, &projection);
+    lx_mat4_mul(&view, &projection, &view_projection);
+    lx_frustum_from_view_projection(&view_projection, frustum);
+}
+
+void frustum_intersects_boxes_in_view()
+{
+    // Arrange
+    lx_frustum_t frustum;
+    create_frustum(&frustum);
+
+    lx_aabb_t in_front = { { -1.0f, -1.0f, 9.0f }, { 1.0f, 1.0f, 11.0f } };
+    lx_aabb_t behind = { { -1.0f, -1.0f, -11.0f }, { 1.0f, 1.0f, -9.0f } };
+    lx_aabb_t left = { { -31.0f, -1.0f, 9.0f }, { -29.0f, 1.0f, 11.0f } };
+    lx_aabb_t beyond_far = { { -1.0f, -1.0f, 101.0f }, { 1.0f, 1.0f, 103.0f } };
+    lx_aabb_t straddling_left = { { -12.0f, -1.0f, 9.0f }, { -8.0f, 1.0f, 11.0f } };
+    lx_aabb_t empty;
+    lx_aabb_empty(&empty);
+
+    // Act & Assert
+    LX_TRUE(lx_frustum_intersects_aabb(&frustum, &in_front));
+    LX_TRUE((!lx_frustum_intersects_aabb(&frustum, &behind)));
+    LX_TRUE((!lx_frustum_intersects_aabb(&frustum, &left)));
+    LX_TRUE((!lx_frustum_intersects_aabb(&frustum, &beyond_far)));
+    LX_TRUE(lx_frustum_intersects_aabb(&frustum, &straddling_left));
+    LX_TRUE((!lx_frustum_intersects_aabb(&frustum, &empty)));
+}
+
+void frustum_cull_matches_per_box_test()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_frustum_t frustum;
+    create_frustum(&frustum);
+
+    // An odd count leaves a tail after the last full batch, every tenth box is empty
+    lx_aabb_t *boxes = lx_alloc(allocator, sizeof(lx_aabb_t) * NUM_BOXES);
+    float *columns = lx_alloc(allocator, sizeof(float) * NUM_BOXES * 6);
+    uint32_t *visible = lx_alloc(allocator, sizeof(uint32_t) * NUM_BOXES);
+    uint32_t seed = 1;
+
+    for (size_t i = 0; i < NUM_BOXES; ++i) {
+        if (i % 10 == 0) {
+            lx_aabb_empty(&boxes[i]);
+        } else {
+            lx_vec3_t center = { random_float(&seed) * 200.0f - 100.0f, random_float(&seed) * 200.0f - 100.0f, random_float(&seed) * 200.0f - 100.0f };
+            boxes[i].min = (lx_vec3_t) { center.x - 1.0f, center.y - 2.0f, center.z - 3.0f };
+            boxes[i].max = (lx_vec3_t) { center.x + 1.0f, center.y + 2.0f, center.z + 3.0f };
+        }
+
+        lx_vec3_t center, extent;
+        lx_aabb_center_extent(&boxes[i], &center, &extent);
+        columns[i] = center.x;
+        columns[NUM_BOXES + i] = center.y;
+        columns[NUM_BOXES * 2 + i] = center.z;
+        columns[NUM_BOXES * 3 + i] = extent.x;
+        columns[NUM_BOXES * 4 + i] = extent.y;
+        columns[NUM_BOXES * 5 + i] = extent.z;
+    }
+
+    lx_cull_bounds_t bounds = {
+        .center_x = columns,
+        .center_y = columns + NUM_BOXES,
+        .center_z = columns + NUM_BOXES * 2,
+        .extent_x = columns + NUM_BOXES * 3,
+        .extent_y = columns + NUM_BOXES * 4,
+        .extent_z = columns + NUM_BOXES * 5,
+        .count = NUM_BOXES
+    };
+
+    // Act
+    const size_t num_visible = lx_frustum_cull(&frustum, &bounds, 1, NUM_BOXES, visible);
+
+    // Assert
+    size_t expected = 0;
+    size_t num_wrong = 0;
+    for (size_t i = 1; i < NUM_BOXES; ++i) {
+        if (!lx_frustum_intersects_aabb(&frustum, &boxes[i]))
+            continue;
+
+        num_wrong += expected >= num_visible || visible[expected] != i;
+        expected++;
+    }
+
+    LX_TRUE((expected > 0));
+    LX_EQUALS(num_visible, expected);
+    LX_EQUALS(num_wrong, 0);
+
+    lx_free(allocator, visible);
+    lx_free(allocator, columns);
+    lx_free(allocator, boxes);
+}
+
+void scene_cull_bounds_skip_nodes_without_bounds()
+{
+    // Arrange
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+    lx_scene_node_t visible_node = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t hidden_node = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_create_node(scene, lx_scene_root_node());
+
+    lx_aabb_t unit_box = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+    lx_scene_set_local_bounds(scene, visible_node, &unit_box);
+    lx_scene_set_local_bounds(scene, hidden_node, &unit_box);
+
+    lx_mat4_t translation;
+    lx_mat4_translation(0.0f, 0.0f, 10.0f, &translation);
+    lx_scene_set_local_transform(scene, visible_node, &translation);
+    lx_mat4_translation(0.0f, 0.0f, -10.0f, &translation);
+    lx_scene_set_local_transform(scene, hidden_node, &translation);
+    lx_scene_update_transforms(scene, NULL);
+
+    lx_frustum_t frustum;
+    create_frustum(&frustum);
+
+    // Act
+    lx_cull_bounds_t bounds;
+    lx_scene_cull_bounds(scene, &bounds);
+    uint32_t visible[8];
+    const size_t num_visible = lx_frustum_cull(&frustum, &bounds, 1, bounds.count, visible);
+
+    // Assert
+    LX_EQUALS(bounds.count, lx_scene_size(scene));
+    LX_EQUALS(num_visible, 1);
+    LX_EQUALS(visible[0], visible_node);
+
+    lx_scene_destroy(scene);
+}
+
+void setup_culling_test_fixture()
+{
+    LX_TEST_FIXTURE_BEGIN("Culling")
+        LX_ADD_TEST(frustum_intersects_boxes_in_view);
+        LX_ADD_TEST(frustum_cull_matches_per_box_test);
+        LX_ADD_TEST(scene_cull_bounds_skip_nodes_without_bounds);
+    LX_TEST_FIXTURE_END()
+}
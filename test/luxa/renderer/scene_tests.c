@@ -1,6 +1,8 @@
 #include <test/luxa/renderer/scene_tests.h>
 #include <luxa/test.h>
 #include <luxa/renderer/scene.h>
+#include <luxa/log.h>
+#include <luxa/threading/task/task.h>
 
 void create_scene_succeeds()
 {
@@ -47,10 +49,364 @@ void create_hierarchy_succeeds()
     LX_EQUALS(child, 7);
 }
 
+void grow_scene_keeps_hierarchy()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_scene_t *scene = lx_scene_create(allocator);
+    lx_scene_node_t parent = lx_scene_root_node();
+
+    // Act
+    for (size_t i = 0; i < 1000; ++i) {
+        parent = lx_scene_create_node(scene, parent);
+    }
+
+    // Assert
+    LX_EQUALS((uintptr_t)lx_scene_world_transform(scene, 0) % LX_CACHE_LINE_SIZE, 0);
+
+    lx_scene_node_t node = lx_scene_root_node();
+    for (size_t i = 0; i < 1000; ++i) {
+        node = lx_scene_first_child(scene, node);
+        LX_EQUALS(node, i + 2);
+    }
+
+    lx_scene_destroy(scene);
+}
+
+void destroyed_renderable_has_no_render_data()
+{
+    // Arrange
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+    int mesh_a = 1, mesh_b = 2;
+    lx_renderable_t a = lx_scene_create_renderable(scene, LX_RENDERABLE_TYPE_MESH, &mesh_a);
+    lx_renderable_t b = lx_scene_create_renderable(scene, LX_RENDERABLE_TYPE_MESH, &mesh_b);
+
+    // Act
+    bool destroyed = lx_scene_destroy_renderable(scene, a);
+    lx_renderable_t c = lx_scene_create_renderable(scene, LX_RENDERABLE_TYPE_MESH, &mesh_a);
+
+    // Assert
+    LX_TRUE(destroyed);
+    LX_NULL(lx_scene_render_data(scene, a));
+    LX_TRUE((lx_scene_render_data(scene, b)->data == &mesh_b));
+    LX_TRUE((lx_scene_render_data(scene, c)->handle == c));
+    LX_EQUALS(lx_scene_num_renderables(scene), 2);
+
+    lx_scene_destroy(scene);
+}
+
+void update_transforms_composes_parent_transforms()
+{
+    // Arrange
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+    lx_scene_node_t a = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t b = lx_scene_create_node(scene, a);
+    lx_scene_node_t c = lx_scene_create_node(scene, b);
+
+    lx_mat4_t translation;
+    lx_mat4_translation(1.0f, 2.0f, 3.0f, &translation);
+    lx_scene_set_local_transform(scene, a, &translation);
+    lx_scene_set_local_transform(scene, c, &translation);
+
+    // Act
+    lx_scene_update_transforms(scene, NULL);
+
+    // Assert
+    LX_EQUALS(lx_scene_depth(scene, c), 3);
+    LX_TRUE(lx_near_equalf(lx_scene_world_transform(scene, b)->m42, 2.0f));
+    LX_TRUE(lx_near_equalf(lx_scene_world_transform(scene, c)->m41, 2.0f));
+    LX_TRUE(lx_near_equalf(lx_scene_world_transform(scene, c)->m43, 6.0f));
+
+    lx_scene_destroy(scene);
+}
+
+void update_transforms_only_recomputes_dirty_subtrees()
+{
+    // Arrange
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+    lx_scene_node_t a = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t a1 = lx_scene_create_node(scene, a);
+    lx_scene_node_t b = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t b1 = lx_scene_create_node(scene, b);
+    lx_scene_update_transforms(scene, NULL);
+
+    lx_mat4_t translation;
+    lx_mat4_translation(5.0f, 0.0f, 0.0f, &translation);
+    lx_scene_set_local_transform(scene, a, &translation);
+
+    // Overwrite a world transform the update must not touch
+    lx_mat4_t *b1_world = (lx_mat4_t *)lx_scene_world_transform(scene, b1);
+    b1_world->m41 = 42.0f;
+
+    // Act
+    lx_scene_update_transforms(scene, NULL);
+
+    // Assert
+    LX_TRUE(lx_near_equalf(lx_scene_world_transform(scene, a1)->m41, 5.0f));
+    LX_TRUE(lx_near_equalf(lx_scene_world_transform(scene, b1)->m41, 42.0f));
+
+    lx_scene_destroy(scene);
+}
+
+static void create_translated_nodes(lx_scene_t *scene, size_t count)
+{
+    lx_mat4_t translation;
+    lx_mat4_translation(1.0f, 0.0f, 0.0f, &translation);
+
+    // The first nodes hang off the root, every later node off the node created at half its index
+    for (size_t i = 0; i < count; ++i) {
+        lx_scene_node_t parent = i < 100 ? lx_scene_root_node() : (lx_scene_node_t)(i / 2 + 2);
+        lx_scene_node_t node = lx_scene_create_node(scene, parent);
+        lx_scene_set_local_transform(scene, node, &translation);
+    }
+}
+
+void parallel_transform_update_matches_serial_update()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+    lx_scene_t *serial_scene = lx_scene_create(allocator);
+    lx_scene_t *parallel_scene = lx_scene_create(allocator);
+    create_translated_nodes(serial_scene, 20000);
+    create_translated_nodes(parallel_scene, 20000);
+
+    // Act
+    lx_scene_update_transforms(serial_scene, NULL);
+    lx_scene_update_transforms(parallel_scene, task_factory);
+
+    // Assert
+    size_t num_different = 0;
+    for (lx_scene_node_t node = 1; node < lx_scene_size(serial_scene); ++node) {
+        const lx_mat4_t *world = lx_scene_world_transform(parallel_scene, node);
+        if (memcmp(lx_scene_world_transform(serial_scene, node), world, sizeof(lx_mat4_t)) || world->m41 != (float)lx_scene_depth(parallel_scene, node))
+            num_different++;
+    }
+
+    LX_EQUALS(num_different, 0);
+
+    lx_scene_destroy(serial_scene);
+    lx_scene_destroy(parallel_scene);
+}
+
+void create_node_appends_children_in_order()
+{
+    // Arrange
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+
+    // Act
+    for (size_t i = 0; i < 1000; ++i) {
+        lx_scene_create_node(scene, lx_scene_root_node());
+    }
+
+    // Assert
+    size_t num_out_of_order = 0;
+    lx_scene_node_t expected = 2;
+    for (lx_scene_node_t child = lx_scene_first_child(scene, lx_scene_root_node()); lx_is_some_scene_node(child); child = lx_scene_next_sibling(scene, child)) {
+        if (child != expected++)
+            num_out_of_order++;
+    }
+
+    LX_EQUALS(num_out_of_order, 0);
+    LX_EQUALS(expected, 1002);
+    LX_EQUALS(lx_scene_num_nodes(scene), 1000);
+
+    lx_scene_destroy(scene);
+}
+
+void destroy_node_frees_subtree_for_reuse()
+{
+    // Arrange
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+    lx_scene_node_t a = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t b = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t c = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t b1 = lx_scene_create_node(scene, b);
+    lx_scene_create_node(scene, b1);
+
+    // Act
+    lx_scene_destroy_node(scene, b);
+    lx_scene_node_t d = lx_scene_create_node(scene, c);
+
+    // Assert
+    LX_EQUALS(lx_scene_num_nodes(scene), 3);
+    LX_EQUALS(lx_scene_size(scene), 7);
+    LX_TRUE((!lx_scene_is_alive(scene, b)));
+    LX_TRUE((d == b || d == b1 || d == 6));
+    LX_EQUALS(lx_scene_next_sibling(scene, a), c);
+    LX_EQUALS(lx_scene_parent(scene, d), c);
+    LX_EQUALS(lx_scene_depth(scene, d), 2);
+
+    lx_scene_destroy(scene);
+}
+
+void create_node_in_full_scene_returns_nil()
+{
+    // Arrange
+    lx_initialize_log(lx_allocator_default(), LX_LOG_LEVEL_OFF);
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+    lx_scene_node_t last = lx_nil_scene_node();
+    while (lx_scene_size(scene) < LX_SCENE_MAX_NODES) {
+        last = lx_scene_create_node(scene, lx_scene_root_node());
+    }
+
+    // Act
+    lx_scene_node_t overflow = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_destroy_node(scene, last);
+    lx_scene_node_t reused = lx_scene_create_node(scene, lx_scene_root_node());
+
+    // Assert
+    LX_TRUE(lx_is_nil_scene_node(overflow));
+    LX_EQUALS(reused, last);
+    LX_EQUALS(lx_scene_size(scene), LX_SCENE_MAX_NODES);
+
+    lx_scene_destroy(scene);
+    lx_shutdown_log();
+}
+
+void set_parent_moves_subtree()
+{
+    // Arrange
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+    lx_scene_node_t a = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t a1 = lx_scene_create_node(scene, a);
+    lx_scene_node_t b = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t b1 = lx_scene_create_node(scene, b);
+    lx_scene_node_t b2 = lx_scene_create_node(scene, b1);
+
+    lx_mat4_t translation;
+    lx_mat4_translation(1.0f, 0.0f, 0.0f, &translation);
+    lx_scene_set_local_transform(scene, a1, &translation);
+    lx_scene_set_local_transform(scene, b1, &translation);
+    lx_scene_update_transforms(scene, NULL);
+
+    // Act
+    lx_scene_set_parent(scene, b1, a1);
+    lx_scene_update_transforms(scene, NULL);
+
+    // Assert
+    LX_EQUALS(lx_scene_first_child(scene, b), 0);
+    LX_EQUALS(lx_scene_first_child(scene, a1), b1);
+    LX_EQUALS(lx_scene_depth(scene, b1), 3);
+    LX_EQUALS(lx_scene_depth(scene, b2), 4);
+    LX_TRUE(lx_near_equalf(lx_scene_world_transform(scene, b2)->m41, 2.0f));
+
+    lx_scene_destroy(scene);
+}
+
+void compact_keeps_hierarchy_and_transforms()
+{
+    // Arrange
+    lx_scene_t *scene = lx_scene_create(lx_allocator_default());
+    lx_scene_node_t a = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t a1 = lx_scene_create_node(scene, a);
+    lx_scene_node_t b = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t c = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t c1 = lx_scene_create_node(scene, c);
+    lx_scene_node_t c2 = lx_scene_create_node(scene, c);
+
+    lx_mat4_t translation;
+    lx_mat4_translation(0.0f, 3.0f, 0.0f, &translation);
+    lx_scene_set_local_transform(scene, c2, &translation);
+    lx_scene_destroy_node(scene, b);
+    lx_scene_update_transforms(scene, NULL);
+
+    const size_t old_size = lx_scene_size(scene);
+    lx_scene_node_t node_map[8];
+
+    // Act
+    lx_scene_compact(scene, node_map);
+    lx_scene_update_transforms(scene, NULL);
+
+    // Assert
+    LX_EQUALS(old_size, 8);
+    LX_EQUALS(lx_scene_size(scene), 7);
+    LX_EQUALS(node_map[b], 0);
+
+    // Breadth first: a, c, a1, c1, c2
+    LX_EQUALS(node_map[a], 2);
+    LX_EQUALS(node_map[c], 3);
+    LX_EQUALS(node_map[a1], 4);
+    LX_EQUALS(node_map[c1], 5);
+    LX_EQUALS(node_map[c2], 6);
+    LX_EQUALS(lx_scene_first_child(scene, 3), 5);
+    LX_EQUALS(lx_scene_next_sibling(scene, 5), 6);
+    LX_EQUALS(lx_scene_parent(scene, 6), 3);
+    LX_EQUALS(lx_scene_depth(scene, 6), 2);
+    LX_TRUE(lx_near_equalf(lx_scene_world_transform(scene, 6)->m42, 3.0f));
+
+    lx_scene_set_local_transform(scene, 3, &translation);
+    lx_scene_update_transforms(scene, NULL);
+    LX_TRUE(lx_near_equalf(lx_scene_world_transform(scene, 6)->m42, 6.0f));
+
+    lx_scene_destroy(scene);
+}
+
+void update_transforms_moves_world_bounds_and_bvh()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_scene_t *scene = lx_scene_create(allocator);
+    lx_scene_node_t a = lx_scene_create_node(scene, lx_scene_root_node());
+    lx_scene_node_t b = lx_scene_create_node(scene, a);
+    lx_scene_node_t c = lx_scene_create_node(scene, lx_scene_root_node());
+
+    lx_aabb_t unit_box = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+    lx_scene_set_local_bounds(scene, b, &unit_box);
+    lx_scene_set_local_bounds(scene, c, &unit_box);
+
+    lx_mat4_t translation;
+    lx_mat4_translation(10.0f, 0.0f, 0.0f, &translation);
+    lx_scene_set_local_transform(scene, a, &translation);
+    lx_scene_update_transforms(scene, NULL);
+
+    // Act
+    lx_mat4_translation(0.0f, 20.0f, 0.0f, &translation);
+    lx_scene_set_local_transform(scene, a, &translation);
+    lx_scene_update_transforms(scene, NULL);
+
+    lx_array_t *nodes = lx_array_create(allocator, sizeof(lx_scene_node_t));
+    lx_aabb_t query = { { -2.0f, 18.0f, -2.0f }, { 2.0f, 22.0f, 2.0f } };
+    lx_scene_query_aabb(scene, &query, nodes);
+
+    lx_ray_t ray = { { 0.0f, -10.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+    lx_scene_node_t hit_node = 0;
+    float distance = 0.0f;
+    bool hit = lx_scene_raycast(scene, &ray, FLT_MAX, &hit_node, &distance);
+
+    // Assert
+    LX_TRUE(lx_aabb_is_empty(lx_scene_world_bounds(scene, a)));
+    LX_TRUE(lx_near_equalf(lx_scene_world_bounds(scene, b)->min.y, 19.0f));
+    LX_TRUE(lx_near_equalf(lx_scene_bounds(scene)->max.y, 21.0f));
+    LX_EQUALS(lx_array_size(nodes), 1);
+    LX_EQUALS(*(lx_scene_node_t *)lx_array_at(nodes, 0), b);
+    LX_TRUE(hit);
+    LX_EQUALS(hit_node, c);
+    LX_TRUE(lx_near_equalf(distance, 9.0f));
+
+    lx_scene_destroy_node(scene, c);
+    lx_scene_update_transforms(scene, NULL);
+    LX_TRUE((!lx_scene_raycast(scene, &ray, 15.0f, &hit_node, &distance)));
+
+    lx_array_destroy(nodes);
+    lx_scene_destroy(scene);
+}
+
 void setup_scene_test_fixture()
 {
     LX_TEST_FIXTURE_BEGIN("Scene")
         LX_ADD_TEST(create_scene_succeeds);
         LX_ADD_TEST(create_hierarchy_succeeds);
+        LX_ADD_TEST(grow_scene_keeps_hierarchy);
+        LX_ADD_TEST(destroyed_renderable_has_no_render_data);
+        LX_ADD_TEST(update_transforms_composes_parent_transforms);
+        LX_ADD_TEST(update_transforms_only_recomputes_dirty_subtrees);
+        LX_ADD_TEST(parallel_transform_update_matches_serial_update);
+        LX_ADD_TEST(create_node_appends_children_in_order);
+        LX_ADD_TEST(destroy_node_frees_subtree_for_reuse);
+        LX_ADD_TEST(create_node_in_full_scene_returns_nil);
+        LX_ADD_TEST(set_parent_moves_subtree);
+        LX_ADD_TEST(compact_keeps_hierarchy_and_transforms);
+        LX_ADD_TEST(update_transforms_moves_world_bounds_and_bvh);
     LX_TEST_FIXTURE_END()
 }
\ No newline at end of file
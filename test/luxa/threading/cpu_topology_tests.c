@@ -0,0 +1,52 @@
+#include <test/luxa/threading/cpu_topology_tests.h>
+#include <luxa/threading/cpu_topology.h>
+#include <luxa/test.h>
+
+void detect_cpu_topology_succeeds()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+
+    // Act
+    lx_cpu_topology_t *topology = lx_cpu_topology_create(allocator);
+
+    // Assert
+    LX_TRUE((topology->num_processors > 0));
+    LX_TRUE((topology->num_cores > 0 && topology->num_cores <= topology->num_processors));
+    LX_TRUE((topology->num_caches > 0 && topology->num_caches <= topology->num_cores));
+    LX_TRUE((topology->num_numa_nodes > 0));
+
+    for (size_t i = 0; i < topology->num_processors; ++i) {
+        const lx_logical_processor_t *processor = &topology->processors[i];
+        LX_TRUE((processor->core < topology->num_cores));
+        LX_TRUE((processor->cache < topology->num_caches));
+        LX_TRUE((processor->numa_node < topology->num_numa_nodes));
+        LX_TRUE((i == 0 || processor->core >= topology->processors[i - 1].core));
+    }
+
+    lx_cpu_topology_destroy(topology);
+}
+
+void processor_distance_orders_by_shared_resources()
+{
+    // Arrange
+    lx_logical_processor_t processor = { .group = 0, .number = 0, .core = 0, .cache = 0, .numa_node = 0 };
+    lx_logical_processor_t sibling = { .group = 0, .number = 1, .core = 0, .cache = 0, .numa_node = 0 };
+    lx_logical_processor_t same_cache = { .group = 0, .number = 2, .core = 1, .cache = 0, .numa_node = 0 };
+    lx_logical_processor_t same_node = { .group = 0, .number = 4, .core = 2, .cache = 1, .numa_node = 0 };
+    lx_logical_processor_t remote = { .group = 1, .number = 0, .core = 3, .cache = 2, .numa_node = 1 };
+
+    // Act & Assert
+    LX_EQUALS(lx_logical_processor_distance(&processor, &sibling), 0u);
+    LX_EQUALS(lx_logical_processor_distance(&processor, &same_cache), 1u);
+    LX_EQUALS(lx_logical_processor_distance(&processor, &same_node), 2u);
+    LX_EQUALS(lx_logical_processor_distance(&processor, &remote), 3u);
+}
+
+void setup_cpu_topology_test_fixture()
+{
+    LX_TEST_FIXTURE_BEGIN("CpuTopology")
+        LX_ADD_TEST(detect_cpu_topology_succeeds);
+        LX_ADD_TEST(processor_distance_orders_by_shared_resources);
+    LX_TEST_FIXTURE_END()
+}
@@ -0,0 +1,110 @@
+#include <test/luxa/threading/task/parallel_for_tests.h>
+#include <luxa/threading/task/parallel_for.h>
+#include <luxa/threading/threading.h>
+#include <luxa/test.h>
+
+#define NUM_VALUES 100000
+
+void square_values(size_t begin, size_t end, int64_t *values)
+{
+    for (size_t i = begin; i < end; ++i) {
+        values[i] = (int64_t)i * (int64_t)i;
+    }
+}
+
+void sum_range(lx_range_t range, volatile int64_t *sum)
+{
+    int64_t local_sum = 0;
+    for (int64_t *value = range.begin; value != range.end; ++value) {
+        local_sum += *value;
+    }
+
+    lx_atomic_add_64(sum, local_sum);
+}
+
+void parallel_for_visits_every_index_once()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+    int64_t *values = lx_alloc(allocator, NUM_VALUES * sizeof(int64_t));
+    memset(values, 0, NUM_VALUES * sizeof(int64_t));
+
+    // Act
+    lx_parallel_for(task_factory, 0, NUM_VALUES, 0, square_values, values);
+
+    // Assert
+    for (size_t i = 0; i < NUM_VALUES; ++i) {
+        LX_EQUALS(values[i], (int64_t)i * (int64_t)i);
+    }
+
+    lx_free(allocator, values);
+}
+
+void parallel_for_with_grain_size_succeeds()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+    int64_t values[100] = { 0 };
+
+    // Act
+    lx_parallel_for(task_factory, 10, 97, 7, square_values, values);
+
+    // Assert
+    for (size_t i = 0; i < 100; ++i) {
+        LX_EQUALS(values[i], (i >= 10 && i < 97 ? (int64_t)i * (int64_t)i : 0));
+    }
+}
+
+void parallel_range_visits_every_element()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+    int64_t *values = lx_alloc(allocator, NUM_VALUES * sizeof(int64_t));
+    for (size_t i = 0; i < NUM_VALUES; ++i) {
+        values[i] = 1;
+    }
+    volatile int64_t sum = 0;
+    lx_range_t range = { .begin = values, .end = values + NUM_VALUES, .step_size = sizeof(int64_t) };
+
+    // Act
+    lx_parallel_range(task_factory, range, 0, sum_range, (lx_any_t)&sum);
+
+    // Assert
+    LX_EQUALS(sum, NUM_VALUES);
+
+    lx_free(allocator, values);
+}
+
+void parallel_for_with_more_workers_than_stack_tasks_succeeds()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_options_t options = { .num_threads = 80 };
+    lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+    int64_t *values = lx_alloc(allocator, NUM_VALUES * sizeof(int64_t));
+    memset(values, 0, NUM_VALUES * sizeof(int64_t));
+
+    // Act
+    lx_parallel_for(task_factory, 0, NUM_VALUES, 1, square_values, values);
+
+    // Assert
+    for (size_t i = 0; i < NUM_VALUES; ++i) {
+        LX_EQUALS(values[i], (int64_t)i * (int64_t)i);
+    }
+
+    lx_free(allocator, values);
+    lx_task_factory_destroy(task_factory);
+}
+
+void setup_parallel_for_test_fixture()
+{
+    LX_TEST_FIXTURE_BEGIN("ParallelFor")
+        LX_ADD_TEST(parallel_for_visits_every_index_once);
+        LX_ADD_TEST(parallel_for_with_grain_size_succeeds);
+        LX_ADD_TEST(parallel_range_visits_every_element);
+        LX_ADD_TEST(parallel_for_with_more_workers_than_stack_tasks_succeeds);
+    LX_TEST_FIXTURE_END();
+}
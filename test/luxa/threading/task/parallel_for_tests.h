@@ -0,0 +1,11 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void setup_parallel_for_test_fixture();
+
+#ifdef __cplusplus
+}
+#endif
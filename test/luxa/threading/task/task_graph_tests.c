@@ -0,0 +1,115 @@
+#include <test/luxa/threading/task/task_graph_tests.h>
+#include <luxa/threading/task/task_graph.h>
+#include <luxa/threading/threading.h>
+#include <luxa/test.h>
+
+typedef struct stage_args {
+    volatile int32_t *sequence;
+    int32_t order;
+    int32_t runs;
+} stage_args_t;
+
+void record_stage(lx_task_factory_t *factory, lx_task_t *task, stage_args_t *args)
+{
+    args->order = lx_atomic_increment_32(args->sequence);
+    args->runs++;
+}
+
+void run_compiled_graph_respects_edges()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+    lx_task_graph_t *graph = lx_task_graph_create(allocator);
+    volatile int32_t sequence = 0;
+    stage_args_t input = { &sequence }, simulation = { &sequence }, transforms = { &sequence }, culling = { &sequence }, submit = { &sequence };
+
+    lx_task_graph_node_t input_node = lx_task_graph_add_node(graph, record_stage, &input);
+    lx_task_graph_node_t simulation_node = lx_task_graph_add_node(graph, record_stage, &simulation);
+    lx_task_graph_node_t transforms_node = lx_task_graph_add_node(graph, record_stage, &transforms);
+    lx_task_graph_node_t culling_node = lx_task_graph_add_node(graph, record_stage, &culling);
+    lx_task_graph_node_t submit_node = lx_task_graph_add_node(graph, record_stage, &submit);
+    lx_task_graph_add_edge(graph, input_node, simulation_node);
+    lx_task_graph_add_edge(graph, input_node, transforms_node);
+    lx_task_graph_add_edge(graph, simulation_node, culling_node);
+    lx_task_graph_add_edge(graph, transforms_node, culling_node);
+    lx_task_graph_add_edge(graph, culling_node, submit_node);
+
+    // Act
+    lx_result_t result = lx_task_graph_compile(graph);
+    for (int i = 0; i < 3; ++i) {
+        sequence = 0;
+        lx_task_graph_run(graph, task_factory);
+
+        // Assert
+        LX_EQUALS(input.order, 1);
+        LX_TRUE((simulation.order > input.order && transforms.order > input.order));
+        LX_TRUE((culling.order > simulation.order && culling.order > transforms.order));
+        LX_EQUALS(submit.order, 5);
+    }
+
+    LX_EQUALS(result, LX_SUCCESS);
+    LX_EQUALS(submit.runs, 3);
+
+    lx_task_graph_destroy(graph);
+}
+
+void compile_graph_with_cycle_fails()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_graph_t *graph = lx_task_graph_create(allocator);
+    volatile int32_t sequence = 0;
+    stage_args_t args = { &sequence };
+
+    lx_task_graph_node_t a = lx_task_graph_add_node(graph, record_stage, &args);
+    lx_task_graph_node_t b = lx_task_graph_add_node(graph, record_stage, &args);
+    lx_task_graph_node_t c = lx_task_graph_add_node(graph, record_stage, &args);
+    lx_task_graph_add_edge(graph, a, b);
+    lx_task_graph_add_edge(graph, b, c);
+    lx_task_graph_add_edge(graph, c, b);
+
+    // Act
+    lx_result_t result = lx_task_graph_compile(graph);
+
+    // Assert
+    LX_EQUALS(result, LX_ERROR);
+
+    lx_task_graph_destroy(graph);
+}
+
+void run_graph_back_to_back_reuses_finished_tasks()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+    lx_task_graph_t *graph = lx_task_graph_create(allocator);
+    volatile int32_t sequence = 0;
+    stage_args_t first = { &sequence }, second = { &sequence };
+
+    lx_task_graph_node_t first_node = lx_task_graph_add_node(graph, record_stage, &first);
+    lx_task_graph_node_t second_node = lx_task_graph_add_node(graph, record_stage, &second);
+    lx_task_graph_add_edge(graph, first_node, second_node);
+    lx_task_graph_compile(graph);
+
+    // Act, every run resets the tasks right after the previous run was waited for
+    for (int i = 0; i < 10000; ++i) {
+        lx_task_graph_run(graph, task_factory);
+    }
+
+    // Assert
+    LX_EQUALS(first.runs, 10000);
+    LX_EQUALS(second.runs, 10000);
+    LX_EQUALS(sequence, 20000);
+
+    lx_task_graph_destroy(graph);
+}
+
+void setup_task_graph_test_fixture()
+{
+    LX_TEST_FIXTURE_BEGIN("TaskGraph")
+        LX_ADD_TEST(run_compiled_graph_respects_edges);
+        LX_ADD_TEST(compile_graph_with_cycle_fails);
+        LX_ADD_TEST(run_graph_back_to_back_reuses_finished_tasks);
+    LX_TEST_FIXTURE_END();
+}
@@ -1,6 +1,8 @@
 #include <test/luxa/threading/task/task_tests.h>
 #include <luxa/threading/task/task.h>
+#include <luxa/threading/threading.h>
 #include <luxa/chrono.h>
+#include <luxa/fs.h>
 #include <luxa/test.h>
 
 typedef struct task_args {
@@ -29,20 +31,515 @@ void create_and_start_task_succeeds()
 	LX_EQUALS(args.result, 83);
 }
 
+void increment_counter(lx_task_factory_t *factory, lx_task_t *task, volatile int32_t *counter)
+{
+    lx_atomic_increment_32(counter);
+}
+
+void start_many_tasks_succeeds()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+	volatile int32_t counter = 0;
+	lx_task_t *tasks[4096];
+
+	// Act
+	for (size_t i = 0; i < 4096; ++i) {
+		tasks[i] = lx_task_run(task_factory, increment_counter, (lx_any_t)&counter);
+	}
+
+	for (size_t i = 0; i < 4096; ++i) {
+		lx_task_wait(task_factory, tasks[i]);
+	}
+
+	// Assert
+	LX_EQUALS(counter, 4096);
+}
+
+void start_task_wakes_sleeping_workers()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+	volatile int32_t counter = 0;
+	lx_task_t *tasks[64];
+
+	// Give idle workers time to go to sleep
+	lx_thread_sleep(20);
+
+	// Act
+	for (size_t i = 0; i < 64; ++i) {
+		tasks[i] = lx_task_run(task_factory, increment_counter, (lx_any_t)&counter);
+	}
+
+	for (size_t i = 0; i < 64; ++i) {
+		lx_task_wait(task_factory, tasks[i]);
+	}
+
+	// Assert
+	LX_EQUALS(counter, 64);
+}
+
+void sub_numbers(lx_task_factory_t *factory, lx_task_t *task, task_args_t *args)
+{
+    args->result = args->result - args->a - args->b;
+}
+
 void contiune_with_task_succeeds()
 {
-	//// Arrange
-	//lx_allocator_t *allocator = lx_allocator_default();
-	//lx_task_factory_t *task_factory = lx_task_factory_default(allocator);
-	//task_args_t args = { 2, 2, 0 };
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+	task_args_t args = { 2, 2, 0 };
+
+	// Act
+	lx_task_t *first_task = lx_task_run(task_factory, add_numbers, &args);
+	lx_task_t *second_task = lx_task_continue_with(task_factory, first_task, sub_numbers, &args);
+	lx_task_wait(task_factory, second_task);
+
+	// Assert
+	LX_EQUALS(args.result, 0);
+}
+
+typedef struct tree_args {
+    volatile int32_t num_children_finished;
+    int32_t num_children_finished_before_continuation;
+} tree_args_t;
+
+void finish_child(lx_task_factory_t *factory, lx_task_t *task, tree_args_t *args)
+{
+    lx_thread_sleep(1);
+    lx_atomic_increment_32(&args->num_children_finished);
+}
+
+void spawn_children(lx_task_factory_t *factory, lx_task_t *task, tree_args_t *args)
+{
+    for (size_t i = 0; i < 8; ++i) {
+        lx_task_start(factory, lx_task_create_child(factory, task, finish_child, args));
+    }
+}
+
+void record_finished_children(lx_task_factory_t *factory, lx_task_t *task, tree_args_t *args)
+{
+    args->num_children_finished_before_continuation = lx_atomic_exchange_32(&args->num_children_finished, 0, 0);
+}
+
+void wait_for_parent_waits_for_children()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+	tree_args_t args = { 0 };
+
+	// Act
+	lx_task_t *parent_task = lx_task_run(task_factory, spawn_children, &args);
+	lx_task_wait(task_factory, parent_task);
+
+	// Assert
+	LX_EQUALS(args.num_children_finished, 8);
+}
+
+void continuation_runs_after_children()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+	tree_args_t args = { 0 };
+
+	// Act
+	lx_task_t *parent_task = lx_task_create(task_factory, spawn_children, &args);
+	lx_task_t *continuation = lx_task_continue_with(task_factory, parent_task, record_finished_children, &args);
+	lx_task_start(task_factory, parent_task);
+	lx_task_wait(task_factory, continuation);
+
+	// Assert
+	LX_EQUALS(args.num_children_finished_before_continuation, 8);
+}
+
+typedef struct child_args {
+    lx_task_t *child;
+    task_args_t child_args;
+} child_args_t;
+
+void spawn_child(lx_task_factory_t *factory, lx_task_t *task, child_args_t *args)
+{
+    args->child = lx_task_create_child(factory, task, add_numbers, &args->child_args);
+    lx_task_start(factory, args->child);
+}
+
+void continue_finished_child_of_finished_parent_succeeds()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_t *task_factory = lx_task_factory_default(allocator, 2);
+	child_args_t parent_args = { NULL, { 1, 2, 0 } };
+	task_args_t args = { 2, 3, 0 };
+
+	lx_task_t *parent_task = lx_task_run(task_factory, spawn_child, &parent_args);
+	lx_task_wait(task_factory, parent_task);
+	lx_task_wait(task_factory, parent_args.child);
+
+	// Act
+	lx_task_t *continuation = lx_task_continue_with(task_factory, parent_args.child, add_numbers, &args);
+	lx_task_wait(task_factory, continuation);
+
+	// Assert
+	LX_EQUALS(parent_args.child_args.result, 3);
+	LX_EQUALS(args.result, 5);
+}
+
+typedef struct nested_args {
+    uint32_t depth;
+    volatile int32_t *num_finished;
+} nested_args_t;
+
+void run_nested_tasks(lx_task_factory_t *factory, lx_task_t *task, nested_args_t *args)
+{
+    if (args->depth > 0) {
+        nested_args_t child_args[4];
+        lx_task_t *children[4];
+
+        for (size_t i = 0; i < 4; ++i) {
+            child_args[i] = (nested_args_t) { args->depth - 1, args->num_finished };
+            children[i] = lx_task_run(factory, run_nested_tasks, &child_args[i]);
+        }
+
+        for (size_t i = 0; i < 4; ++i) {
+            lx_task_wait(factory, children[i]);
+        }
+    }
+
+    lx_atomic_increment_32(args->num_finished);
+}
+
+void nested_waits_on_fibers_succeeds()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = 2, .use_fibers = true, .num_fibers = 8, .fiber_stack_size = 64 * 1024 };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	volatile int32_t num_finished = 0;
+	nested_args_t args = { 4, &num_finished };
+
+	// Act
+	lx_task_t *task = lx_task_run(task_factory, run_nested_tasks, &args);
+	lx_task_wait(task_factory, task);
+
+	// Assert
+	LX_EQUALS(num_finished, 1 + 4 + 16 + 64 + 256);
+
+	lx_task_factory_destroy(task_factory);
+}
+
+typedef struct gate_args {
+    lx_task_t *gate;
+    volatile int32_t started;
+    volatile int32_t resumed;
+} gate_args_t;
+
+void open_gate(lx_task_factory_t *factory, lx_task_t *task, gate_args_t *args)
+{
+}
+
+void wait_for_gate(lx_task_factory_t *factory, lx_task_t *task, gate_args_t *args)
+{
+    lx_atomic_increment_32(&args->started);
+    lx_task_wait(factory, args->gate);
+    lx_atomic_increment_32(&args->resumed);
+}
+
+void waiting_fiber_does_not_block_worker()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = 1, .use_fibers = true };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	volatile int32_t counter = 0;
+	gate_args_t args = { 0 };
+	args.gate = lx_task_create(task_factory, open_gate, &args);
+
+	// Act
+	lx_task_t *waiting_task = lx_task_run(task_factory, wait_for_gate, &args);
+	while (!lx_atomic_exchange_32(&args.started, 0, 0)) {
+		lx_thread_yield();
+	}
+
+	// Only the worker thread runs tasks while the calling thread spins
+	lx_task_t *other_task = lx_task_run(task_factory, increment_counter, (lx_any_t)&counter);
+	while (!lx_atomic_exchange_32(&counter, 0, 0)) {
+		lx_thread_yield();
+	}
+
+	int32_t resumed_before_gate = args.resumed;
+	lx_task_start(task_factory, args.gate);
+	lx_task_wait(task_factory, waiting_task);
+	lx_task_wait(task_factory, other_task);
+
+	// Assert
+	LX_EQUALS(resumed_before_gate, 0);
+	LX_EQUALS(args.resumed, 1);
+
+	lx_task_factory_destroy(task_factory);
+}
+
+typedef struct priority_args {
+    volatile int32_t *num_finished;
+    lx_task_priority_t *order;
+    lx_task_priority_t priority;
+} priority_args_t;
+
+void record_priority(lx_task_factory_t *factory, lx_task_t *task, priority_args_t *args)
+{
+    int32_t i = lx_atomic_increment_32(args->num_finished) - 1;
+    args->order[i] = args->priority;
+}
+
+void high_priority_tasks_run_first()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = 0 };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	volatile int32_t num_finished = 0;
+	lx_task_priority_t order[12];
+	priority_args_t args[12];
+	lx_task_t *tasks[12];
+
+	// Act
+	for (size_t i = 0; i < 12; ++i) {
+		args[i] = (priority_args_t) { &num_finished, order, (lx_task_priority_t)(LX_TASK_NUM_PRIORITIES - 1 - i / 4) };
+		tasks[i] = lx_task_create(task_factory, record_priority, &args[i]);
+		lx_task_set_priority(task_factory, tasks[i], args[i].priority);
+		lx_task_start(task_factory, tasks[i]);
+	}
+
+	lx_task_wait(task_factory, tasks[0]);
+
+	// Assert
+	LX_EQUALS(num_finished, 12);
+	for (size_t i = 0; i < 12; ++i) {
+		LX_EQUALS(order[i], (lx_task_priority_t)(i / 4));
+	}
+
+	lx_task_factory_destroy(task_factory);
+}
+
+typedef struct pinned_args {
+    lx_thread_local_storage_t main_thread_marker;
+    volatile int32_t num_finished;
+    volatile int32_t num_finished_on_main_thread;
+} pinned_args_t;
+
+void record_main_thread(lx_task_factory_t *factory, lx_task_t *task, pinned_args_t *args)
+{
+    if (lx_thread_local_get_value(args->main_thread_marker))
+        lx_atomic_increment_32(&args->num_finished_on_main_thread);
+    lx_atomic_increment_32(&args->num_finished);
+}
+
+void start_pinned_task(lx_task_factory_t *factory, lx_task_t *task, pinned_args_t *args)
+{
+    lx_task_t *pinned_task = lx_task_create_child(factory, task, record_main_thread, args);
+    lx_task_pin_to_main_thread(factory, pinned_task);
+    lx_task_start(factory, pinned_task);
+}
+
+void pinned_tasks_run_on_main_thread()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = 2 };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	pinned_args_t args = { .main_thread_marker = lx_thread_local_create_storage() };
+	lx_thread_local_set_value(args.main_thread_marker, &args);
+
+	// Act
+	lx_task_t *pinned_tasks[4];
+	for (size_t i = 0; i < 4; ++i) {
+		pinned_tasks[i] = lx_task_create(task_factory, record_main_thread, &args);
+		lx_task_pin_to_main_thread(task_factory, pinned_tasks[i]);
+		lx_task_start(task_factory, pinned_tasks[i]);
+	}
+
+	// Give the workers a chance to pick up the pinned tasks
+	lx_thread_sleep(10);
+	int32_t num_finished_before_run = args.num_finished;
+	size_t num_run = lx_task_run_main_thread_tasks(task_factory);
+
+	// Pinned tasks started from a worker run while the main thread waits
+	lx_task_t *parent_task = lx_task_run(task_factory, start_pinned_task, &args);
+	lx_task_wait(task_factory, parent_task);
+
+	// Assert
+	LX_EQUALS(num_finished_before_run, 0);
+	LX_EQUALS(num_run, 4);
+	LX_EQUALS(args.num_finished, 5);
+	LX_EQUALS(args.num_finished_on_main_thread, 5);
+
+	lx_thread_local_destroy_storage(args.main_thread_marker);
+	lx_task_factory_destroy(task_factory);
+}
+
+void stats_count_stolen_tasks()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = 2 };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	volatile int32_t counter = 0;
+	lx_task_factory_stats_t stats;
+
+	// Act, the calling thread never runs the tasks so every task is stolen at least once
+	for (size_t i = 0; i < 64; ++i) {
+		lx_task_run(task_factory, increment_counter, (lx_any_t)&counter);
+	}
+
+	while (lx_atomic_exchange_32(&counter, 0, 0) != 64) {
+		lx_thread_yield();
+	}
+
+	lx_task_factory_get_stats(task_factory, &stats);
 
-	//// Act
-	//lx_task_t first_task = lx_task_run(task_factory, add_numbers, &args);
-	//lx_task_t second_task = lx_task_continue_with(task_factory, first_task, sub_numbers, &args);
-	//lx_task_wait(task_factory, second_task);
+	// Assert
+	LX_EQUALS(stats.num_tasks_executed, 64u);
+	LX_TRUE((stats.num_tasks_stolen >= 64));
+	LX_TRUE((stats.num_successful_steals <= stats.num_tasks_stolen));
+	LX_TRUE((stats.num_successful_steals <= stats.num_steal_attempts));
+
+	lx_task_factory_destroy(task_factory);
+}
+
+void pinned_worker_threads_run_tasks()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = LX_TASK_NUM_THREADS_AUTO, .thread_affinity = LX_TASK_THREAD_AFFINITY_CORE };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	volatile int32_t counter = 0;
+	lx_task_t *tasks[256];
+
+	// Act
+	for (size_t i = 0; i < 256; ++i) {
+		tasks[i] = lx_task_run(task_factory, increment_counter, (lx_any_t)&counter);
+	}
+
+	for (size_t i = 0; i < 256; ++i) {
+		lx_task_wait(task_factory, tasks[i]);
+	}
+
+	// Assert
+	LX_TRUE((lx_task_num_workers(task_factory) >= 1));
+	LX_EQUALS(counter, 256);
+
+	lx_task_factory_destroy(task_factory);
+}
+
+void trace_records_named_tasks()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = 1, .trace_capacity = 64 };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	volatile int32_t counter = 0;
+	lx_task_t *tasks[32];
+	lx_buffer_t *trace = lx_buffer_create_empty(allocator);
+
+	// Act
+	for (size_t i = 0; i < 32; ++i) {
+		tasks[i] = lx_task_create(task_factory, increment_counter, (lx_any_t)&counter);
+		lx_task_set_name(task_factory, tasks[i], "increment_counter");
+		lx_task_start(task_factory, tasks[i]);
+	}
+
+	for (size_t i = 0; i < 32; ++i) {
+		lx_task_wait(task_factory, tasks[i]);
+	}
+
+	lx_result_t result = lx_task_factory_write_trace(task_factory, "task_trace.json");
+	lx_fs_read_file(trace, "task_trace.json");
+	lx_buffer_resize(trace, lx_buffer_size(trace) + 1);
+	lx_buffer_data(trace)[lx_buffer_size(trace) - 1] = '\0';
+
+	size_t num_events = 0;
+	for (const char *event = lx_buffer_data(trace); (event = strstr(event, "\"name\":\"increment_counter\"")) != NULL; ++event) {
+		++num_events;
+	}
+
+	// Assert
+	LX_EQUALS(result, LX_SUCCESS);
+	LX_TRUE((strstr(lx_buffer_data(trace), "\"traceEvents\"") != NULL));
+	LX_EQUALS(num_events, 32u);
+
+	remove("task_trace.json");
+	lx_buffer_destroy(trace);
+	lx_task_factory_destroy(task_factory);
+}
+
+void trace_escapes_task_names()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = 1, .trace_capacity = 64 };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	volatile int32_t counter = 0;
+	lx_buffer_t *trace = lx_buffer_create_empty(allocator);
+
+	lx_task_t *task = lx_task_create(task_factory, increment_counter, (lx_any_t)&counter);
+	lx_task_set_name(task_factory, task, "load \"C:\\assets\"");
+	lx_task_start(task_factory, task);
+	lx_task_wait(task_factory, task);
+
+	// Act
+	lx_result_t result = lx_task_factory_write_trace(task_factory, "task_trace.json");
+	lx_fs_read_file(trace, "task_trace.json");
+	lx_buffer_resize(trace, lx_buffer_size(trace) + 1);
+	lx_buffer_data(trace)[lx_buffer_size(trace) - 1] = '\0';
+
+	// Assert
+	LX_EQUALS(result, LX_SUCCESS);
+	LX_TRUE((strstr(lx_buffer_data(trace), "\"name\":\"load \\\"C:\\\\assets\\\"\"") != NULL));
+
+	remove("task_trace.json");
+	lx_buffer_destroy(trace);
+	lx_task_factory_destroy(task_factory);
+}
+
+void worker_stats_add_up_to_factory_stats()
+{
+	// Arrange
+	lx_allocator_t *allocator = lx_allocator_default();
+	lx_task_factory_options_t options = { .num_threads = 2 };
+	lx_task_factory_t *task_factory = lx_task_factory_create(allocator, &options);
+	volatile int32_t counter = 0;
+	lx_task_t *tasks[256];
+	lx_task_factory_stats_t stats;
+	uint64_t num_tasks_executed = 0;
+
+	// Act
+	lx_thread_sleep(10);
+	for (size_t i = 0; i < 256; ++i) {
+		tasks[i] = lx_task_run(task_factory, increment_counter, (lx_any_t)&counter);
+	}
+
+	for (size_t i = 0; i < 256; ++i) {
+		lx_task_wait(task_factory, tasks[i]);
+	}
+
+	for (size_t i = 0; i < lx_task_num_workers(task_factory); ++i) {
+		lx_task_factory_get_worker_stats(task_factory, i, &stats);
+		num_tasks_executed += stats.num_tasks_executed;
+	}
+
+	lx_task_factory_get_stats(task_factory, &stats);
+
+	// Assert
+	LX_EQUALS(stats.num_tasks_executed, 256u);
+	LX_EQUALS(num_tasks_executed, 256u);
+	LX_TRUE((stats.idle_milliseconds > 0.0));
+	LX_EQUALS(stats.num_queued_tasks[LX_TASK_PRIORITY_NORMAL], 0u);
 
-	//// Assert
-	//LX_EQUALS(args.result, 0);
+	lx_task_factory_destroy(task_factory);
 }
 
 void performance_test()
@@ -70,7 +567,21 @@ void setup_task_test_fixture()
 {
 	LX_TEST_FIXTURE_BEGIN("Task")
 		LX_ADD_TEST(create_and_start_task_succeeds);
+		LX_ADD_TEST(start_many_tasks_succeeds);
+		LX_ADD_TEST(start_task_wakes_sleeping_workers);
 		LX_ADD_TEST(contiune_with_task_succeeds);
+		LX_ADD_TEST(wait_for_parent_waits_for_children);
+		LX_ADD_TEST(continuation_runs_after_children);
+		LX_ADD_TEST(continue_finished_child_of_finished_parent_succeeds);
+		LX_ADD_TEST(nested_waits_on_fibers_succeeds);
+		LX_ADD_TEST(waiting_fiber_does_not_block_worker);
+		LX_ADD_TEST(high_priority_tasks_run_first);
+		LX_ADD_TEST(pinned_tasks_run_on_main_thread);
+		LX_ADD_TEST(stats_count_stolen_tasks);
+		LX_ADD_TEST(pinned_worker_threads_run_tasks);
+		LX_ADD_TEST(trace_records_named_tasks);
+		LX_ADD_TEST(trace_escapes_task_names);
+		LX_ADD_TEST(worker_stats_add_up_to_factory_stats);
 		LX_ADD_TEST(performance_test);
 	LX_TEST_FIXTURE_END();
 }
\ No newline at end of file
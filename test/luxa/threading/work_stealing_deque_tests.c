@@ -0,0 +1,143 @@
+#include <test/luxa/threading/work_stealing_deque_tests.h>
+#include <luxa/threading/work_stealing_deque.h>
+#include <luxa/threading/threading.h>
+#include <luxa/test.h>
+
+#define NUM_THIEVES 3
+#define NUM_ITEMS 100000
+
+typedef struct steal_args {
+    lx_work_stealing_deque_t *deque;
+    volatile int32_t *taken;
+    volatile int32_t *num_taken;
+} steal_args_t;
+
+unsigned long steal_items(steal_args_t *args)
+{
+    while (lx_atomic_exchange_32(args->num_taken, 0, 0) < NUM_ITEMS) {
+        intptr_t item = (intptr_t)lx_work_stealing_deque_steal(args->deque);
+        if (item) {
+            lx_atomic_increment_32(&args->taken[item - 1]);
+            lx_atomic_increment_32(args->num_taken);
+        }
+    }
+
+    return 0;
+}
+
+void pop_returns_items_in_lifo_order()
+{
+    // Arrange
+    lx_work_stealing_deque_t *deque = lx_work_stealing_deque_create(lx_allocator_default(), 4);
+
+    // Act
+    for (intptr_t i = 1; i <= 16; ++i) {
+        lx_work_stealing_deque_push(deque, (lx_any_t)i);
+    }
+
+    // Assert
+    LX_EQUALS(lx_work_stealing_deque_size(deque), 16u);
+    for (intptr_t i = 16; i >= 1; --i) {
+        LX_EQUALS((intptr_t)lx_work_stealing_deque_pop(deque), i);
+    }
+    LX_TRUE((lx_work_stealing_deque_pop(deque) == NULL));
+
+    lx_work_stealing_deque_destroy(deque);
+}
+
+void steal_returns_items_in_fifo_order()
+{
+    // Arrange
+    lx_work_stealing_deque_t *deque = lx_work_stealing_deque_create(lx_allocator_default(), 4);
+
+    // Act
+    for (intptr_t i = 1; i <= 16; ++i) {
+        lx_work_stealing_deque_push(deque, (lx_any_t)i);
+    }
+
+    // Assert
+    for (intptr_t i = 1; i <= 16; ++i) {
+        LX_EQUALS((intptr_t)lx_work_stealing_deque_steal(deque), i);
+    }
+    LX_TRUE((lx_work_stealing_deque_steal(deque) == NULL));
+
+    lx_work_stealing_deque_destroy(deque);
+}
+
+void steal_half_takes_oldest_half()
+{
+    // Arrange
+    lx_work_stealing_deque_t *deque = lx_work_stealing_deque_create(lx_allocator_default(), 16);
+    lx_any_t items[16];
+
+    for (intptr_t i = 1; i <= 7; ++i) {
+        lx_work_stealing_deque_push(deque, (lx_any_t)i);
+    }
+
+    // Act
+    size_t num_stolen = lx_work_stealing_deque_steal_half(deque, items, 16);
+    size_t num_stolen_limited = lx_work_stealing_deque_steal_half(deque, items + num_stolen, 1);
+
+    // Assert
+    LX_EQUALS(num_stolen, 4u);
+    LX_EQUALS(num_stolen_limited, 1u);
+    for (intptr_t i = 0; i < 5; ++i) {
+        LX_EQUALS((intptr_t)items[i], i + 1);
+    }
+    LX_EQUALS(lx_work_stealing_deque_size(deque), 2u);
+
+    lx_work_stealing_deque_destroy(deque);
+}
+
+void concurrent_steal_takes_each_item_once()
+{
+    // Arrange
+    lx_allocator_t *allocator = lx_allocator_default();
+    lx_work_stealing_deque_t *deque = lx_work_stealing_deque_create(allocator, 64);
+    volatile int32_t *taken = lx_alloc(allocator, NUM_ITEMS * sizeof(int32_t));
+    memset((void *)taken, 0, NUM_ITEMS * sizeof(int32_t));
+    volatile int32_t num_taken = 0;
+
+    steal_args_t args = { .deque = deque, .taken = taken, .num_taken = &num_taken };
+    lx_thread_t thieves[NUM_THIEVES];
+    for (size_t i = 0; i < NUM_THIEVES; ++i) {
+        lx_thread_create(&thieves[i], steal_items, &args);
+    }
+
+    // Act
+    for (intptr_t i = 1; i <= NUM_ITEMS; ++i) {
+        lx_work_stealing_deque_push(deque, (lx_any_t)i);
+
+        if (i % 3 == 0) {
+            intptr_t item = (intptr_t)lx_work_stealing_deque_pop(deque);
+            if (item) {
+                lx_atomic_increment_32(&taken[item - 1]);
+                lx_atomic_increment_32(&num_taken);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < NUM_THIEVES; ++i) {
+        lx_thread_join(&thieves[i]);
+        lx_thread_destroy(&thieves[i]);
+    }
+
+    // Assert
+    LX_EQUALS(num_taken, NUM_ITEMS);
+    for (size_t i = 0; i < NUM_ITEMS; ++i) {
+        LX_EQUALS(taken[i], 1);
+    }
+
+    lx_free(allocator, (void *)taken);
+    lx_work_stealing_deque_destroy(deque);
+}
+
+void setup_work_stealing_deque_test_fixture()
+{
+    LX_TEST_FIXTURE_BEGIN("WorkStealingDeque")
+        LX_ADD_TEST(pop_returns_items_in_lifo_order);
+        LX_ADD_TEST(steal_returns_items_in_fifo_order);
+        LX_ADD_TEST(steal_half_takes_oldest_half);
+        LX_ADD_TEST(concurrent_steal_takes_each_item_once);
+    LX_TEST_FIXTURE_END();
+}
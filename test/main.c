@@ -1,29 +1,57 @@
 #include <stdio.h>
 #include <luxa/test.h>
 #include <test/luxa/memory/block_allocator_tests.h>
+#include <test/luxa/memory/arena_allocator_tests.h>
+#include <test/luxa/memory/pool_allocator_tests.h>
+#include <test/luxa/memory/tracking_allocator_tests.h>
 #include <test/luxa/collections/array_tests.h>
 #include <test/luxa/collections/string_tests.h>
 #include <test/luxa/collections/buffer_tests.h>
 #include <test/luxa/collections/map_tests.h>
+#include <test/luxa/collections/concurrent_map_tests.h>
+#include <test/luxa/collections/slot_map_tests.h>
 #include <test/luxa/collections/queue_tests.h>
+#include <test/luxa/collections/spsc_queue_tests.h>
+#include <test/luxa/collections/mpmc_queue_tests.h>
+#include <test/luxa/collections/virtual_array_tests.h>
 #include <test/luxa/hash_tests.h>
 #include <test/luxa/renderer/scene_tests.h>
+#include <test/luxa/renderer/bvh_tests.h>
+#include <test/luxa/renderer/culling_tests.h>
 #include <test/luxa/math/math_tests.h>
 #include <test/luxa/threading/task/task_tests.h>
+#include <test/luxa/threading/task/parallel_for_tests.h>
+#include <test/luxa/threading/task/task_graph_tests.h>
 #include <test/luxa/threading/threading_tests.h>
+#include <test/luxa/threading/work_stealing_deque_tests.h>
+#include <test/luxa/threading/cpu_topology_tests.h>
 
 int main(int argc, char **argv)
 {
 	setup_block_allocator_test_fixture();
+	setup_arena_allocator_test_fixture();
+	setup_pool_allocator_test_fixture();
+	setup_tracking_allocator_test_fixture();
 	setup_array_test_fixture();
 	setup_hash_test_fixture();
 	setup_string_test_fixture();
 	setup_buffer_tests();
 	setup_map_test_fixture();
+	setup_concurrent_map_test_fixture();
+	setup_slot_map_test_fixture();
     setup_queue_test_fixture();
+    setup_spsc_queue_test_fixture();
+    setup_mpmc_queue_test_fixture();
+    setup_virtual_array_test_fixture();
     setup_scene_test_fixture();
+    setup_bvh_test_fixture();
+    setup_culling_test_fixture();
 	setup_math_test_fixture();
 	setup_task_test_fixture();
+	setup_parallel_for_test_fixture();
+	setup_task_graph_test_fixture();
     setup_threading_test_fixture();
+    setup_work_stealing_deque_test_fixture();
+    setup_cpu_topology_test_fixture();
     return 0;
 }
\ No newline at end of file